@@ -0,0 +1,205 @@
+#include "AllocationLibrary.h"
+#include "ServerAllocationProblem.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <set>
+
+namespace AllocationLibrary
+{
+	const char *GetErrorMessage(ErrorCode errorCode)
+	{
+		switch (errorCode)
+		{
+		case OK:
+			return "OK";
+		case ERROR_CANNOT_OPEN_FILE:
+			return "cannot open an input file";
+		case ERROR_INVALID_FILE:
+			return "invalid input file";
+		case ERROR_INVALID_ARGUMENT:
+			return "invalid argument";
+		case ERROR_UNKNOWN_CLIENT:
+			return "unknown client id";
+		case ERROR_UNSUPPORTED_STRATEGY:
+			return "unsupported strategy";
+		case ERROR_NO_ELIGIBLE_G_DATACENTER:
+			return "no eligible G datacenter";
+		default:
+			return "unknown error";
+		}
+	}
+
+	// the numbers of each row of a comma-separated file (the first row and the first column are labels)
+	ErrorCode ReadNumericRows(const string &fileName, vector<vector<double>> &rows)
+	{
+		std::ifstream file(fileName);
+		if (!file.is_open()) return ERROR_CANNOT_OPEN_FILE;
+
+		rows.clear();
+		string line;
+		bool isFirstRow = true;
+		while (std::getline(file, line))
+		{
+			if (isFirstRow)
+			{
+				isFirstRow = false;
+				continue;
+			}
+			if (line.empty() || "\r" == line) continue;
+
+			std::stringstream lineStream(line);
+			string cell;
+			std::getline(lineStream, cell, ','); // label
+			vector<double> row;
+			while (std::getline(lineStream, cell, ','))
+			{
+				char *end = nullptr;
+				double value = std::strtod(cell.c_str(), &end);
+				if (end == cell.c_str()) return ERROR_INVALID_FILE;
+				row.push_back(value);
+			}
+			rows.push_back(row);
+		}
+
+		return rows.empty() ? ERROR_INVALID_FILE : OK;
+	}
+
+	ErrorCode LoadTopology(const string &dataDirectory, TopologyType &topology)
+	{
+		vector<vector<double>> clientToDatacenterRTT, datacenterToDatacenterRTT, pricing;
+		ErrorCode errorCode = ReadNumericRows(dataDirectory + "dc_to_pl_rtt.csv", clientToDatacenterRTT);
+		if (OK != errorCode) return errorCode;
+		errorCode = ReadNumericRows(dataDirectory + "dc_to_dc_rtt.csv", datacenterToDatacenterRTT);
+		if (OK != errorCode) return errorCode;
+		errorCode = ReadNumericRows(dataDirectory + "dc_pricing_bandwidth_server.csv", pricing);
+		if (OK != errorCode) return errorCode;
+
+		const int clientCount = int(clientToDatacenterRTT.size());
+		const int datacenterCount = int(clientToDatacenterRTT.front().size());
+		if (datacenterCount < 1 || int(datacenterToDatacenterRTT.size()) < datacenterCount || int(pricing.size()) < datacenterCount) return ERROR_INVALID_FILE;
+		for (auto &row : clientToDatacenterRTT)
+		{
+			if (int(row.size()) != datacenterCount) return ERROR_INVALID_FILE;
+		}
+		for (int i = 0; i < datacenterCount; i++)
+		{
+			if (int(datacenterToDatacenterRTT.at(i).size()) < datacenterCount || pricing.at(i).size() < 2) return ERROR_INVALID_FILE;
+		}
+
+		TopologyType loaded;
+		loaded.clientCount = clientCount;
+		loaded.datacenterCount = datacenterCount;
+		for (auto &row : clientToDatacenterRTT)
+		{
+			for (auto rtt : row)
+			{
+				loaded.clientToDatacenterDelay.push_back(rtt / 2);
+			}
+		}
+		for (int i = 0; i < datacenterCount; i++)
+		{
+			for (int j = 0; j < datacenterCount; j++)
+			{
+				loaded.datacenterToDatacenterDelay.push_back(datacenterToDatacenterRTT.at(i).at(j) / 2);
+			}
+			loaded.priceBandwidth.push_back(pricing.at(i).at(0));
+			loaded.priceServer.push_back(pricing.at(i).at(1)); // g2.8xlarge
+		}
+		loaded.chargedTrafficVolume.assign(clientCount, 2);
+
+		topology = std::move(loaded);
+		return OK;
+	}
+
+	AllocationType::AllocationType(const TopologyType &topology, int maxClientCount)
+	{
+		this->GDatacenterID = -1;
+		this->assignedDatacenterIDs.reserve(maxClientCount);
+		this->serverCountPerDC.reserve(topology.datacenterCount);
+	}
+
+	// the topology's clients and datacenters as ServerAllocationProblem objects (with the same fields as ServerAllocationProblem::Initialize sets)
+	void BuildWorkspace(const TopologyType &topology, AllocationWorkspaceType &workspace)
+	{
+		for (auto client : workspace.clients) delete client;
+		for (auto dc : workspace.datacenters) delete dc;
+		workspace.clients.clear();
+		workspace.datacenters.clear();
+
+		for (int j = 0; j < topology.datacenterCount; j++)
+		{
+			auto dc = new ServerAllocationProblem::DatacenterType(j);
+			dc->priceServer = topology.priceServer[j];
+			dc->priceBandwidth = topology.priceBandwidth[j];
+			for (int k = 0; k < topology.datacenterCount; k++)
+			{
+				dc->delayToDatacenter[k] = topology.datacenterToDatacenterDelay[j * topology.datacenterCount + k];
+			}
+			workspace.datacenters.push_back(dc);
+		}
+		for (int i = 0; i < topology.clientCount; i++)
+		{
+			auto client = new ServerAllocationProblem::ClientType(i);
+			client->chargedTrafficVolume = topology.chargedTrafficVolume[i];
+			for (int j = 0; j < topology.datacenterCount; j++)
+			{
+				client->delayToDatacenter[j] = topology.clientToDatacenterDelay[i * topology.datacenterCount + j];
+			}
+			workspace.clients.push_back(client);
+		}
+	}
+
+	AllocationWorkspaceType::AllocationWorkspaceType(const TopologyType &topology, int maxClientCount)
+	{
+		BuildWorkspace(topology, *this);
+		this->sessionClients.reserve(maxClientCount);
+		this->eligibleGDatacenters.reserve(topology.datacenterCount);
+	}
+
+	AllocationWorkspaceType::~AllocationWorkspaceType()
+	{
+		for (auto client : clients) delete client;
+		for (auto dc : datacenters) delete dc;
+	}
+
+	ErrorCode Allocate(const TopologyType &topology, const RequestType &request, AllocationWorkspaceType &workspace, AllocationType &allocation)
+	{
+		if (request.clientCount < 1 || nullptr == request.clientIDs || !(request.DELAY_BOUND_TO_G > 0) || !(request.DELAY_BOUND_TO_R > 0) || !(request.serverCapacity > 0)) return ERROR_INVALID_ARGUMENT;
+		if (request.strategyID < STRATEGY_NEAREST || request.strategyID > STRATEGY_LAC) return ERROR_UNSUPPORTED_STRATEGY;
+		for (int i = 0; i < request.clientCount; i++)
+		{
+			if (request.clientIDs[i] < 0 || request.clientIDs[i] >= topology.clientCount) return ERROR_UNKNOWN_CLIENT;
+		}
+
+		if (int(workspace.clients.size()) != topology.clientCount || int(workspace.datacenters.size()) != topology.datacenterCount) BuildWorkspace(topology, workspace);
+
+		workspace.sessionClients.clear();
+		for (int i = 0; i < request.clientCount; i++)
+		{
+			workspace.sessionClients.push_back(workspace.clients[request.clientIDs[i]]);
+		}
+		if (std::set<ServerAllocationProblem::ClientType*>(workspace.sessionClients.begin(), workspace.sessionClients.end()).size() < workspace.sessionClients.size()) return ERROR_INVALID_ARGUMENT; // each client object can be in the session only once
+
+		ServerAllocationProblem::SearchEligibleGDatacenter(workspace.datacenters, workspace.sessionClients, workspace.eligibleGDatacenters, request.DELAY_BOUND_TO_G, request.DELAY_BOUND_TO_R);
+		if (workspace.eligibleGDatacenters.empty()) return ERROR_NO_ELIGIBLE_G_DATACENTER;
+
+		int finalGDatacenter;
+		auto outcome = ServerAllocationProblem::RunStrategy4GeneralProblem(request.strategyID, workspace.eligibleGDatacenters, finalGDatacenter, workspace.sessionClients, workspace.datacenters, request.DELAY_BOUND_TO_G, request.DELAY_BOUND_TO_R, request.serverCapacity);
+
+		allocation.GDatacenterID = finalGDatacenter;
+		allocation.assignedDatacenterIDs.resize(request.clientCount);
+		for (int i = 0; i < request.clientCount; i++)
+		{
+			allocation.assignedDatacenterIDs[i] = workspace.sessionClients[i]->assignedDatacenterID;
+		}
+		allocation.serverCountPerDC.resize(topology.datacenterCount);
+		for (int dc = 0; dc < topology.datacenterCount; dc++)
+		{
+			allocation.serverCountPerDC[dc] = (int)workspace.datacenters[dc]->openServerCount;
+		}
+		allocation.outcome = outcome;
+		return OK;
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+// headless allocation API for embedding in a game's matchmaking service (built as the MultiplayerCloudGamingLibrary static library)
+// this header depends only on the standard library, and the library runs the simulation's own strategies (ServerAllocationProblem), on paths that print nothing, never wait for input and write no file
+// errors are reported through the returned ErrorCode
+// many threads may call Allocate at once against one shared TopologyType, each with its own AllocationWorkspaceType and AllocationType
+
+#include <vector>
+#include <tuple>
+#include <string>
+
+namespace ServerAllocationProblem
+{
+	struct ClientType;
+	struct DatacenterType;
+}
+
+namespace AllocationLibrary
+{
+	using std::vector;
+	using std::tuple;
+	using std::string;
+
+	enum ErrorCode
+	{
+		OK = 0,
+		ERROR_CANNOT_OPEN_FILE,
+		ERROR_INVALID_FILE, // empty, not numeric, or inconsistent with the other files
+		ERROR_INVALID_ARGUMENT, // non-positive delay bound or server capacity, no clients, or a client listed twice
+		ERROR_UNKNOWN_CLIENT, // client id out of the topology's range
+		ERROR_UNSUPPORTED_STRATEGY,
+		ERROR_NO_ELIGIBLE_G_DATACENTER // no G datacenter lets every client reach an R datacenter within the delay bounds
+	};
+
+	// short description of the error (a string literal, no allocation)
+	const char *GetErrorMessage(ErrorCode);
+
+	// clients and datacenters with their delays and prices in flat arrays, read-only once loaded (so it can be shared by any number of threads)
+	// ids are indices: clients are the rows of dc_to_pl_rtt.csv, datacenters its columns
+	struct TopologyType
+	{
+		int clientCount;
+		int datacenterCount;
+		vector<double> clientToDatacenterDelay; // one-way, indexed by [client's id * datacenterCount + dc's id]
+		vector<double> datacenterToDatacenterDelay; // one-way, indexed by [dc's id * datacenterCount + dc's id]
+		vector<double> priceServer; // per server per session, indexed by dc's id
+		vector<double> priceBandwidth; // per GB, indexed by dc's id
+		vector<double> chargedTrafficVolume; // per session, indexed by client's id
+
+		TopologyType()
+		{
+			this->clientCount = 0;
+			this->datacenterCount = 0;
+		}
+	};
+
+	// read dc_to_pl_rtt.csv, dc_to_dc_rtt.csv and dc_pricing_bandwidth_server.csv of the given directory (with the same conventions as ServerAllocationProblem::Initialize)
+	// the topology is left unchanged on error
+	ErrorCode LoadTopology(const string &, TopologyType &);
+
+	// strategies that can be used (same ids as ServerAllocationProblem's strategies): the heuristics, which produce a deployable assignment in well under a millisecond
+	// LB (fractional servers), RANDOM and OPT (exponential time) are not offered
+	enum StrategyID { STRATEGY_NEAREST = 3, STRATEGY_LSP = 4, STRATEGY_LBP = 5, STRATEGY_LCP = 6, STRATEGY_LCW = 7, STRATEGY_LAC = 8 };
+
+	// one session to allocate: the clients (by id), the delay bounds and the server capacity
+	struct RequestType
+	{
+		const int *clientIDs;
+		int clientCount;
+		double DELAY_BOUND_TO_G;
+		double DELAY_BOUND_TO_R;
+		double serverCapacity;
+		StrategyID strategyID;
+
+		RequestType()
+		{
+			this->clientIDs = nullptr;
+			this->clientCount = 0;
+			this->DELAY_BOUND_TO_G = 75;
+			this->DELAY_BOUND_TO_R = 50;
+			this->serverCapacity = 8;
+			this->strategyID = STRATEGY_LAC;
+		}
+	};
+
+	// result of one allocation
+	struct AllocationType
+	{
+		int GDatacenterID;
+		vector<int> assignedDatacenterIDs; // R datacenter of each client, in the order of the request's clients
+		vector<int> serverCountPerDC; // indexed by dc's id
+		tuple<double, double, double, double, double> outcome; // <cost_total, cost_server, cost_bandwidth, capacity_wastage, average_delay> (see ServerAllocationProblem::GetSolutionOutput)
+
+		AllocationType(const TopologyType &, int maxClientCount = 0);
+		AllocationType() : GDatacenterID(-1) {}
+	};
+
+	// scratch state of the calls of one thread, reused from call to call
+	// private copies of the topology's clients and datacenters, on which the strategies run (built once, when created or by the first call if default-constructed)
+	struct AllocationWorkspaceType
+	{
+		vector<ServerAllocationProblem::ClientType*> clients; // indexed by client's id
+		vector<ServerAllocationProblem::DatacenterType*> datacenters; // indexed by dc's id
+		vector<ServerAllocationProblem::ClientType*> sessionClients; // the request's clients, in its order
+		vector<ServerAllocationProblem::DatacenterType*> eligibleGDatacenters;
+
+		AllocationWorkspaceType(const TopologyType &, int maxClientCount = 0);
+		AllocationWorkspaceType() {}
+		~AllocationWorkspaceType();
+		AllocationWorkspaceType(const AllocationWorkspaceType &) = delete;
+		AllocationWorkspaceType &operator=(const AllocationWorkspaceType &) = delete;
+	};
+
+	// allocate one session by ServerAllocationProblem::RunStrategy4GeneralProblem: run the strategy at each eligible G datacenter and keep the one with the smallest total cost
+	// on error the allocation is left unchanged
+	ErrorCode Allocate(const TopologyType &, const RequestType &, AllocationWorkspaceType &, AllocationType &);
+}
@@ -57,13 +57,133 @@ double GetStdValue(const vector<double> &v)
 	if (v.empty()) return 0;
 
 	double mean = GetMeanValue(v);
-	vector<double> temp;
+	double squaredDeviationSum = 0;
 	for (auto it : v)
 	{
-		temp.push_back((it - mean) * (it - mean));
+		squaredDeviationSum += (it - mean) * (it - mean);
 	}
 
-	return sqrt(GetMeanValue(temp));
+	return sqrt(squaredDeviationSum / v.size());
+}
+
+void StatisticsAccumulatorType::Add(double value)
+{
+	count++;
+	double delta = value - mean;
+	mean += delta / count;
+	squaredDeviationSum += delta * (value - mean);
+	minValue = (1 == count) ? value : std::min(minValue, value);
+	maxValue = (1 == count) ? value : std::max(maxValue, value);
+}
+
+void StatisticsAccumulatorType::Merge(const StatisticsAccumulatorType &other)
+{
+	if (0 == other.count) return;
+	if (0 == count)
+	{
+		*this = other;
+		return;
+	}
+
+	double mergedCount = count + other.count;
+	double delta = other.mean - mean;
+	mean += delta * other.count / mergedCount;
+	squaredDeviationSum += other.squaredDeviationSum + delta * delta * count * other.count / mergedCount;
+	minValue = std::min(minValue, other.minValue);
+	maxValue = std::max(maxValue, other.maxValue);
+	count = mergedCount;
+}
+
+double StatisticsAccumulatorType::GetStd() const
+{
+	return count > 0 ? sqrt(squaredDeviationSum / count) : 0;
+}
+
+double StatisticsAccumulatorType::GetSampleVariance() const
+{
+	return count > 1 ? squaredDeviationSum / (count - 1) : 0;
+}
+
+const double QuantileSketchType::GAMMA = 1.02;
+const double LOG_GAMMA = log(QuantileSketchType::GAMMA);
+
+void QuantileSketchType::Add(double value)
+{
+	count++;
+	sum += value;
+	minValue = (1 == count) ? value : std::min(minValue, value);
+	maxValue = (1 == count) ? value : std::max(maxValue, value);
+
+	if (value <= 0) zeroCount++;
+	else AddToBucket((int)floor(log(value) / LOG_GAMMA + 0.5), 1);
+}
+
+void QuantileSketchType::AddToBucket(int bucketIndex, double bucketCount)
+{
+	if (bucketCounts.empty())
+	{
+		firstBucketIndex = bucketIndex;
+		bucketCounts.assign(1, bucketCount);
+		return;
+	}
+
+	int lastBucketIndex = firstBucketIndex + (int)bucketCounts.size() - 1;
+	if (bucketIndex < firstBucketIndex || bucketIndex > lastBucketIndex) // rebuild the range, collapsing the smallest buckets into the first one that is kept
+	{
+		int newLastBucketIndex = std::max(lastBucketIndex, bucketIndex);
+		int newFirstBucketIndex = std::max(std::min(firstBucketIndex, bucketIndex), newLastBucketIndex - MAX_BUCKET_COUNT + 1);
+		vector<double> newBucketCounts(newLastBucketIndex - newFirstBucketIndex + 1, 0);
+		for (size_t i = 0; i < bucketCounts.size(); i++)
+		{
+			newBucketCounts.at(std::max(firstBucketIndex + (int)i, newFirstBucketIndex) - newFirstBucketIndex) += bucketCounts.at(i);
+		}
+		bucketCounts.swap(newBucketCounts);
+		firstBucketIndex = newFirstBucketIndex;
+	}
+	bucketCounts.at(std::max(bucketIndex, firstBucketIndex) - firstBucketIndex) += bucketCount;
+}
+
+void QuantileSketchType::Merge(const QuantileSketchType &other)
+{
+	if (0 == other.count) return;
+	if (0 == count)
+	{
+		*this = other;
+		return;
+	}
+
+	for (size_t i = 0; i < other.bucketCounts.size(); i++)
+	{
+		if (other.bucketCounts.at(i) > 0) AddToBucket(other.firstBucketIndex + (int)i, other.bucketCounts.at(i));
+	}
+	zeroCount += other.zeroCount;
+	count += other.count;
+	sum += other.sum;
+	minValue = std::min(minValue, other.minValue);
+	maxValue = std::max(maxValue, other.maxValue);
+}
+
+double QuantileSketchType::GetQuantile(double quantile) const
+{
+	if (0 == count) return 0;
+
+	// the rank-th smallest value (1-based, nearest rank; the small tolerance keeps e.g. 0.95 * 100 from rounding up to 96)
+	double rank = std::max(1.0, ceil(quantile * count - 1e-9));
+	if (rank <= 1) return minValue;
+	if (rank >= count) return maxValue;
+
+	double seenCount = zeroCount;
+	if (seenCount >= rank) return std::max(minValue, std::min(0.0, maxValue));
+	for (size_t i = 0; i < bucketCounts.size(); i++)
+	{
+		seenCount += bucketCounts.at(i);
+		if (seenCount >= rank)
+		{
+			double value = pow(GAMMA, firstBucketIndex + (int)i); // within 1% of any value of the bucket
+			return std::max(minValue, std::min(value, maxValue));
+		}
+	}
+	return maxValue;
 }
 
 double GetMinValue(const vector<double> &v)
@@ -80,11 +200,13 @@ double GetMaxValue(const vector<double> &v)
 	return *max_element(v.begin(), v.end());
 }
 
-double GetPercentile(vector<double> v, const double p)
+double GetPercentile(const vector<double> &v, const double p)
 {
-	std::sort(v.begin(), v.end());
-	int rank = (int)ceil((p / 100) * v.size()) - 1;
-	return v.at(rank);
+	// only the element at the rank is put in place (linear time on average), instead of sorting the whole copy
+	int rank = std::max(0, (int)ceil((p / 100) * v.size()) - 1);
+	vector<double> copy(v);
+	std::nth_element(copy.begin(), copy.begin() + rank, copy.end());
+	return copy.at(rank);
 }
 
 double GetRatioOfGreaterThan(const vector<double>& v, const double x)
@@ -95,4 +217,72 @@ double GetRatioOfGreaterThan(const vector<double>& v, const double x)
 		if (i > x) counter++;
 	}
 	return counter / v.size();
+}
+
+double GetStandardNormalQuantile(const double p)
+{
+	// bisection on the normal CDF, 0.5 * erfc(-z / sqrt(2))
+	double low = -10, high = 10;
+	for (int i = 0; i < 100; i++)
+	{
+		double middle = (low + high) / 2;
+		if (0.5 * erfc(-middle / sqrt(2.0)) < p) low = middle;
+		else high = middle;
+	}
+	return (low + high) / 2;
+}
+
+void RunTasksWithWorkStealing(const vector<double> &taskCosts, int threadCount, const std::function<void(int)> &RunTask)
+{
+	threadCount = std::max(1, std::min(threadCount, (int)taskCosts.size()));
+
+	// the longest tasks first, dealt round-robin so that every worker starts with a similar share
+	vector<int> tasks;
+	for (int task = 0; task < (int)taskCosts.size(); task++) tasks.push_back(task);
+	std::stable_sort(tasks.begin(), tasks.end(), [&](int a, int b) { return taskCosts.at(a) > taskCosts.at(b); });
+
+	vector<deque<int>> queues(threadCount);
+	vector<std::mutex> queueMutexes(threadCount);
+	for (size_t i = 0; i < tasks.size(); i++)
+	{
+		queues.at(i % threadCount).push_back(tasks.at(i));
+	}
+
+	auto Worker = [&](int worker)
+	{
+		while (true)
+		{
+			int task = -1;
+			for (int i = 0; i < threadCount && task < 0; i++) // its own queue (from the front) first, then the others (from the back)
+			{
+				int victim = (worker + i) % threadCount;
+				std::lock_guard<std::mutex> lock(queueMutexes.at(victim));
+				if (queues.at(victim).empty()) continue;
+				if (0 == i)
+				{
+					task = queues.at(victim).front();
+					queues.at(victim).pop_front();
+				}
+				else
+				{
+					task = queues.at(victim).back();
+					queues.at(victim).pop_back();
+				}
+			}
+			if (task < 0) break; // all queues are empty (tasks never add tasks)
+
+			RunTask(task);
+		}
+	};
+
+	vector<std::thread> workers;
+	for (int worker = 1; worker < threadCount; worker++)
+	{
+		workers.push_back(std::thread(Worker, worker));
+	}
+	Worker(0);
+	for (auto &worker : workers)
+	{
+		worker.join();
+	}
 }
\ No newline at end of file
@@ -3,16 +3,30 @@
 #include <vector>
 #include <tuple>
 #include <list>
+#include <deque>
 #include <set>
 #include <map>
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <fstream>
-#include <algorithm> // random_shuffle
+#include <algorithm>
 #include <ctime>
 #include <cmath>
+#include <limits>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <functional>
+#include <climits>
+#ifdef _WIN32
 #include <direct.h>
+#else
+#include <sys/stat.h>
+inline int _mkdir(const char *path) { return mkdir(path, 0755); } // for builds outside Visual Studio (e.g. the benchmark with gcc or clang)
+#endif
 
 using namespace std;
 
@@ -22,5 +36,75 @@ double GetMeanValue(const vector<double> &v);
 double GetStdValue(const vector<double> &v);
 double GetMinValue(const vector<double> &v);
 double GetMaxValue(const vector<double> &v);
-double GetPercentile(vector<double>, const double);
-double GetRatioOfGreaterThan(const vector<double>&, const double);
\ No newline at end of file
+double GetPercentile(const vector<double>&, const double); // nearest rank, p from 0 to 100
+double GetRatioOfGreaterThan(const vector<double>&, const double);
+double GetStandardNormalQuantile(const double); // z such that P(Z <= z) = p
+
+// count, mean, variance (Welford), min and max of a stream of values, without keeping the values
+// two accumulators can be merged (Chan et al.), e.g. those of different threads or shards; merging in a fixed order gives the same result every time
+struct StatisticsAccumulatorType
+{
+	double count;
+	double mean;
+	double squaredDeviationSum; // sum of the squared differences from the mean
+	double minValue;
+	double maxValue;
+
+	StatisticsAccumulatorType()
+	{
+		this->count = 0;
+		this->mean = 0;
+		this->squaredDeviationSum = 0;
+		this->minValue = 0;
+		this->maxValue = 0;
+	}
+
+	void Add(double);
+	void Merge(const StatisticsAccumulatorType &);
+
+	// 0 if empty, as GetMeanValue and GetStdValue
+	double GetMean() const { return mean; }
+	double GetStd() const; // population standard deviation, as GetStdValue
+	double GetSampleVariance() const; // 0 with fewer than 2 values
+};
+
+// quantiles of a stream of non-negative values (e.g. delays) in bounded memory, without keeping the values
+// each positive value falls into the log-spaced bucket round(log(value) / log(GAMMA)), whose value is GAMMA^index, so any quantile is within 1% of a value of the stream; zero (and below) has a bucket of its own
+// merging adds the bucket counts, so the merged sketch does not depend on how the values were split (e.g. among threads or shards) nor on the merge order
+struct QuantileSketchType
+{
+	static const double GAMMA; // 1.02 (buckets 2% wide)
+	static const int MAX_BUCKET_COUNT = 2048; // values spanning more than GAMMA^2048 (about 10^17) have their smallest buckets collapsed into one
+
+	vector<double> bucketCounts; // of the buckets firstBucketIndex, firstBucketIndex + 1, etc.
+	int firstBucketIndex;
+	double zeroCount;
+	double count;
+	double sum;
+	double minValue;
+	double maxValue;
+
+	QuantileSketchType()
+	{
+		this->firstBucketIndex = 0;
+		this->zeroCount = 0;
+		this->count = 0;
+		this->sum = 0;
+		this->minValue = 0;
+		this->maxValue = 0;
+	}
+
+	void Add(double);
+	void Merge(const QuantileSketchType &);
+
+	// value at the given quantile (0 to 1), nearest rank (0 if empty); the smallest and largest values are exact
+	double GetQuantile(double) const;
+	double GetMean() const { return count > 0 ? sum / count : 0; }
+
+	// add the given count to one bucket, growing the bucket range (and collapsing its smallest buckets if it gets too wide)
+	void AddToBucket(int, double);
+};
+
+// run the tasks 0 to (taskCosts.size() - 1) on threadCount worker threads (the calling thread is one of them) with work stealing
+// the tasks are dealt to the workers' queues in decreasing order of their estimated costs, and a worker whose queue is empty steals from the back of another worker's queue
+void RunTasksWithWorkStealing(const vector<double> &, int, const std::function<void(int)> &);
\ No newline at end of file
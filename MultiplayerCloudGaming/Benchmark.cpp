@@ -0,0 +1,497 @@
+#include "Benchmark.h"
+
+#include <cstdlib>
+#include <new>
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef MEMORY_PROFILING
+#error the benchmark counts its allocations with its own operator new: build it without MEMORY_PROFILING
+#endif
+
+// count the heap allocations of each thread (this file is only linked into the benchmark)
+// every form of the global operator new and delete is replaced, so that none of them mixes this malloc and free with the library's own (as the MEMORY_PROFILING ones of Instrumentation.cpp)
+static thread_local long long allocationCountOfThread = 0;
+
+static void *AllocateCountedBlock(size_t size) noexcept
+{
+	allocationCountOfThread++;
+	return std::malloc(size > 0 ? size : 1);
+}
+
+// gcc inlines the operator delete below into this file's functions and then sees free called on the result of operator new, not knowing that operator new is the malloc above
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static void FreeCountedBlock(void *memory) noexcept
+{
+	std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+void *operator new(size_t size)
+{
+	if (void *memory = AllocateCountedBlock(size)) return memory;
+	throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+	if (void *memory = AllocateCountedBlock(size)) return memory;
+	throw std::bad_alloc();
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	return AllocateCountedBlock(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return AllocateCountedBlock(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+	FreeCountedBlock(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+	FreeCountedBlock(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+	FreeCountedBlock(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+	FreeCountedBlock(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+	FreeCountedBlock(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+	FreeCountedBlock(memory);
+}
+
+namespace Benchmark
+{
+	using namespace ServerAllocationProblem;
+
+	long long GetAllocationCount()
+	{
+		return allocationCountOfThread;
+	}
+
+	const char *GetCounterName(CounterID counter)
+	{
+		static const char *COUNTER_NAMES[COUNTER_COUNT] = { "cycles", "instructions", "L1DMisses", "LLCMisses", "branchMisses" };
+		return COUNTER_NAMES[counter];
+	}
+
+	HardwareCountersType::HardwareCountersType()
+	{
+		this->fileDescriptors.assign(COUNTER_COUNT, -1);
+#ifdef __linux__
+		const vector<pair<unsigned, unsigned long long>> EVENTS = { // type and config of each counter
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+			{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+			{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES } };
+
+		int groupFileDescriptor = -1;
+		for (int counter = 0; counter < COUNTER_COUNT; counter++)
+		{
+			perf_event_attr attribute;
+			memset(&attribute, 0, sizeof(attribute));
+			attribute.size = sizeof(attribute);
+			attribute.type = EVENTS.at(counter).first;
+			attribute.config = EVENTS.at(counter).second;
+			attribute.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			attribute.exclude_kernel = 1; // allowed with perf_event_paranoid up to 2
+			attribute.exclude_hv = 1;
+
+			// this thread on any cpu
+			int fileDescriptor = (int)syscall(__NR_perf_event_open, &attribute, 0, -1, groupFileDescriptor, 0);
+			if (fileDescriptor < 0)
+			{
+				if (errorMessage.empty()) errorMessage = string("perf_event_open failed for ") + GetCounterName(CounterID(counter)) + " (" + strerror(errno) + "), see /proc/sys/kernel/perf_event_paranoid";
+				continue;
+			}
+			fileDescriptors.at(counter) = fileDescriptor;
+			if (groupFileDescriptor < 0) groupFileDescriptor = fileDescriptor;
+		}
+		if (groupFileDescriptor >= 0) errorMessage.clear();
+#else
+		errorMessage = "hardware counters are only read on Linux";
+#endif
+	}
+
+	HardwareCountersType::~HardwareCountersType()
+	{
+#ifdef __linux__
+		for (auto fileDescriptor : fileDescriptors)
+		{
+			if (fileDescriptor >= 0) close(fileDescriptor);
+		}
+#endif
+	}
+
+	bool HardwareCountersType::IsAvailable() const
+	{
+		return std::any_of(fileDescriptors.begin(), fileDescriptors.end(), [](int fileDescriptor) { return fileDescriptor >= 0; });
+	}
+
+	vector<double> HardwareCountersType::Read() const
+	{
+		vector<double> counts(COUNTER_COUNT, -1);
+#ifdef __linux__
+		auto leader = std::find_if(fileDescriptors.begin(), fileDescriptors.end(), [](int fileDescriptor) { return fileDescriptor >= 0; });
+		if (leader == fileDescriptors.end()) return counts;
+
+		// the whole group in one read: the number of counters, the time enabled and running, then the counts in the order of opening
+		unsigned long long buffer[3 + COUNTER_COUNT];
+		if (read(*leader, buffer, sizeof(buffer)) < (ssize_t)(3 * sizeof(unsigned long long)) || 0 == buffer[2]) return counts; // not counting (yet)
+		double scale = double(buffer[1]) / buffer[2];
+		unsigned long long valueIndex = 0;
+		for (int counter = 0; counter < COUNTER_COUNT && valueIndex < buffer[0]; counter++)
+		{
+			if (fileDescriptors.at(counter) >= 0) counts.at(counter) = buffer[3 + valueIndex++] * scale;
+		}
+#endif
+		return counts;
+	}
+
+	BenchmarkResultType MeasureOperation(const string &name, const string &parameters, const BenchmarkSettingType &setting, const std::function<void(long long)> &Operation, const HardwareCountersType *counters)
+	{
+		long long operationIndex = 0;
+		Operation(operationIndex++); // warm-up
+
+		BenchmarkResultType result;
+		vector<double> nanosecondsPerOperation;
+		long long operationCount = 0;
+		long long allocationCount = GetAllocationCount();
+		for (int repetition = 0; repetition < setting.repetitionCount; repetition++)
+		{
+			long long repetitionOperationCount = 0;
+			double elapsedTime = 0; // nanoseconds
+			vector<double> startCounts = counters ? counters->Read() : vector<double>();
+			auto timePoint = std::chrono::steady_clock::now();
+			for (long long batchSize = 1; elapsedTime < setting.repetitionTime * 1e6; batchSize *= 2)
+			{
+				for (long long i = 0; i < batchSize; i++)
+				{
+					Operation(operationIndex++);
+				}
+				repetitionOperationCount += batchSize;
+				elapsedTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - timePoint).count();
+			}
+			nanosecondsPerOperation.push_back(elapsedTime / repetitionOperationCount);
+			operationCount += repetitionOperationCount;
+
+			// the counters of the fastest repetition so far (the clock reads between the batches are counted too, a few per doubling)
+			if (counters && nanosecondsPerOperation.back() == GetMinValue(nanosecondsPerOperation))
+			{
+				auto endCounts = counters->Read();
+				for (int counter = 0; counter < COUNTER_COUNT; counter++)
+				{
+					result.countersPerOperation.at(counter) = (startCounts.at(counter) < 0 || endCounts.at(counter) < 0) ? -1 : (endCounts.at(counter) - startCounts.at(counter)) / repetitionOperationCount;
+				}
+			}
+		}
+		allocationCount = GetAllocationCount() - allocationCount;
+
+		result.name = name;
+		result.parameters = parameters;
+		result.nanosecondsPerOperation = GetMinValue(nanosecondsPerOperation); // the least disturbed repetition (interference only adds time)
+		result.operationsPerSecond = 1e9 / result.nanosecondsPerOperation;
+		result.allocationsPerOperation = double(allocationCount) / operationCount;
+		result.operationCount = operationCount;
+		return result;
+	}
+
+	// sessions of basic problem (one workspace each, with its G datacenter) with the first datacenterCount dcs (so that their ids are still their indices)
+	// return false if the sessions cannot be formed
+	bool PrepareSessions(const vector<ClientType*> &allClients, const vector<DatacenterType*> &allDatacenters, size_t datacenterCount, double SESSION_SIZE, int sessionCount,
+		vector<WorkspaceType*> &sessions, vector<int> &GDatacenterIDs)
+	{
+		vector<DatacenterType*> candidateDatacenters(allDatacenters.begin(), allDatacenters.begin() + datacenterCount);
+		for (int sessionID = 1; sessionID <= sessionCount; sessionID++)
+		{
+			SessionRandomnessType randomness(sessionID);
+			int GDatacenterID;
+			vector<ClientType*> sessionClients;
+			if (!Matchmaking4BasicProblem(candidateDatacenters, allClients, GDatacenterID, sessionClients, SESSION_SIZE, 75, 50)) return false;
+			sessions.push_back(new WorkspaceType(sessionClients, candidateDatacenters));
+			GDatacenterIDs.push_back(GDatacenterID);
+		}
+		ResetEligibiltyCoverability(allClients, allDatacenters);
+		return true;
+	}
+
+	vector<BenchmarkResultType> RunMicrobenchmarks(const BenchmarkSettingType &setting)
+	{
+		vector<BenchmarkResultType> results;
+
+		HardwareCountersType counters;
+		const HardwareCountersType *measuredCounters = nullptr;
+		if (setting.isHardwareCountersEnabled)
+		{
+			if (counters.IsAvailable())
+			{
+				measuredCounters = &counters;
+				for (int counter = 0; counter < COUNTER_COUNT; counter++)
+				{
+					if (counters.fileDescriptors.at(counter) < 0) printf("hardware counter %s not available\n", GetCounterName(CounterID(counter)));
+				}
+			}
+			else printf("hardware counters not available (%s), timing only\n", counters.errorMessage.c_str());
+		}
+
+		auto Run = [&](const string &name, const string &parameters, const std::function<void(long long)> &Operation)
+		{
+			if (!setting.nameFilter.empty() && name.find(setting.nameFilter) == string::npos) return;
+			results.push_back(MeasureOperation(name, parameters, setting, Operation, measuredCounters));
+			auto &result = results.back();
+			printf("%-26s %-48s %14.1f ns/op %12.1f op/s %8.2f allocs/op", name.c_str(), parameters.c_str(), result.nanosecondsPerOperation, result.operationsPerSecond, result.allocationsPerOperation);
+			if (measuredCounters)
+			{
+				for (int counter = 0; counter < COUNTER_COUNT; counter++)
+				{
+					if (result.countersPerOperation.at(counter) >= 0) printf(" %12.1f %s/op", result.countersPerOperation.at(counter), GetCounterName(CounterID(counter)));
+				}
+			}
+			printf("\n");
+		};
+
+		vector<ClientType*> allClients;
+		vector<DatacenterType*> allDatacenters;
+		if (!Initialize(setting.dataDirectory, allClients, allDatacenters)) return results;
+
+		const vector<double> SESSION_SIZE_LIST = { 10, 20, 50 };
+		const vector<double> SERVER_CAPACITY_LIST = { 2, 4, 8 };
+		const vector<size_t> DATACENTER_COUNT_LIST = { allDatacenters.size() / 2, allDatacenters.size() };
+		const vector<size_t> CLIENT_COUNT_LIST = { allClients.size() / 4, allClients.size() };
+		const vector<pair<string, std::function<tuple<double, double, double, double, double>(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int)>>> STRATEGIES = {
+			{ "Alg_LB", Alg_LB }, { "Alg_RANDOM", Alg_RANDOM }, { "Alg_NEAREST", Alg_NEAREST }, { "Alg_LSP", Alg_LSP }, { "Alg_LBP", Alg_LBP },
+			{ "Alg_LCP", Alg_LCP }, { "Alg_LCW", Alg_LCW }, { "Alg_LAC", Alg_LAC },
+			{ "Alg_OPT", [](const vector<ClientType*> &clients, const vector<DatacenterType*> &datacenters, double serverCapacity, int GDatacenterID) { return Alg_OPT(clients, datacenters, serverCapacity, GDatacenterID, OptimalSettingType().timeBudget); } } }; // within the simulation's default budget
+
+		// strategies on prepared sessions
+		for (auto SESSION_SIZE : SESSION_SIZE_LIST)
+		{
+			for (auto datacenterCount : DATACENTER_COUNT_LIST)
+			{
+				vector<WorkspaceType*> sessions;
+				vector<int> GDatacenterIDs;
+				bool isPrepared = PrepareSessions(allClients, allDatacenters, datacenterCount, SESSION_SIZE, setting.sessionCount, sessions, GDatacenterIDs);
+				for (auto serverCapacity : SERVER_CAPACITY_LIST)
+				{
+					string parameters = "sessionSize=" + std::to_string((int)SESSION_SIZE) + ";capacity=" + std::to_string((int)serverCapacity) + ";datacenterCount=" + std::to_string(datacenterCount);
+					for (auto &strategy : STRATEGIES)
+					{
+						if (!isPrepared)
+						{
+							printf("%-26s %-48s skipped (sessions cannot be formed)\n", strategy.first.c_str(), parameters.c_str());
+							continue;
+						}
+						Run(strategy.first, parameters, [&](long long i)
+						{
+							auto session = sessions.at(i % sessions.size());
+							strategy.second(session->clients, session->datacenters, serverCapacity, GDatacenterIDs.at(i % sessions.size()));
+						});
+					}
+				}
+
+				// the G datacenter search of general problem on the same sessions
+				if (isPrepared)
+				{
+					Run("SearchEligibleGDatacenter", "sessionSize=" + std::to_string((int)SESSION_SIZE) + ";datacenterCount=" + std::to_string(datacenterCount), [&](long long i)
+					{
+						auto session = sessions.at(i % sessions.size());
+						vector<DatacenterType*> eligibleGDatacenters;
+						SearchEligibleGDatacenter(session->datacenters, session->clients, eligibleGDatacenters, 75, 50);
+					});
+				}
+
+				for (auto session : sessions) delete session;
+			}
+		}
+
+		// matchmaking of basic problem, each operation with the randomness of another session
+		for (auto SESSION_SIZE : SESSION_SIZE_LIST)
+		{
+			for (auto datacenterCount : DATACENTER_COUNT_LIST)
+			{
+				for (auto clientCount : CLIENT_COUNT_LIST)
+				{
+					vector<DatacenterType*> candidateDatacenters(allDatacenters.begin(), allDatacenters.begin() + datacenterCount);
+					vector<ClientType*> candidateClients(allClients.begin(), allClients.begin() + clientCount);
+					Run("Matchmaking4BasicProblem", "sessionSize=" + std::to_string((int)SESSION_SIZE) + ";datacenterCount=" + std::to_string(datacenterCount) + ";clientCount=" + std::to_string(clientCount), [&](long long i)
+					{
+						SessionRandomnessType randomness(int(i % setting.sessionCount) + 1);
+						int GDatacenterID;
+						vector<ClientType*> sessionClients;
+						Matchmaking4BasicProblem(candidateDatacenters, candidateClients, GDatacenterID, sessionClients, SESSION_SIZE, 75, 50);
+					});
+				}
+			}
+		}
+		ResetEligibiltyCoverability(allClients, allDatacenters);
+
+		for (auto client : allClients) delete client;
+		for (auto dc : allDatacenters) delete dc;
+
+		// one round of MaximumMatchingProblem (what Simulate does per round, without its output)
+		MatchmakingProblem::MaximumMatchingProblem maximumMatchingProblem;
+		maximumMatchingProblem.Initialize(setting.dataDirectory);
+		for (int clientCount : { 25, 100, 200 })
+		{
+			for (int latencyThreshold : { 50, 100 })
+			{
+				Run("MaximumMatchingProblem", "clientCount=" + std::to_string(clientCount) + ";latencyThreshold=" + std::to_string(latencyThreshold) + ";sessionSize=10", [&](long long)
+				{
+					maximumMatchingProblem.GetAverageSuccessRate(clientCount, latencyThreshold, 10, 1);
+				});
+			}
+		}
+
+		return results;
+	}
+
+	bool WriteBenchmarkResults(const vector<BenchmarkResultType> &results, const string &fileName)
+	{
+		ofstream file(fileName);
+		if (!file.is_open()) return false;
+
+		file << "name,parameters,nsPerOp,opsPerSecond,allocationsPerOp,operationCount";
+		for (int counter = 0; counter < COUNTER_COUNT; counter++)
+		{
+			file << "," << GetCounterName(CounterID(counter)) << "PerOp";
+		}
+		file << "\n";
+		file.precision(10);
+		for (auto &result : results)
+		{
+			file << result.name << "," << result.parameters << "," << result.nanosecondsPerOperation << "," << result.operationsPerSecond << "," << result.allocationsPerOperation << "," << result.operationCount;
+			for (auto count : result.countersPerOperation)
+			{
+				file << ",";
+				if (count >= 0) file << count;
+			}
+			file << "\n";
+		}
+		return true;
+	}
+
+	bool ReadBenchmarkResults(const string &fileName, vector<BenchmarkResultType> &results)
+	{
+		ifstream file(fileName);
+		if (!file.is_open()) return false;
+
+		results.clear();
+		string line;
+		std::getline(file, line); // header
+		while (std::getline(file, line))
+		{
+			stringstream lineStream(line);
+			vector<string> fields;
+			string field;
+			while (std::getline(lineStream, field, ','))
+			{
+				fields.push_back(field);
+			}
+			if (fields.size() < 6) continue;
+
+			BenchmarkResultType result;
+			result.name = fields.at(0);
+			result.parameters = fields.at(1);
+			result.nanosecondsPerOperation = std::stod(fields.at(2));
+			result.operationsPerSecond = std::stod(fields.at(3));
+			result.allocationsPerOperation = std::stod(fields.at(4));
+			result.operationCount = std::stoll(fields.at(5));
+			for (int counter = 0; counter < COUNTER_COUNT && 6 + counter < (int)fields.size(); counter++)
+			{
+				if (!fields.at(6 + counter).empty()) result.countersPerOperation.at(counter) = std::stod(fields.at(6 + counter));
+			}
+			results.push_back(result);
+		}
+		return true;
+	}
+
+	// one line with the change of each counter measured in both, if any
+	void PrintCounterChanges(const BenchmarkResultType &result, const BenchmarkResultType &baseline)
+	{
+		string line;
+		for (int counter = 0; counter < COUNTER_COUNT; counter++)
+		{
+			double count = result.countersPerOperation.at(counter), baselineCount = baseline.countersPerOperation.at(counter);
+			if (count < 0 || baselineCount < 0) continue;
+
+			char text[128];
+			snprintf(text, sizeof(text), " %s/op %.1f (baseline %.1f)", GetCounterName(CounterID(counter)), count, baselineCount);
+			line += text;
+		}
+		if (!line.empty()) printf("           %s\n", line.c_str());
+	}
+
+	int CompareWithBaseline(const vector<BenchmarkResultType> &results, const vector<BenchmarkResultType> &baseline, double regressionThreshold)
+	{
+		map<pair<string, string>, const BenchmarkResultType*> baselineOfCase;
+		for (auto &result : baseline)
+		{
+			baselineOfCase[make_pair(result.name, result.parameters)] = &result;
+		}
+
+		int regressionCount = 0, improvementCount = 0;
+		for (auto &result : results)
+		{
+			auto it = baselineOfCase.find(make_pair(result.name, result.parameters));
+			if (it == baselineOfCase.end())
+			{
+				printf("NEW         %s %s\n", result.name.c_str(), result.parameters.c_str());
+				continue;
+			}
+
+			double change = result.nanosecondsPerOperation / it->second->nanosecondsPerOperation - 1;
+			bool isMoreAllocating = result.allocationsPerOperation > it->second->allocationsPerOperation + 0.5; // at least one more allocation in every other op
+			if (change > regressionThreshold || isMoreAllocating)
+			{
+				regressionCount++;
+				printf("REGRESSION  %s %s: %.1f ns/op (baseline %.1f, %+.1f%%), %.2f allocs/op (baseline %.2f)\n", result.name.c_str(), result.parameters.c_str(),
+					result.nanosecondsPerOperation, it->second->nanosecondsPerOperation, change * 100, result.allocationsPerOperation, it->second->allocationsPerOperation);
+				PrintCounterChanges(result, *it->second);
+			}
+			else if (change < -regressionThreshold)
+			{
+				improvementCount++;
+				printf("IMPROVEMENT %s %s: %.1f ns/op (baseline %.1f, %+.1f%%)\n", result.name.c_str(), result.parameters.c_str(), result.nanosecondsPerOperation, it->second->nanosecondsPerOperation, change * 100);
+				PrintCounterChanges(result, *it->second);
+			}
+			baselineOfCase.erase(it);
+		}
+		for (auto &missing : baselineOfCase)
+		{
+			printf("MISSING     %s %s\n", missing.first.first.c_str(), missing.first.second.c_str());
+		}
+
+		printf("%d regressions and %d improvements beyond %.0f%% in %d cases\n", regressionCount, improvementCount, regressionThreshold * 100, (int)results.size());
+		return regressionCount;
+	}
+}
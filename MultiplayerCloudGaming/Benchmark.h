@@ -0,0 +1,106 @@
+#pragma once
+
+#include "ServerAllocationProblem.h"
+#include "MatchmakingProblem.h"
+
+// microbenchmarks of the hot paths (built as the MultiplayerCloudGamingBenchmark project, or with any C++14 compiler from Base.cpp, Random.cpp, Instrumentation.cpp, ServerAllocationProblem.cpp, RawResults.cpp, MatchmakingProblem.cpp, Benchmark.cpp and BenchmarkMain.cpp)
+// each case runs one operation (e.g. one Alg_LAC call on one session) over and over, and reports ns/op, throughput and heap allocations per op
+// optionally (-counters 1) also hardware counters per op (cycles, instructions, L1D, LLC and branch misses), from Linux perf_event_open; without them (other platforms, or containers without the permission) the cases are timed as usual
+namespace Benchmark
+{
+	struct BenchmarkSettingType
+	{
+		string dataDirectory; // of the dataset files (dc_to_pl_rtt.csv, etc.)
+		double repetitionTime; // milliseconds of each repetition of a case
+		int repetitionCount; // the fastest of the repetitions is reported
+		int sessionCount; // sessions prepared for each case (the operations cycle through them)
+		double regressionThreshold; // relative increase of ns/op over the baseline that counts as a regression
+		string nameFilter; // only the cases whose name contains it (empty: all)
+		bool isHardwareCountersEnabled; // read the hardware counters around each repetition (off by default)
+
+		BenchmarkSettingType()
+		{
+#ifdef _WIN32
+			this->dataDirectory = ".\\Data\\";
+#else
+			this->dataDirectory = "./Data/";
+#endif
+			this->repetitionTime = 20;
+			this->repetitionCount = 5;
+			this->sessionCount = 16;
+			this->regressionThreshold = 0.2;
+			this->isHardwareCountersEnabled = false;
+		}
+	};
+
+	enum CounterID
+	{
+		COUNTER_CYCLES,
+		COUNTER_INSTRUCTIONS,
+		COUNTER_L1D_MISSES, // L1 data cache read misses
+		COUNTER_LLC_MISSES, // last level cache misses
+		COUNTER_BRANCH_MISSES,
+		COUNTER_COUNT
+	};
+
+	// e.g. "cycles" or "LLCMisses"
+	const char *GetCounterName(CounterID);
+
+	// the hardware counters of the calling thread (user mode only), opened as one group so that they count over the same time
+	// a counter the machine does not have (e.g. the LLC event in some VMs) is left out, the others still count
+	struct HardwareCountersType
+	{
+		vector<int> fileDescriptors; // per counter, -1 if not opened (the first opened one leads the group)
+		string errorMessage; // why no counter could be opened
+
+		HardwareCountersType();
+		~HardwareCountersType();
+		HardwareCountersType(const HardwareCountersType &) = delete;
+		HardwareCountersType &operator=(const HardwareCountersType &) = delete;
+
+		// false if no counter could be opened (e.g. not Linux, or perf_event_paranoid too high)
+		bool IsAvailable() const;
+
+		// counts so far per counter (indexed by CounterID, negative if not opened), scaled up if the kernel had to share the hardware with other groups
+		vector<double> Read() const;
+	};
+
+	// measurement of one case
+	struct BenchmarkResultType
+	{
+		string name; // e.g. Alg_LAC
+		string parameters; // e.g. sessionSize=10;capacity=4;datacenterCount=13
+		double nanosecondsPerOperation;
+		double operationsPerSecond;
+		double allocationsPerOperation;
+		long long operationCount; // over all repetitions
+		vector<double> countersPerOperation; // per counter (indexed by CounterID), in the reported repetition; negative if not measured
+
+		BenchmarkResultType()
+		{
+			this->countersPerOperation.assign(COUNTER_COUNT, -1);
+		}
+	};
+
+	// heap allocations (operator new) made by the calling thread so far
+	long long GetAllocationCount();
+
+	// time one operation: repetitions of at least repetitionTime each, in batches of doubling size, after one warm-up call
+	// operation(i) runs the i-th operation of the case
+	// with counters, they are read before and after each repetition, and those of the fastest repetition are reported
+	BenchmarkResultType MeasureOperation(const string &, const string &, const BenchmarkSettingType &, const std::function<void(long long)> &, const HardwareCountersType * = nullptr);
+
+	// all cases: each Alg_* at each session size, capacity and dc count; Matchmaking4BasicProblem at each session size, dc count and client count; SearchEligibleGDatacenter at each session size and dc count; and one round of MaximumMatchingProblem at each client count and latency threshold
+	// the cases are printed as they finish; a case whose sessions cannot be formed (e.g. too few dcs for the delay bounds) is skipped
+	vector<BenchmarkResultType> RunMicrobenchmarks(const BenchmarkSettingType &);
+
+	// one line per case: name,parameters,nsPerOp,opsPerSecond,allocationsPerOp,operationCount,cyclesPerOp,instructionsPerOp,L1DMissesPerOp,LLCMissesPerOp,branchMissesPerOp
+	// a counter that was not measured is left empty (files of earlier builds, without the counter columns, are read as well)
+	bool WriteBenchmarkResults(const vector<BenchmarkResultType> &, const string &);
+	bool ReadBenchmarkResults(const string &, vector<BenchmarkResultType> &);
+
+	// print each case that is slower than its baseline by more than regressionThreshold, or allocates more per op, and a summary
+	// a regression or improvement also shows the change of each counter measured on both sides (e.g. whether the LLC misses went down with the time)
+	// return the number of regressions (cases missing from either side are listed but not counted)
+	int CompareWithBaseline(const vector<BenchmarkResultType> &, const vector<BenchmarkResultType> &, double);
+}
@@ -0,0 +1,70 @@
+#include "Benchmark.h"
+
+// MultiplayerCloudGamingBenchmark [-data <directory>] [-output <file>] [-baseline <file>] [-filter <name>] [-time <ms>] [-repetitions <count>] [-threshold <fraction>] [-counters 0|1]
+// runs all cases (or those whose name contains the filter), writes them to the output file (default: Output\microbenchmark.csv of the data directory), and compares them with the baseline file if given (e.g. the output of an earlier build)
+// exit code: 0 if fine, 1 if any case regressed, 2 on errors
+int main(int argc, char *argv[])
+{
+	Benchmark::BenchmarkSettingType setting;
+	string outputFile, baselineFile;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		string option = argv[i], value = argv[i + 1];
+		if ("-data" == option)
+			setting.dataDirectory = value;
+		else if ("-output" == option)
+			outputFile = value;
+		else if ("-baseline" == option)
+			baselineFile = value;
+		else if ("-filter" == option)
+			setting.nameFilter = value;
+		else if ("-time" == option)
+			setting.repetitionTime = std::stod(value);
+		else if ("-repetitions" == option)
+			setting.repetitionCount = std::stoi(value);
+		else if ("-threshold" == option)
+			setting.regressionThreshold = std::stod(value);
+		else if ("-counters" == option)
+			setting.isHardwareCountersEnabled = ("1" == value);
+		else
+		{
+			printf("ERROR: unknown option %s\n", option.c_str());
+			return 2;
+		}
+	}
+	if (outputFile.empty())
+	{
+		_mkdir((setting.dataDirectory + "Output").c_str());
+#ifdef _WIN32
+		outputFile = setting.dataDirectory + "Output\\microbenchmark.csv";
+#else
+		outputFile = setting.dataDirectory + "Output/microbenchmark.csv";
+#endif
+	}
+
+	auto results = Benchmark::RunMicrobenchmarks(setting);
+	if (results.empty())
+	{
+		printf("ERROR: no case was run\n");
+		return 2;
+	}
+	if (!Benchmark::WriteBenchmarkResults(results, outputFile))
+	{
+		printf("ERROR: cannot write %s\n", outputFile.c_str());
+		return 2;
+	}
+	printf("%d cases written to %s\n", (int)results.size(), outputFile.c_str());
+
+	if (!baselineFile.empty())
+	{
+		vector<Benchmark::BenchmarkResultType> baseline;
+		if (!Benchmark::ReadBenchmarkResults(baselineFile, baseline))
+		{
+			printf("ERROR: cannot read %s\n", baselineFile.c_str());
+			return 2;
+		}
+		if (Benchmark::CompareWithBaseline(results, baseline, setting.regressionThreshold) > 0) return 1;
+	}
+
+	return 0;
+}
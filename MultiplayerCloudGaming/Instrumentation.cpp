@@ -0,0 +1,597 @@
+#include "Instrumentation.h"
+
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace Instrumentation
+{
+	PhaseID GetStrategyPhase(int strategyID)
+	{
+		return PhaseID(PHASE_STRATEGY_LB + strategyID - 1);
+	}
+
+	const char *GetPhaseName(PhaseID phase)
+	{
+		static const char *PHASE_NAMES[PHASE_COUNT] = { "load", "matchmaking", "eligibility",
+			"strategy LB", "strategy RANDOM", "strategy NEAREST", "strategy LSP", "strategy LBP", "strategy LCP", "strategy LCW", "strategy LAC", "strategy OPT",
+			"local search", "validation", "output" };
+		return PHASE_NAMES[phase];
+	}
+
+	void HistogramType::Merge(const HistogramType &other)
+	{
+		for (int i = 0; i < BUCKET_COUNT; i++)
+		{
+			bucketCounts.at(i) += other.bucketCounts.at(i);
+		}
+		count += other.count;
+		totalNanoseconds += other.totalNanoseconds;
+		maxNanoseconds = std::max(maxNanoseconds, other.maxNanoseconds);
+	}
+
+	double HistogramType::GetQuantile(double quantile) const
+	{
+		if (0 == count) return 0;
+
+		// the rank-th smallest duration (1-based, nearest rank)
+		unsigned long long rank = std::max(1ULL, (unsigned long long)ceil(quantile * count));
+		unsigned long long seenCount = 0;
+		for (int i = 0; i < BUCKET_COUNT; i++)
+		{
+			seenCount += bucketCounts.at(i);
+			if (seenCount >= rank)
+			{
+				double lowerBound = (double)GetBucketLowerBound(i);
+				double upperBound = (i + 1 < BUCKET_COUNT) ? (double)GetBucketLowerBound(i + 1) : 18446744073709551616.0;
+				return std::min((lowerBound + upperBound - 1) / 2, (double)maxNanoseconds);
+			}
+		}
+		return (double)maxNanoseconds;
+	}
+
+	// durations below 8 ns have a bucket each, then each power of two [2^e, 2^(e+1)) is split into 8 buckets
+	int GetBucketIndex(unsigned long long nanoseconds)
+	{
+		if (nanoseconds < 8) return (int)nanoseconds;
+
+		int exponent = 0; // floor(log2(nanoseconds)), by binary search
+		for (int shift = 32; shift > 0; shift /= 2)
+		{
+			if (nanoseconds >> (exponent + shift)) exponent += shift;
+		}
+		return (exponent - 2) * 8 + (int)((nanoseconds >> (exponent - 3)) & 7);
+	}
+
+	unsigned long long GetBucketLowerBound(int bucketIndex)
+	{
+		if (bucketIndex < 8) return (unsigned long long)bucketIndex;
+
+		int exponent = bucketIndex / 8 + 2;
+		return (8ULL + bucketIndex % 8) << (exponent - 3);
+	}
+
+	std::atomic<bool> isPhaseTimingEnabled(true);
+
+	void SetPhaseTimingEnabled(bool enabled)
+	{
+		isPhaseTimingEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool IsPhaseTimingEnabled()
+	{
+		return isPhaseTimingEnabled.load(std::memory_order_relaxed);
+	}
+
+	// the histograms of one thread: written only by that thread (relaxed load and store, no read-modify-write), and read by any thread through the registry
+	struct ThreadHistogramsType
+	{
+		std::atomic<unsigned long long> bucketCounts[PHASE_COUNT][HistogramType::BUCKET_COUNT];
+		std::atomic<unsigned long long> counts[PHASE_COUNT];
+		std::atomic<unsigned long long> totalNanoseconds[PHASE_COUNT];
+		std::atomic<unsigned long long> maxNanoseconds[PHASE_COUNT];
+
+		ThreadHistogramsType();
+		~ThreadHistogramsType();
+
+		void Clear();
+
+		// add this thread's histograms to the given ones (indexed by PhaseID)
+		void AddTo(vector<HistogramType> &) const;
+	};
+
+	// the histograms of the running threads, and the sum of those of the threads that have ended
+	struct HistogramRegistryType
+	{
+		std::mutex mutex;
+		vector<ThreadHistogramsType*> threadHistograms;
+		vector<HistogramType> endedThreadHistograms;
+
+		HistogramRegistryType()
+		{
+			this->endedThreadHistograms.resize(PHASE_COUNT);
+		}
+	};
+
+	// never destroyed, so that threads ending during the static destruction can still unregister
+	HistogramRegistryType &GetHistogramRegistry()
+	{
+		static HistogramRegistryType *registry = new HistogramRegistryType;
+		return *registry;
+	}
+
+	ThreadHistogramsType::ThreadHistogramsType()
+	{
+		Clear();
+		auto &registry = GetHistogramRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.threadHistograms.push_back(this);
+	}
+
+	ThreadHistogramsType::~ThreadHistogramsType()
+	{
+		auto &registry = GetHistogramRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		AddTo(registry.endedThreadHistograms);
+		registry.threadHistograms.erase(std::find(registry.threadHistograms.begin(), registry.threadHistograms.end(), this));
+	}
+
+	void ThreadHistogramsType::Clear()
+	{
+		for (int phase = 0; phase < PHASE_COUNT; phase++)
+		{
+			for (auto &bucketCount : bucketCounts[phase]) bucketCount.store(0, std::memory_order_relaxed);
+			counts[phase].store(0, std::memory_order_relaxed);
+			totalNanoseconds[phase].store(0, std::memory_order_relaxed);
+			maxNanoseconds[phase].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void ThreadHistogramsType::AddTo(vector<HistogramType> &histograms) const
+	{
+		for (int phase = 0; phase < PHASE_COUNT; phase++)
+		{
+			auto &histogram = histograms.at(phase);
+			for (int i = 0; i < HistogramType::BUCKET_COUNT; i++)
+			{
+				histogram.bucketCounts.at(i) += bucketCounts[phase][i].load(std::memory_order_relaxed);
+			}
+			histogram.count += counts[phase].load(std::memory_order_relaxed);
+			histogram.totalNanoseconds += (double)totalNanoseconds[phase].load(std::memory_order_relaxed);
+			histogram.maxNanoseconds = std::max(histogram.maxNanoseconds, maxNanoseconds[phase].load(std::memory_order_relaxed));
+		}
+	}
+
+	thread_local ThreadHistogramsType threadHistograms; // registered on the thread's first record
+
+	void RecordPhase(PhaseID phase, unsigned long long nanoseconds)
+	{
+		if (!IsPhaseTimingEnabled()) return;
+
+		auto Increase = [](std::atomic<unsigned long long> &value, unsigned long long increment) { value.store(value.load(std::memory_order_relaxed) + increment, std::memory_order_relaxed); };
+		Increase(threadHistograms.bucketCounts[phase][GetBucketIndex(nanoseconds)], 1);
+		Increase(threadHistograms.counts[phase], 1);
+		Increase(threadHistograms.totalNanoseconds[phase], nanoseconds);
+		if (nanoseconds > threadHistograms.maxNanoseconds[phase].load(std::memory_order_relaxed)) threadHistograms.maxNanoseconds[phase].store(nanoseconds, std::memory_order_relaxed);
+	}
+
+	thread_local PhaseID currentPhaseOfThread = PHASE_COUNT; // constant-initialized, so that operator new can read it at any time
+
+	PhaseID GetCurrentPhase()
+	{
+		return currentPhaseOfThread;
+	}
+
+	PhaseID EnterPhase(PhaseID phase)
+	{
+		PhaseID previousPhase = currentPhaseOfThread;
+		currentPhaseOfThread = phase;
+		return previousPhase;
+	}
+
+	void PhaseTimerType::Stop()
+	{
+		if (!isPhaseLeft)
+		{
+			EnterPhase(previousPhase);
+			isPhaseLeft = true;
+		}
+		if (isStopped) return;
+		RecordPhase(phase, (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count());
+		isStopped = true;
+	}
+
+	vector<HistogramType> GetPhaseHistograms()
+	{
+		auto &registry = GetHistogramRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		auto histograms = registry.endedThreadHistograms;
+		for (auto thread : registry.threadHistograms)
+		{
+			thread->AddTo(histograms);
+		}
+		return histograms;
+	}
+
+	void ResetPhaseHistograms()
+	{
+		auto &registry = GetHistogramRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.endedThreadHistograms.assign(PHASE_COUNT, HistogramType());
+		for (auto thread : registry.threadHistograms)
+		{
+			thread->Clear(); // a record being made by that thread at the same time may survive
+		}
+	}
+
+	bool WritePhaseTimings(const string &fileName)
+	{
+		auto histograms = GetPhaseHistograms();
+
+		ofstream file(fileName);
+		file << "{\n\t\"phases\": [";
+		printf("%-18s %10s %12s %10s %10s %10s %10s\n", "phase", "count", "total ms", "mean ms", "p50 ms", "p99 ms", "max ms");
+		bool isFirst = true;
+		for (int phase = 0; phase < PHASE_COUNT; phase++)
+		{
+			auto &histogram = histograms.at(phase);
+			if (0 == histogram.count) continue;
+
+			const double NS_PER_MS = 1e6;
+			double totalTime = histogram.totalNanoseconds / NS_PER_MS, meanTime = totalTime / histogram.count;
+			double p50Time = histogram.GetQuantile(0.5) / NS_PER_MS, p99Time = histogram.GetQuantile(0.99) / NS_PER_MS, maxTime = histogram.maxNanoseconds / NS_PER_MS;
+
+			char line[512];
+			snprintf(line, sizeof(line), "%s\n\t\t{\"name\": \"%s\", \"count\": %llu, \"total_ms\": %.6f, \"mean_ms\": %.6f, \"p50_ms\": %.6f, \"p99_ms\": %.6f, \"max_ms\": %.6f}",
+				isFirst ? "" : ",", GetPhaseName(PhaseID(phase)), histogram.count, totalTime, meanTime, p50Time, p99Time, maxTime);
+			file << line;
+			printf("%-18s %10llu %12.1f %10.3f %10.3f %10.3f %10.3f\n", GetPhaseName(PhaseID(phase)), histogram.count, totalTime, meanTime, p50Time, p99Time, maxTime);
+			isFirst = false;
+		}
+		file << "\n\t]\n}\n";
+		file.close();
+
+		return !file.fail();
+	}
+
+	const char *GetMemoryStructureName(MemoryStructureID structure)
+	{
+		static const char *STRUCTURE_NAMES[STRUCTURE_COUNT] = { "other", "topology", "session", "results" };
+		return STRUCTURE_NAMES[structure];
+	}
+
+	thread_local MemoryStructureID currentStructureOfThread = STRUCTURE_OTHER;
+
+	MemoryStructureID GetCurrentMemoryStructure()
+	{
+		return currentStructureOfThread;
+	}
+
+	MemoryStructureScopeType::MemoryStructureScopeType(MemoryStructureID structure)
+	{
+		this->previousStructure = currentStructureOfThread;
+		currentStructureOfThread = structure;
+	}
+
+	MemoryStructureScopeType::~MemoryStructureScopeType()
+	{
+		currentStructureOfThread = previousStructure;
+	}
+
+	bool IsAllocationTrackingEnabled()
+	{
+#ifdef MEMORY_PROFILING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// shared by all threads (zero-initialized before any allocation); the counts and bytes since the last reset, the live bytes since the process started
+	std::atomic<long long> allocationCountOfPhase[PHASE_COUNT + 1];
+	std::atomic<long long> allocatedBytesOfPhase[PHASE_COUNT + 1];
+	std::atomic<long long> liveBytesOfStructure[STRUCTURE_COUNT + 1]; // the last one is the total
+	std::atomic<long long> peakLiveBytesOfStructure[STRUCTURE_COUNT + 1];
+
+	// raise a peak to the given value if it is higher
+	void RaisePeak(std::atomic<long long> &peak, long long value)
+	{
+		long long currentPeak = peak.load(std::memory_order_relaxed);
+		while (value > currentPeak && !peak.compare_exchange_weak(currentPeak, value, std::memory_order_relaxed));
+	}
+
+	void RecordAllocation(size_t bytes, MemoryStructureID structure)
+	{
+		allocationCountOfPhase[currentPhaseOfThread].fetch_add(1, std::memory_order_relaxed);
+		allocatedBytesOfPhase[currentPhaseOfThread].fetch_add((long long)bytes, std::memory_order_relaxed);
+		RaisePeak(peakLiveBytesOfStructure[structure], liveBytesOfStructure[structure].fetch_add((long long)bytes, std::memory_order_relaxed) + (long long)bytes);
+		RaisePeak(peakLiveBytesOfStructure[STRUCTURE_COUNT], liveBytesOfStructure[STRUCTURE_COUNT].fetch_add((long long)bytes, std::memory_order_relaxed) + (long long)bytes);
+	}
+
+	void RecordDeallocation(size_t bytes, MemoryStructureID structure)
+	{
+		liveBytesOfStructure[structure].fetch_sub((long long)bytes, std::memory_order_relaxed);
+		liveBytesOfStructure[STRUCTURE_COUNT].fetch_sub((long long)bytes, std::memory_order_relaxed);
+	}
+
+	double GetResidentSetBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return (double)counters.WorkingSetSize;
+#elif defined(__linux__)
+		long long totalPages = 0, residentPages = 0;
+		if (FILE *file = fopen("/proc/self/statm", "r"))
+		{
+			int fieldCount = fscanf(file, "%lld %lld", &totalPages, &residentPages);
+			fclose(file);
+			if (2 == fieldCount) return (double)residentPages * sysconf(_SC_PAGESIZE);
+		}
+#endif
+		return 0;
+	}
+
+	double GetPeakResidentSetBytes()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return (double)counters.PeakWorkingSetSize;
+#elif defined(__linux__)
+		struct rusage usage;
+		if (0 == getrusage(RUSAGE_SELF, &usage)) return (double)usage.ru_maxrss * 1024; // kilobytes
+#endif
+		return 0;
+	}
+
+	MemoryProfileType GetMemoryProfile()
+	{
+		MemoryProfileType profile;
+		for (int phase = 0; phase <= PHASE_COUNT; phase++)
+		{
+			profile.allocationCounts.at(phase) = (double)allocationCountOfPhase[phase].load(std::memory_order_relaxed);
+			profile.allocatedBytes.at(phase) = (double)allocatedBytesOfPhase[phase].load(std::memory_order_relaxed);
+		}
+		for (int structure = 0; structure < STRUCTURE_COUNT; structure++)
+		{
+			profile.liveBytes.at(structure) = (double)liveBytesOfStructure[structure].load(std::memory_order_relaxed);
+			profile.peakLiveBytes.at(structure) = (double)peakLiveBytesOfStructure[structure].load(std::memory_order_relaxed);
+		}
+		profile.totalLiveBytes = (double)liveBytesOfStructure[STRUCTURE_COUNT].load(std::memory_order_relaxed);
+		profile.peakTotalLiveBytes = (double)peakLiveBytesOfStructure[STRUCTURE_COUNT].load(std::memory_order_relaxed);
+		profile.residentBytes = GetResidentSetBytes();
+		profile.peakResidentBytes = GetPeakResidentSetBytes();
+		return profile;
+	}
+
+	void ResetMemoryProfile()
+	{
+		for (int phase = 0; phase <= PHASE_COUNT; phase++)
+		{
+			allocationCountOfPhase[phase].store(0, std::memory_order_relaxed);
+			allocatedBytesOfPhase[phase].store(0, std::memory_order_relaxed);
+		}
+		for (int structure = 0; structure <= STRUCTURE_COUNT; structure++)
+		{
+			peakLiveBytesOfStructure[structure].store(liveBytesOfStructure[structure].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	}
+
+	bool WriteMemoryProfile(const string &fileName)
+	{
+		auto profile = GetMemoryProfile();
+		const double BYTES_PER_MB = 1048576;
+
+		ofstream file(fileName);
+		char line[512];
+		snprintf(line, sizeof(line), "{\n\t\"allocationTracking\": %s,\n\t\"residentBytes\": %.0f,\n\t\"peakResidentBytes\": %.0f,\n\t\"totalLiveBytes\": %.0f,\n\t\"peakTotalLiveBytes\": %.0f,\n\t\"phases\": [",
+			IsAllocationTrackingEnabled() ? "true" : "false", profile.residentBytes, profile.peakResidentBytes, profile.totalLiveBytes, profile.peakTotalLiveBytes);
+		file << line;
+		printf("resident set: %.1f MB now, %.1f MB at peak\n", profile.residentBytes / BYTES_PER_MB, profile.peakResidentBytes / BYTES_PER_MB);
+		if (!IsAllocationTrackingEnabled()) printf("(allocations per phase and live bytes per structure: build with MEMORY_PROFILING)\n");
+		else printf("%-18s %14s %12s %12s\n", "phase", "allocations", "MB", "bytes/alloc");
+
+		bool isFirst = true;
+		for (int phase = 0; phase <= PHASE_COUNT && IsAllocationTrackingEnabled(); phase++)
+		{
+			if (0 == profile.allocationCounts.at(phase)) continue;
+
+			const char *name = (phase < PHASE_COUNT) ? GetPhaseName(PhaseID(phase)) : "none";
+			snprintf(line, sizeof(line), "%s\n\t\t{\"name\": \"%s\", \"allocations\": %.0f, \"bytes\": %.0f}", isFirst ? "" : ",", name, profile.allocationCounts.at(phase), profile.allocatedBytes.at(phase));
+			file << line;
+			printf("%-18s %14.0f %12.1f %12.1f\n", name, profile.allocationCounts.at(phase), profile.allocatedBytes.at(phase) / BYTES_PER_MB, profile.allocatedBytes.at(phase) / profile.allocationCounts.at(phase));
+			isFirst = false;
+		}
+		file << "\n\t],\n\t\"structures\": [";
+		if (IsAllocationTrackingEnabled()) printf("%-18s %14s %12s\n", "structure", "live MB", "peak MB");
+
+		isFirst = true;
+		for (int structure = 0; structure < STRUCTURE_COUNT && IsAllocationTrackingEnabled(); structure++)
+		{
+			const char *name = GetMemoryStructureName(MemoryStructureID(structure));
+			snprintf(line, sizeof(line), "%s\n\t\t{\"name\": \"%s\", \"liveBytes\": %.0f, \"peakLiveBytes\": %.0f}", isFirst ? "" : ",", name, profile.liveBytes.at(structure), profile.peakLiveBytes.at(structure));
+			file << line;
+			printf("%-18s %14.1f %12.1f\n", name, profile.liveBytes.at(structure) / BYTES_PER_MB, profile.peakLiveBytes.at(structure) / BYTES_PER_MB);
+			isFirst = false;
+		}
+		if (IsAllocationTrackingEnabled()) printf("%-18s %14.1f %12.1f\n", "total", profile.totalLiveBytes / BYTES_PER_MB, profile.peakTotalLiveBytes / BYTES_PER_MB);
+		file << "\n\t]\n}\n";
+		file.close();
+
+		return !file.fail();
+	}
+
+	const char *GetOperationName(OperationID operation)
+	{
+		static const char *OPERATION_NAMES[OPERATION_COUNT] = { "Iterations", "CoverableClientScans", "EligibilityChecks", "MapLookups", "GCandidates" };
+		return OPERATION_NAMES[operation];
+	}
+
+	bool IsOperationCountingEnabled()
+	{
+#ifdef OPERATION_COUNTING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	thread_local unsigned long long operationCountsOfThread[OPERATION_COUNT] = {};
+
+	std::mutex operationCountMutex;
+	map<pair<double, int>, OperationCountsType> operationCountsOfCell;
+
+#ifdef OPERATION_COUNTING
+	thread_local int operationCountScopeDepth = 0;
+
+	OperationCountScopeType::OperationCountScopeType(double givenCapacity, int givenColumn)
+	{
+		this->capacity = givenCapacity;
+		this->column = givenColumn;
+		this->isOutermost = (0 == operationCountScopeDepth++);
+		for (int operation = 0; operation < OPERATION_COUNT; operation++) this->startCounts[operation] = operationCountsOfThread[operation];
+	}
+
+	OperationCountScopeType::~OperationCountScopeType()
+	{
+		operationCountScopeDepth--;
+		if (!isOutermost) return;
+
+		std::lock_guard<std::mutex> lock(operationCountMutex);
+		auto &cell = operationCountsOfCell[make_pair(capacity, column)];
+		cell.runCount++;
+		for (int operation = 0; operation < OPERATION_COUNT; operation++) cell.counts.at(operation) += (double)(operationCountsOfThread[operation] - startCounts[operation]);
+	}
+#endif
+
+	map<pair<double, int>, OperationCountsType> GetOperationCounts()
+	{
+		std::lock_guard<std::mutex> lock(operationCountMutex);
+		return operationCountsOfCell;
+	}
+
+	void ResetOperationCounts()
+	{
+		std::lock_guard<std::mutex> lock(operationCountMutex);
+		operationCountsOfCell.clear();
+	}
+
+	bool WriteOperationCounts(const string &fileNamePrefix, const vector<double> &capacities, const vector<int> &columns, const string &separator)
+	{
+		if (!IsOperationCountingEnabled()) return true;
+
+		auto countsOfCell = GetOperationCounts();
+		bool isWritten = true;
+		for (int operation = 0; operation < OPERATION_COUNT; operation++)
+		{
+			ofstream file(fileNamePrefix + "operation" + GetOperationName(OperationID(operation)) + "Mean.csv");
+			for (auto capacity : capacities)
+			{
+				for (auto column : columns)
+				{
+					auto it = countsOfCell.find(make_pair(capacity, column));
+					file << ((it != countsOfCell.end()) ? it->second.counts.at(operation) / it->second.runCount : 0) << separator;
+				}
+				file << "\n";
+			}
+			file.close();
+			if (file.fail()) isWritten = false;
+		}
+		return isWritten;
+	}
+}
+
+#ifdef MEMORY_PROFILING
+// the global operator new and delete of a MEMORY_PROFILING build: each block starts with a header recording its size and structure, so that its deallocation is counted to the right structure
+// (the default array and nothrow forms call these, but they are replaced as well, for the standard libraries that do not)
+struct alignas(16) AllocationHeaderType
+{
+	size_t size;
+	Instrumentation::MemoryStructureID structure;
+};
+
+static void *AllocateTrackedBlock(size_t size) noexcept
+{
+	auto header = (AllocationHeaderType*)std::malloc(sizeof(AllocationHeaderType) + size);
+	if (nullptr == header) return nullptr;
+	header->size = size;
+	header->structure = Instrumentation::GetCurrentMemoryStructure();
+	Instrumentation::RecordAllocation(size, header->structure);
+	return header + 1;
+}
+
+// gcc may inline the operator delete below into its callers and then see free called on the result of operator new, not knowing that operator new is the malloc above
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static void FreeTrackedBlock(void *memory) noexcept
+{
+	if (nullptr == memory) return;
+	auto header = (AllocationHeaderType*)memory - 1;
+	Instrumentation::RecordDeallocation(header->size, header->structure);
+	std::free(header);
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+void *operator new(size_t size)
+{
+	if (void *memory = AllocateTrackedBlock(size)) return memory;
+	throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+	if (void *memory = AllocateTrackedBlock(size)) return memory;
+	throw std::bad_alloc();
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	return AllocateTrackedBlock(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return AllocateTrackedBlock(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+	FreeTrackedBlock(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+	FreeTrackedBlock(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+	FreeTrackedBlock(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+	FreeTrackedBlock(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+	FreeTrackedBlock(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+	FreeTrackedBlock(memory);
+}
+#endif
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "Base.h"
+
+// wall-clock (steady_clock) timing of the phases of a run, each phase feeding a log-bucketed latency histogram
+// recording a duration is a few relaxed loads and stores into the calling thread's own histograms (no locks, no shared cache lines), so the timing can stay on in production runs
+namespace Instrumentation
+{
+	enum PhaseID
+	{
+		PHASE_LOAD, // Initialize() of a dataset
+		PHASE_MATCHMAKING, // forming one session
+		PHASE_ELIGIBILITY, // eligible dcs of the session's clients for one G datacenter, or the eligible G datacenters of a session (also inside the matchmaking and strategy phases)
+		PHASE_STRATEGY_LB, // one run of a strategy at one G datacenter, in the order of the strategy ids
+		PHASE_STRATEGY_RANDOM,
+		PHASE_STRATEGY_NEAREST,
+		PHASE_STRATEGY_LSP,
+		PHASE_STRATEGY_LBP,
+		PHASE_STRATEGY_LCP,
+		PHASE_STRATEGY_LCW,
+		PHASE_STRATEGY_LAC,
+		PHASE_STRATEGY_OPT,
+		PHASE_LOCAL_SEARCH, // one LS run after a strategy
+		PHASE_VALIDATION, // checking that every client is assigned exactly once
+		PHASE_OUTPUT, // writing the result files
+		PHASE_COUNT
+	};
+
+	// PHASE_STRATEGY_LB for strategy 1, etc.
+	PhaseID GetStrategyPhase(int);
+
+	// e.g. "matchmaking" or "strategy LAC"
+	const char *GetPhaseName(PhaseID);
+
+	// durations (nanoseconds) in buckets of 8 per power of two, so each quantile is within 6.25% of the true value (the count, total and max are exact)
+	struct HistogramType
+	{
+		static const int BUCKET_COUNT = 496; // any duration up to 2^64 ns
+
+		vector<unsigned long long> bucketCounts;
+		unsigned long long count;
+		double totalNanoseconds;
+		unsigned long long maxNanoseconds;
+
+		HistogramType()
+		{
+			this->bucketCounts.assign(BUCKET_COUNT, 0);
+			this->count = 0;
+			this->totalNanoseconds = 0;
+			this->maxNanoseconds = 0;
+		}
+
+		void Merge(const HistogramType &);
+
+		// duration (nanoseconds) at the given quantile (0 to 1): the middle of its bucket, but no more than maxNanoseconds
+		double GetQuantile(double) const;
+	};
+
+	// bucket of a duration (nanoseconds), and the smallest duration of a bucket
+	int GetBucketIndex(unsigned long long);
+	unsigned long long GetBucketLowerBound(int);
+
+	// on by default (a timed phase costs two clock reads, tens of nanoseconds); when off, the timers below do not read the clock
+	void SetPhaseTimingEnabled(bool);
+	bool IsPhaseTimingEnabled();
+
+	// add one duration (nanoseconds) of the given phase to the calling thread's histograms
+	void RecordPhase(PhaseID, unsigned long long);
+
+	// the phase the calling thread is in (PHASE_COUNT if none), to which its allocations are counted (see the memory profile below)
+	PhaseID GetCurrentPhase();
+
+	// make the given phase the calling thread's current one, and return the previous one
+	PhaseID EnterPhase(PhaseID);
+
+	// times its scope (or until Stop) and records it as one duration of the given phase
+	// the phase is also the thread's current one until then (the timing being on or off)
+	struct PhaseTimerType
+	{
+		PhaseID phase;
+		PhaseID previousPhase; // the current phase when the timer started, again after Stop
+		std::chrono::steady_clock::time_point startTime;
+		bool isStopped; // also if the timing was off at the start
+		bool isPhaseLeft;
+
+		explicit PhaseTimerType(PhaseID givenPhase)
+		{
+			this->phase = givenPhase;
+			this->previousPhase = EnterPhase(givenPhase);
+			this->isPhaseLeft = false;
+			this->isStopped = !IsPhaseTimingEnabled();
+			if (!this->isStopped) this->startTime = std::chrono::steady_clock::now();
+		}
+
+		~PhaseTimerType()
+		{
+			Stop();
+		}
+
+		// record the duration so far and leave the phase (only once)
+		void Stop();
+	};
+
+	// the histograms of all threads, per phase (indexed by PhaseID)
+	vector<HistogramType> GetPhaseHistograms();
+
+	// clear the histograms of all threads (call it before a run whose timings are to be written on their own)
+	void ResetPhaseHistograms();
+
+	// one JSON object per phase that has been recorded: {"phases": [{"name": ..., "count": ..., "total_ms": ..., "mean_ms": ..., "p50_ms": ..., "p99_ms": ..., "max_ms": ...}, ...]}
+	// also printed as a table; return false if the file cannot be written
+	bool WritePhaseTimings(const string &);
+
+	// memory profile of a run: heap allocations (operator new) per phase, the live heap bytes of the major structures, and the resident set size of the process
+	// the allocations are only seen in builds with MEMORY_PROFILING defined (e.g. in the project's preprocessor definitions), which replace the global operator new and delete:
+	// each block gets a 16-byte header with its size and structure, and each allocation or deallocation updates a few shared atomic counters, so it is meant for sizing runs, not production ones
+	// (the benchmark counts its allocations with its own operator new, so it is built without MEMORY_PROFILING)
+	// without MEMORY_PROFILING, only the resident set size is reported
+
+	// what an allocation belongs to: the structure of the calling thread's innermost MemoryStructureScopeType when the block was allocated
+	enum MemoryStructureID
+	{
+		STRUCTURE_OTHER, // outside any scope
+		STRUCTURE_TOPOLOGY, // clients and datacenters with their delay maps and eligibility lists (the dataset and each worker's copy of it)
+		STRUCTURE_SESSION, // per-session scratch: the session's clients, the strategies' data, and its results until they are consumed
+		STRUCTURE_RESULTS, // outcome statistics, result cache, raw results, and the results waiting to be consumed in session order
+		STRUCTURE_COUNT
+	};
+
+	// e.g. "topology"
+	const char *GetMemoryStructureName(MemoryStructureID);
+
+	// the calling thread's current structure
+	MemoryStructureID GetCurrentMemoryStructure();
+
+	// makes the given structure the calling thread's current one within its scope
+	struct MemoryStructureScopeType
+	{
+		MemoryStructureID previousStructure;
+
+		explicit MemoryStructureScopeType(MemoryStructureID);
+		~MemoryStructureScopeType();
+		MemoryStructureScopeType(const MemoryStructureScopeType &) = delete;
+		MemoryStructureScopeType &operator=(const MemoryStructureScopeType &) = delete;
+	};
+
+	// true if built with MEMORY_PROFILING
+	bool IsAllocationTrackingEnabled();
+
+	// count an allocation of the given bytes (to the current phase and structure) or the deallocation of a block (to the structure it was allocated in), by the operator new and delete of MEMORY_PROFILING
+	void RecordAllocation(size_t, MemoryStructureID);
+	void RecordDeallocation(size_t, MemoryStructureID);
+
+	// resident set size of the process (bytes), now and at its peak since the process started (0 if not known on this platform)
+	double GetResidentSetBytes();
+	double GetPeakResidentSetBytes();
+
+	struct MemoryProfileType
+	{
+		vector<double> allocationCounts; // per phase (indexed by PhaseID, the last one outside any phase)
+		vector<double> allocatedBytes; // per phase, as allocationCounts
+		vector<double> liveBytes; // per structure (indexed by MemoryStructureID)
+		vector<double> peakLiveBytes; // per structure, each at its own peak
+		double totalLiveBytes;
+		double peakTotalLiveBytes;
+		double residentBytes;
+		double peakResidentBytes;
+
+		MemoryProfileType()
+		{
+			this->allocationCounts.assign(PHASE_COUNT + 1, 0);
+			this->allocatedBytes.assign(PHASE_COUNT + 1, 0);
+			this->liveBytes.assign(STRUCTURE_COUNT, 0);
+			this->peakLiveBytes.assign(STRUCTURE_COUNT, 0);
+			this->totalLiveBytes = 0;
+			this->peakTotalLiveBytes = 0;
+			this->residentBytes = 0;
+			this->peakResidentBytes = 0;
+		}
+	};
+
+	MemoryProfileType GetMemoryProfile();
+
+	// clear the allocation counts and restart the peaks of the live bytes from the current ones (call it before a run whose profile is to be written on its own)
+	// the live bytes themselves are kept, as the blocks are
+	void ResetMemoryProfile();
+
+	// {"allocationTracking": ..., "residentBytes": ..., "peakResidentBytes": ..., "totalLiveBytes": ..., "peakTotalLiveBytes": ..., "phases": [{"name": ..., "allocations": ..., "bytes": ...}, ...], "structures": [{"name": ..., "liveBytes": ..., "peakLiveBytes": ...}, ...]}
+	// also printed as a table; return false if the file cannot be written
+	bool WriteMemoryProfile(const string &);
+
+	// operation counts of the strategies: the work each run does (e.g. LCW and LAC iterations), to relate its running time to the work and check the complexity of new implementations
+	// compiled in only with OPERATION_COUNTING defined (e.g. in the project's preprocessor definitions); otherwise COUNT_OPERATIONS and OperationCountScopeType compile to nothing
+	// with it, counting is an add to the calling thread's own counters, and each strategy run adds its counts to a shared table (under a lock) when it ends
+	enum OperationID
+	{
+		OPERATION_ITERATIONS, // iterations of the main loop of LCW and LAC (one server opened per iteration)
+		OPERATION_COVERABLE_CLIENT_SCANS, // coverable clients visited when LCW and LAC rebuild the unassigned coverable clients of every dc
+		OPERATION_ELIGIBILITY_CHECKS, // (client, dc) delay-bound predicates evaluated by the setup of each G candidate
+		OPERATION_MAP_LOOKUPS, // lookups in the delay maps (by those predicates and by the solution output)
+		OPERATION_G_CANDIDATES, // G datacenters tried by the general drivers
+		OPERATION_COUNT
+	};
+
+	// e.g. "Iterations" (as in the file names)
+	const char *GetOperationName(OperationID);
+
+	// true if built with OPERATION_COUNTING
+	bool IsOperationCountingEnabled();
+
+	// counts so far of the calling thread (indexed by OperationID)
+	extern thread_local unsigned long long operationCountsOfThread[OPERATION_COUNT];
+
+#ifdef OPERATION_COUNTING
+#define COUNT_OPERATIONS(operation, count) (Instrumentation::operationCountsOfThread[Instrumentation::operation] += (unsigned long long)(count))
+#else
+#define COUNT_OPERATIONS(operation, count) ((void)0)
+#endif
+
+	// one strategy run (e.g. one session's LAC at one capacity, over all its G candidates): the calling thread's counts within its scope are added to the given (capacity, column) of the table
+	// column: the strategy id (1: LB, etc.), or the LS column (STRATEGY_COUNT + 1, etc.); a scope inside another one of the same thread (e.g. the basic run at each G candidate of a general run) counts to the outer one
+	struct OperationCountScopeType
+	{
+#ifdef OPERATION_COUNTING
+		double capacity;
+		int column;
+		bool isOutermost;
+		unsigned long long startCounts[OPERATION_COUNT];
+
+		OperationCountScopeType(double, int);
+		~OperationCountScopeType();
+		OperationCountScopeType(const OperationCountScopeType &) = delete;
+		OperationCountScopeType &operator=(const OperationCountScopeType &) = delete;
+#else
+		OperationCountScopeType(double, int) {}
+#endif
+	};
+
+	// counts of the runs of one (capacity, column)
+	struct OperationCountsType
+	{
+		double runCount;
+		vector<double> counts; // indexed by OperationID
+
+		OperationCountsType()
+		{
+			this->runCount = 0;
+			this->counts.assign(OPERATION_COUNT, 0);
+		}
+	};
+
+	// the table, by (capacity, column)
+	map<pair<double, int>, OperationCountsType> GetOperationCounts();
+
+	// clear the table (call it before a run whose counts are to be written on their own)
+	void ResetOperationCounts();
+
+	// one file per operation, fileNamePrefix + "operation" + name + "Mean.csv" (e.g. ..._operationIterationsMean.csv), with the mean count per run in the layout of computationMean.csv: one row per given capacity and one value per given column, each followed by the separator (0 if no run)
+	// nothing is written without OPERATION_COUNTING; return false if a file cannot be written
+	bool WriteOperationCounts(const string &, const vector<double> &, const vector<int> &, const string &);
+}
@@ -1,5 +1,7 @@
-#include "ServerAllocationProblem.h"
-#include "MatchmakingProblem.h"
+#include "ParameterSweep.h"
+#include "TopologyGenerator.h"
+#include "RawResults.h"
+#include "SessionReplay.h"
 
 int main(int argc, char *argv[])
 {
@@ -18,17 +20,61 @@ int main(int argc, char *argv[])
 	}
 	}*/
 
-	/*ServerAllocationProblem*/
-	/*ServerAllocationProblem::SimulateBasicProblem(75, 50, 10);
-	ServerAllocationProblem::SimulateBasicProblem(75, 50, 50);
-	ServerAllocationProblem::SimulateBasicProblem(150, 100, 10);
-	ServerAllocationProblem::SimulateBasicProblem(150, 100, 50);*/
+	/*parameter sweep: every combination of the values below is one cell, all cells run in this process on a work-stealing pool*/
+	ParameterSweep::SweepGridType grid;
+
+	/*ServerAllocationProblem: the sharded experiments (below) run each problem at each (delay bounds, session size), while the sweep also needs the capacities and the strategies*/
+	grid.delayBounds = { { 75, 50 }, { 150, 100 } };
+	grid.sessionSizes = { 10, 20, 30, 40, 50 };
+	grid.problems = { ParameterSweep::BASIC_PROBLEM, ParameterSweep::GENERAL_PROBLEM };
+	/*grid.serverCapacities = { 2, 4, 6, 8 };
+	grid.strategyIDs = { 1, 2, 3, 4, 5, 6, 7, 8 };*/
 
 	/*MatchmakingProblem*/
-	auto simulator = MatchmakingProblem::MaximumMatchingProblem();	
-	for (int clientCount : { 25, 50, 100, 200, 400, 800 })
-		for (int latencyThreshold : { 25, 50, 100 })
-			simulator.Simulate(clientCount, latencyThreshold);
+	grid.clientCounts = { 25, 50, 100, 200, 400, 800 };
+	grid.latencyThresholds = { 25, 50, 100 };
+
+	/*sharded over several processes (on this or other machines): "shard <index> <count>" runs one shard of the experiments, "merge <count>" combines what the shards have written so far*/
+	if (argc >= 4 && string(argv[1]) == "shard")
+		return ParameterSweep::RunShard(grid, std::stoi(argv[2]), std::stoi(argv[3])) ? 0 : 1;
+	if (argc >= 3 && string(argv[1]) == "merge")
+		return ParameterSweep::MergeShards(grid, std::stoi(argv[2])) ? 0 : 1;
+
+	/*"benchmark": time the strategies with and without the compile-time capacities*/
+	if (argc >= 2 && string(argv[1]) == "benchmark")
+	{
+		ServerAllocationProblem::BenchmarkCapacitySpecialization(75, 50, 10);
+		return 0;
+	}
+
+	/*"generate <directory> <clientCount> <datacenterCount> [seed] [triangleInequalityViolationRatio]": write a synthetic dataset (see TopologyGenerator.h) to run the experiments on a larger topology*/
+	if (argc >= 5 && string(argv[1]) == "generate")
+	{
+		TopologyGenerator::TopologySettingType setting;
+		setting.clientCount = std::stoi(argv[3]);
+		setting.datacenterCount = std::stoi(argv[4]);
+		if (argc >= 6) setting.seed = std::stoull(argv[5]);
+		if (argc >= 7) setting.triangleInequalityViolationRatio = std::stod(argv[6]);
+		return TopologyGenerator::GenerateTopology(setting, argv[2]) ? 0 : 1;
+	}
+
+	/*"aggregate <rawResultsFile> <dataDirectory>": write the mean and std files of a simulation again from its raw results (see RawResults.h), without rerunning it*/
+	if (argc >= 4 && string(argv[1]) == "aggregate")
+		return RawResults::WriteAggregatedData(argv[2], argv[3]) ? 0 : 1;
+
+	/*"record <dataDirectory> <traceFile> <G> <R> <sessionSize> [sessionCount] [sessionsPerSecond]": write the sessions of the basic problem's simulation as a session trace (see SessionReplay.h)*/
+	if (argc >= 7 && string(argv[1]) == "record")
+		return SessionReplay::RecordSyntheticTrace(argv[2], argv[3], std::stod(argv[4]), std::stod(argv[5]), std::stod(argv[6]), (argc >= 8) ? std::stod(argv[7]) : 1000, (argc >= 9) ? std::stod(argv[8]) : 10) ? 0 : 1;
+
+	/*"replay <traceFile> <dataDirectory> <strategyID> [speed] [sessionCount]": feed the sessions of a trace (e.g. converted from the matchmaking logs) through one strategy, at full speed (0) or at the given multiple of the trace's rate*/
+	if (argc >= 5 && string(argv[1]) == "replay")
+	{
+		SessionReplay::ReplaySettingType replaySetting(std::stoi(argv[4]), (argc >= 6) ? std::stod(argv[5]) : 0, (argc >= 7) ? std::stod(argv[6]) : 0);
+		SessionReplay::ReplayStatisticsType replayStatistics;
+		return SessionReplay::ReplayTrace(argv[2], argv[3], replaySetting, replayStatistics) ? 0 : 1;
+	}
+
+	ParameterSweep::RunSweep(grid);
 
 	return 0;
 }
\ No newline at end of file
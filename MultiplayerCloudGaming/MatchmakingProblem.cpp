@@ -4,6 +4,9 @@ namespace MatchmakingProblem
 {
 	void MatchmakingProblemBase::Initialize(const string given_dataDirectory)
 	{
+		Instrumentation::PhaseTimerType timer(Instrumentation::PHASE_LOAD);
+		Instrumentation::MemoryStructureScopeType memoryScope(Instrumentation::STRUCTURE_TOPOLOGY);
+
 		string ClientDatacenterLatencyFile = "dc_to_pl_rtt.csv";
 		string InterDatacenterLatencyFile = "dc_to_dc_rtt.csv";
 		string BandwidthServerPricingFile = "dc_pricing_bandwidth_server.csv";
@@ -129,28 +132,32 @@ namespace MatchmakingProblem
 		/*initialize global stuff*/
 		Initialize();
 
-		/*random number seed*/
-		std::srand(2);
-		//std::srand(time(NULL));
+		printf("average succesRate = %.2f\n", GetAverageSuccessRate(clientCount, latencyThreshold, sessionSize, simulationCount));
+	}
 
+	double MaximumMatchingProblem::GetAverageSuccessRate(const int clientCount, const int latencyThreshold, const int sessionSize, const int simulationCount)
+	{
 		/*stuff to record performance*/
 		vector<double> successRate;
 
 		/*run simulation round by round*/
 		for (int round = 1; round <= simulationCount; round++)
 		{	
+			Instrumentation::PhaseTimerType timer(Instrumentation::PHASE_MATCHMAKING); // one round
+
 			/*generate a set of random candidateClients according to the clientCount parameters*/
+			CounterRandomType random(MATCHMAKING_RANDOM_SEED, round, RANDOM_PURPOSE_CANDIDATE_CLIENTS); // each round is reproducible on its own
 			auto globalClientListCopy = globalClientList; // avoid modifying the original globalClientList	 
 			if (clientCount <= globalClientList.size())
 			{
-				random_shuffle(globalClientListCopy.begin(), globalClientListCopy.end());
+				Shuffle(globalClientListCopy.begin(), globalClientListCopy.end(), random);
 				candidateClients.assign(globalClientListCopy.begin(), globalClientListCopy.begin() + clientCount);
 			}
 			else // in case if the clientCount is greater than the total number of clients loaded from the dataset
 			{
 				while (candidateClients.size() < clientCount)
 				{
-					random_shuffle(globalClientListCopy.begin(), globalClientListCopy.end());
+					Shuffle(globalClientListCopy.begin(), globalClientListCopy.end(), random);
 					for (auto& client : globalClientList)
 					{
 						candidateClients.push_back(client);
@@ -187,7 +194,7 @@ namespace MatchmakingProblem
 			//printf("totalGroupedClients = %d vs totalEligibleClients = %d -> %.2f grouping rate\n", (int)totalGroupedClients, (int)totalEligibleClients, totalGroupedClients / totalEligibleClients);
 			//printf("grouping success rate = %.2f\n", totalGroupedClients / totalEligibleClients);
 		}
-		printf("average succesRate = %.2f\n", GetMeanValue(successRate));
+		return GetMeanValue(successRate);
 	}
 
 	void MaximumMatchingProblem::NearestAssignmentGrouping()
@@ -1,9 +1,14 @@
 #pragma once
 
 #include "Base.h"
+#include "Random.h"
+#include "Instrumentation.h"
 
 namespace MatchmakingProblem
 {	
+	// seed of the random streams of the simulation rounds
+	const unsigned long long MATCHMAKING_RANDOM_SEED = 2;
+
 	struct ClientType;
 	struct DatacenterType;
 	
@@ -39,17 +44,20 @@ namespace MatchmakingProblem
 	
 	class MatchmakingProblemBase
 	{			
+	public:
+		void Initialize(const string givenDataDirectory = ".\\Data\\");
+		string GetDataDirectory() const { return dataDirectory; }
 	protected:		
 		string dataDirectory; // root path for input and output
 		vector<ClientType> globalClientList; // read from input
 		vector<DatacenterType> globalDatacenterList; // read from input
-		void Initialize(const string givenDataDirectory = ".\\Data\\");
 	};
 
 	class MaximumMatchingProblem : public MatchmakingProblemBase
 	{
 	public:
 		void Simulate(const int clientCount = 100, const int latencyThreshold = 100, const int sessionSize = 10, const int simulationCount = 1000);
+		double GetAverageSuccessRate(const int clientCount, const int latencyThreshold, const int sessionSize, const int simulationCount); // on the data already loaded by Initialize()
 	private:
 		vector<ClientType> candidateClients;
 		vector<DatacenterType> candidateDatacenters;
@@ -1,30 +1,11 @@
-MultiplayerCloudGaming.exe 75 50 10 2
-REM MultiplayerCloudGaming.exe 75 50 20 2
-REM MultiplayerCloudGaming.exe 75 50 30 2
-REM MultiplayerCloudGaming.exe 75 50 40 2
-REM MultiplayerCloudGaming.exe 75 50 50 2
-REM MultiplayerCloudGaming.exe 150 100 10 2
-REM MultiplayerCloudGaming.exe 150 100 20 2
-REM MultiplayerCloudGaming.exe 150 100 30 2
-REM MultiplayerCloudGaming.exe 150 100 40 2
-REM MultiplayerCloudGaming.exe 150 100 50 2
-REM MultiplayerCloudGaming.exe 75 50 10 4
-REM MultiplayerCloudGaming.exe 75 50 20 4
-REM MultiplayerCloudGaming.exe 75 50 30 4
-REM MultiplayerCloudGaming.exe 75 50 40 4
-REM MultiplayerCloudGaming.exe 75 50 50 4
-REM MultiplayerCloudGaming.exe 150 100 10 4
-REM MultiplayerCloudGaming.exe 150 100 20 4
-REM MultiplayerCloudGaming.exe 150 100 30 4
-REM MultiplayerCloudGaming.exe 150 100 40 4
-REM MultiplayerCloudGaming.exe 150 100 50 4
-REM MultiplayerCloudGaming.exe 75 50 10 6
-REM MultiplayerCloudGaming.exe 75 50 20 6
-REM MultiplayerCloudGaming.exe 75 50 30 6
-REM MultiplayerCloudGaming.exe 75 50 40 6
-REM MultiplayerCloudGaming.exe 75 50 50 6
-REM MultiplayerCloudGaming.exe 150 100 10 6
-REM MultiplayerCloudGaming.exe 150 100 20 6
-REM MultiplayerCloudGaming.exe 150 100 30 6
-REM MultiplayerCloudGaming.exe 150 100 40 6
-REM MultiplayerCloudGaming.exe 150 100 50 6
\ No newline at end of file
+REM the parameter grid (delay bounds, session sizes, capacities, strategies, client counts and latency thresholds) is declared in Main.cpp and swept in one process
+MultiplayerCloudGaming.exe
+REM or sharded: one process per shard (each machine needs the executable and the Data folder, and sends back its Output\shard_*_of_*.csv files), then merge (also while shards are still running)
+REM START MultiplayerCloudGaming.exe shard 0 4
+REM START MultiplayerCloudGaming.exe shard 1 4
+REM START MultiplayerCloudGaming.exe shard 2 4
+REM START MultiplayerCloudGaming.exe shard 3 4
+REM MultiplayerCloudGaming.exe merge 4
+REM MultiplayerCloudGaming.exe benchmark (strategies with and without the compile-time capacities, see BenchmarkCapacitySpecialization)
+REM MultiplayerCloudGamingBenchmark.exe -baseline <an earlier microbenchmark.csv> (microbenchmarks of the strategies and the matchmaking, see Benchmark.h; exit code 1 if any case regressed; add -counters 1 for the Linux hardware counters per op)
+REM MultiplayerCloudGaming.exe generate .\Synthetic\ 1000000 300 1 0.1 (a synthetic dataset of 1000000 clients and 300 dcs, see TopologyGenerator.h; copy it into Data to run on it)
\ No newline at end of file
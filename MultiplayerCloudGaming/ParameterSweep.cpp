@@ -0,0 +1,581 @@
+#include "ParameterSweep.h"
+
+namespace ParameterSweep
+{
+	vector<SweepCellType> GetCellsOfGrid(const SweepGridType &grid)
+	{
+		vector<SweepCellType> cells;
+
+		for (auto &bounds : grid.delayBounds)
+		{
+			for (auto SESSION_SIZE : grid.sessionSizes)
+			{
+				for (auto serverCapacity : grid.serverCapacities)
+				{
+					for (auto strategyID : grid.strategyIDs)
+					{
+						SweepCellType cell = SweepCellType();
+						cell.isServerAllocation = true;
+						cell.DELAY_BOUND_TO_G = bounds.first;
+						cell.DELAY_BOUND_TO_R = bounds.second;
+						cell.SESSION_SIZE = SESSION_SIZE;
+						cell.serverCapacity = serverCapacity;
+						cell.strategyID = strategyID;
+						// each session runs matchmaking, the LB and the strategy, where OPT's search grows much faster with the session size than the heuristics
+						cell.estimatedCost = grid.sessionCount * SESSION_SIZE * (2 + (ServerAllocationProblem::STRATEGY_OPT == strategyID ? 5 * SESSION_SIZE : 1));
+						cells.push_back(cell);
+					}
+				}
+			}
+		}
+
+		for (auto clientCount : grid.clientCounts)
+		{
+			for (auto latencyThreshold : grid.latencyThresholds)
+			{
+				SweepCellType cell = SweepCellType();
+				cell.isServerAllocation = false;
+				cell.clientCount = clientCount;
+				cell.latencyThreshold = latencyThreshold;
+				cell.estimatedCost = (double)grid.simulationCount * clientCount; // each round finds the nearest eligible dc of each client
+				cells.push_back(cell);
+			}
+		}
+
+		return cells;
+	}
+
+	bool RunSweep(const SweepGridType &grid)
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		Instrumentation::ResetPhaseHistograms(); // the phase timings of this sweep only
+		Instrumentation::ResetMemoryProfile(); // and its allocations
+
+		auto cells = GetCellsOfGrid(grid);
+		bool hasServerAllocation = false, hasMatchmaking = false;
+		for (auto &cell : cells)
+		{
+			if (cell.isServerAllocation) hasServerAllocation = true;
+			else hasMatchmaking = true;
+		}
+
+		// each dataset is loaded once and copied by the cells that use it
+		string serverAllocationDirectory = ".\\Data\\ProblemBasic\\";
+		vector<ServerAllocationProblem::ClientType*> allClients;
+		vector<ServerAllocationProblem::DatacenterType*> allDatacenters;
+		ofstream serverAllocationFile;
+		if (hasServerAllocation)
+		{
+			if (!ServerAllocationProblem::Initialize(serverAllocationDirectory, allClients, allDatacenters))
+			{
+				printf("ERROR: simulation initialization failed!\n");
+				cin.get();
+				return false;
+			}
+			serverAllocationFile.open(serverAllocationDirectory + "Output\\" + "sweep.csv");
+			serverAllocationFile << "G,R,sessionSize,capacity,strategy,costTotalMean,costTotalStd,capacityWastageMean,capacityWastageStd,averageDelayMean,averageDelayStd,computationMean\n";
+			serverAllocationFile.flush();
+		}
+
+		MatchmakingProblem::MaximumMatchingProblem matchmakingPrototype;
+		ofstream matchmakingFile;
+		if (hasMatchmaking)
+		{
+			matchmakingPrototype.Initialize();
+			_mkdir((matchmakingPrototype.GetDataDirectory() + "Output").c_str());
+			matchmakingFile.open(matchmakingPrototype.GetDataDirectory() + "Output\\" + "matchmakingSweep.csv");
+			matchmakingFile << "clientCount,latencyThreshold,sessionSize,successRate\n";
+			matchmakingFile.flush();
+		}
+
+		std::mutex outputMutex;
+		std::atomic<bool> isFailed(false);
+		std::atomic<int> finishedCellCount(0);
+
+		auto RunServerAllocationCell = [&](const SweepCellType &cell)
+		{
+			Instrumentation::MemoryStructureScopeType topologyScope(Instrumentation::STRUCTURE_TOPOLOGY);
+			ServerAllocationProblem::WorkspaceType workspace(allClients, allDatacenters);
+			StatisticsAccumulatorType costTotal, capacityWastage, averageDelay, computation;
+
+			for (int sessionID = 1; sessionID <= grid.sessionCount; sessionID++)
+			{
+				ServerAllocationProblem::SessionRandomnessType randomness(sessionID); // the same sessions as SimulateBasicProblem
+				Instrumentation::MemoryStructureScopeType sessionScope(Instrumentation::STRUCTURE_SESSION);
+				vector<ServerAllocationProblem::ClientType*> sessionClients;
+				int GDatacenterID;
+				if (!ServerAllocationProblem::Matchmaking4BasicProblem(workspace.datacenters, workspace.clients, GDatacenterID, sessionClients, cell.SESSION_SIZE, cell.DELAY_BOUND_TO_G, cell.DELAY_BOUND_TO_R))
+				{
+					printf("ERROR: infeasible session\n");
+					return false;
+				}
+
+				double costLB = get<0>(ServerAllocationProblem::RunStrategy4BasicProblem(1, sessionClients, workspace.datacenters, cell.serverCapacity, GDatacenterID));
+
+				auto timePoint = std::chrono::steady_clock::now();
+				auto outcome = ServerAllocationProblem::RunStrategy4BasicProblem(cell.strategyID, sessionClients, workspace.datacenters, cell.serverCapacity, GDatacenterID);
+				computation.Add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count());
+				if (!ServerAllocationProblem::CheckIfAllClientsExactlyAssigned(sessionClients, workspace.datacenters))
+				{
+					printf("Something wrong with client-to-datacenter assignment!\n");
+					return false;
+				}
+
+				costTotal.Add(get<0>(outcome) / costLB);
+				capacityWastage.Add(get<3>(outcome));
+				averageDelay.Add(get<4>(outcome));
+			}
+
+			std::lock_guard<std::mutex> lock(outputMutex);
+			serverAllocationFile << cell.DELAY_BOUND_TO_G << "," << cell.DELAY_BOUND_TO_R << "," << cell.SESSION_SIZE << "," << cell.serverCapacity << "," << cell.strategyID << ","
+				<< costTotal.GetMean() << "," << costTotal.GetStd() << ","
+				<< capacityWastage.GetMean() << "," << capacityWastage.GetStd() << ","
+				<< averageDelay.GetMean() << "," << averageDelay.GetStd() << ","
+				<< computation.GetMean() << "\n";
+			serverAllocationFile.flush();
+			printf("[%d/%d] delay bounds: (%d, %d) session size: %d capacity: %d strategy: %d -> cost (normalized by LB) = %.4f\n", ++finishedCellCount, (int)cells.size(),
+				(int)cell.DELAY_BOUND_TO_G, (int)cell.DELAY_BOUND_TO_R, (int)cell.SESSION_SIZE, (int)cell.serverCapacity, cell.strategyID, costTotal.GetMean());
+			return true;
+		};
+
+		auto RunMatchmakingCell = [&](const SweepCellType &cell)
+		{
+			auto simulator = matchmakingPrototype; // its own copy of the loaded data
+			double successRate = simulator.GetAverageSuccessRate(cell.clientCount, cell.latencyThreshold, grid.matchmakingSessionSize, grid.simulationCount);
+
+			std::lock_guard<std::mutex> lock(outputMutex);
+			matchmakingFile << cell.clientCount << "," << cell.latencyThreshold << "," << grid.matchmakingSessionSize << "," << successRate << "\n";
+			matchmakingFile.flush();
+			printf("[%d/%d] latencyThreshold = %d | clientCount = %d | average succesRate = %.2f\n", ++finishedCellCount, (int)cells.size(),
+				cell.latencyThreshold, cell.clientCount, successRate);
+			return true;
+		};
+
+		vector<double> cellCosts;
+		for (auto &cell : cells) cellCosts.push_back(cell.estimatedCost);
+
+		int threadCount = grid.threadCount > 0 ? grid.threadCount : (int)std::thread::hardware_concurrency();
+		RunTasksWithWorkStealing(cellCosts, threadCount, [&](int cellIndex)
+		{
+			if (isFailed) return; // skip the remaining cells
+			const auto &cell = cells.at(cellIndex);
+			if (!(cell.isServerAllocation ? RunServerAllocationCell(cell) : RunMatchmakingCell(cell))) isFailed = true;
+		});
+
+		for (auto client : allClients) delete client;
+		for (auto dc : allDatacenters) delete dc;
+
+		printf("------------------------------------------------------------------------\n");
+		Instrumentation::WritePhaseTimings((hasServerAllocation ? serverAllocationDirectory : matchmakingPrototype.GetDataDirectory()) + "Output\\" + "sweepPhaseTiming.json");
+		Instrumentation::WriteMemoryProfile((hasServerAllocation ? serverAllocationDirectory : matchmakingPrototype.GetDataDirectory()) + "Output\\" + "sweepMemoryProfile.json");
+		printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+		if (isFailed)
+		{
+			cin.get();
+			return false;
+		}
+		return true;
+	}
+
+	vector<ShardUnitType> GetShardUnits(const SweepGridType &grid)
+	{
+		vector<ShardUnitType> units;
+		int blockSize = std::max(1, grid.sessionBlockSize);
+
+		for (auto problem : grid.problems)
+		{
+			for (auto &bounds : grid.delayBounds)
+			{
+				for (auto SESSION_SIZE : grid.sessionSizes)
+				{
+					for (int firstSessionID = 1; firstSessionID <= grid.sessionCount; firstSessionID += blockSize)
+					{
+						ShardUnitType unit;
+						unit.problem = problem;
+						unit.DELAY_BOUND_TO_G = bounds.first;
+						unit.DELAY_BOUND_TO_R = bounds.second;
+						unit.SESSION_SIZE = SESSION_SIZE;
+						unit.firstSessionID = firstSessionID;
+						unit.lastSessionID = std::min(firstSessionID + blockSize - 1, (int)grid.sessionCount);
+						units.push_back(unit);
+					}
+				}
+			}
+		}
+
+		return units;
+	}
+
+	int GetShardOfUnit(const ShardUnitType &unit, int shardCount)
+	{
+		unsigned long long hash = MixBits64((unsigned long long)unit.problem + SPLITMIX64_GAMMA);
+		for (double value : { unit.DELAY_BOUND_TO_G, unit.DELAY_BOUND_TO_R, unit.SESSION_SIZE, (double)unit.firstSessionID, (double)unit.lastSessionID })
+		{
+			hash = MixBits64(hash ^ ((unsigned long long)std::llround(value * 1000) + SPLITMIX64_GAMMA)); // not the bits of the double, which may differ between compilers for the same grid value
+		}
+		return (int)(hash % (unsigned long long)shardCount);
+	}
+
+	// capacities of the sharded experiments (as in SimulateBasicProblem and SimulateGeneralProblem)
+	const vector<double> SHARD_SERVER_CAPACITY_LIST = { 2, 4, 6, 8 };
+
+	// columns of the LCP, LCW and LAC whose server counts at capacity 8 are summed into serverCountPerDC (as in SimulateGeneralProblem)
+	const vector<int> SERVER_COUNT_COLUMNS = ServerAllocationProblem::GetServerCountColumns();
+
+	string GetDataDirectoryOfProblem(ProblemType problem)
+	{
+		return (BASIC_PROBLEM == problem) ? ".\\Data\\ProblemBasic\\" : ".\\Data\\ProblemGeneral\\";
+	}
+
+	string GetShardFileName(ProblemType problem, int shardIndex, int shardCount)
+	{
+		return GetDataDirectoryOfProblem(problem) + "Output\\" + "shard_" + std::to_string(shardIndex) + "_of_" + std::to_string(shardCount) + ".csv";
+	}
+
+	// a quantile sketch as fields of a shard's line: firstBucketIndex, zeroCount, count, sum, minValue, maxValue, the number of buckets and their counts
+	void WriteSketch(const QuantileSketchType &sketch, ostringstream &line)
+	{
+		line << "," << sketch.firstBucketIndex << "," << sketch.zeroCount << "," << sketch.count << "," << sketch.sum << "," << sketch.minValue << "," << sketch.maxValue << "," << sketch.bucketCounts.size();
+		for (auto bucketCount : sketch.bucketCounts) line << "," << bucketCount;
+	}
+
+	// the sketch written by WriteSketch from fields[k], and k moved past it
+	// return false if the fields end before the sketch does
+	bool ReadSketch(const vector<double> &fields, size_t &k, QuantileSketchType &sketch)
+	{
+		if (k + 7 > fields.size()) return false;
+		sketch.firstBucketIndex = (int)fields.at(k);
+		sketch.zeroCount = fields.at(k + 1);
+		sketch.count = fields.at(k + 2);
+		sketch.sum = fields.at(k + 3);
+		sketch.minValue = fields.at(k + 4);
+		sketch.maxValue = fields.at(k + 5);
+		size_t bucketCount = (size_t)fields.at(k + 6);
+		k += 7;
+		if (k + bucketCount > fields.size()) return false;
+		sketch.bucketCounts.assign(fields.begin() + k, fields.begin() + k + bucketCount);
+		k += bucketCount;
+		return true;
+	}
+
+	// one session of a sharded experiment as one line: G, R, size, session, then (costTotal, costServer, costBandwidth, capacityWastage, averageDelay, computation) of each [capacity][column],
+	// then (general problem only) the number of dcs and the server counts of each SERVER_COUNT_COLUMNS at capacity 8 per dc,
+	// then unprovenOptimal of each capacity, then the sketches (see WriteSketch) of the clientDelay and the serverUtilization of each [capacity][column]
+	bool RunShardSession(const ShardUnitType &unit, int sessionID, const ServerAllocationProblem::OptimalSettingType &optimalSetting, ServerAllocationProblem::WorkspaceType &workspace, ostringstream &line)
+	{
+		ServerAllocationProblem::SessionRandomnessType randomness(sessionID); // the same session as in a single run
+		vector<ServerAllocationProblem::ClientType*> sessionClients;
+		ServerAllocationProblem::SessionResultType result;
+
+		bool isValidSession;
+		if (BASIC_PROBLEM == unit.problem)
+		{
+			isValidSession = ServerAllocationProblem::Matchmaking4BasicProblem(workspace.datacenters, workspace.clients, result.GDatacenterID, sessionClients, unit.SESSION_SIZE, unit.DELAY_BOUND_TO_G, unit.DELAY_BOUND_TO_R)
+				&& ServerAllocationProblem::EvaluateStrategies4BasicProblem(sessionClients, workspace.datacenters, SHARD_SERVER_CAPACITY_LIST, result.GDatacenterID, result.outcome, result.computation, result.clientDelay, result.serverUtilization, result.unprovenOptimal,
+					ServerAllocationProblem::LocalSearchSettingType(), optimalSetting);
+		}
+		else
+		{
+			vector<ServerAllocationProblem::DatacenterType*> eligibleGDatacenters;
+			isValidSession = ServerAllocationProblem::Matchmaking4GeneralProblem(workspace.datacenters, workspace.clients, sessionClients, eligibleGDatacenters, unit.SESSION_SIZE, unit.DELAY_BOUND_TO_G, unit.DELAY_BOUND_TO_R)
+				&& ServerAllocationProblem::EvaluateStrategies4GeneralProblem(eligibleGDatacenters, sessionClients, workspace.datacenters, unit.DELAY_BOUND_TO_G, unit.DELAY_BOUND_TO_R, SHARD_SERVER_CAPACITY_LIST,
+					result.outcome, result.computation, result.finalGDatacenter, result.serverCountPerDC, result.clientDelay, result.serverUtilization, result.unprovenOptimal,
+					ServerAllocationProblem::LocalSearchSettingType(), 0, optimalSetting);
+		}
+		if (!isValidSession) return false;
+
+		line.precision(17); // exact round trip of the doubles
+		line << unit.DELAY_BOUND_TO_G << "," << unit.DELAY_BOUND_TO_R << "," << unit.SESSION_SIZE << "," << sessionID;
+		for (size_t j = 0; j < result.outcome.size(); j++)
+		{
+			for (size_t i = 0; i < result.outcome.at(j).size(); i++)
+			{
+				auto &outcome = result.outcome.at(j).at(i);
+				line << "," << get<0>(outcome) << "," << get<1>(outcome) << "," << get<2>(outcome) << "," << get<3>(outcome) << "," << get<4>(outcome) << "," << result.computation.at(j).at(i);
+			}
+		}
+		if (GENERAL_PROBLEM == unit.problem)
+		{
+			line << "," << workspace.datacenters.size();
+			size_t j = std::find(SHARD_SERVER_CAPACITY_LIST.begin(), SHARD_SERVER_CAPACITY_LIST.end(), 8) - SHARD_SERVER_CAPACITY_LIST.begin();
+			for (auto column : SERVER_COUNT_COLUMNS)
+			{
+				for (auto count : result.serverCountPerDC.at(j).at(column)) line << "," << count;
+			}
+		}
+		for (size_t j = 0; j < SHARD_SERVER_CAPACITY_LIST.size(); j++)
+		{
+			line << "," << (j < result.unprovenOptimal.size() ? result.unprovenOptimal.at(j) : 0);
+		}
+		for (size_t j = 0; j < result.clientDelay.size(); j++)
+		{
+			for (size_t i = 0; i < result.clientDelay.at(j).size(); i++)
+			{
+				QuantileSketchType clientDelay, serverUtilization;
+				for (auto delay : result.clientDelay.at(j).at(i)) clientDelay.Add(delay);
+				for (auto utilization : result.serverUtilization.at(j).at(i)) serverUtilization.Add(utilization);
+				WriteSketch(clientDelay, line);
+				WriteSketch(serverUtilization, line);
+			}
+		}
+		line << "\n";
+		return true;
+	}
+
+	// one session read back from a shard's line (see RunShardSession)
+	struct ShardSessionType
+	{
+		vector<vector<tuple<double, double, double, double, double>>> outcome; // indexed by [capacity][column]
+		vector<vector<double>> computation; // indexed by [capacity][column]
+		vector<vector<double>> serverCountPerDC; // indexed by [SERVER_COUNT_COLUMNS][dc's id] (for general problem)
+		vector<int> unprovenOptimal; // per capacity
+		vector<vector<QuantileSketchType>> clientDelay; // indexed by [capacity][column]
+		vector<vector<QuantileSketchType>> serverUtilization; // indexed by [capacity][column]
+	};
+
+	// the session of a shard's line (without its first four fields: G, R, size and session)
+	// return false if the line does not have the fields of a session of the given problem with COLUMN_COUNT columns
+	bool ParseShardSession(const vector<double> &fields, ProblemType problem, int COLUMN_COUNT, ShardSessionType &session)
+	{
+		const size_t capacityCount = SHARD_SERVER_CAPACITY_LIST.size();
+		size_t k = 4;
+		if (k + capacityCount * COLUMN_COUNT * 6 > fields.size()) return false;
+		session.outcome.assign(capacityCount, vector<tuple<double, double, double, double, double>>());
+		session.computation.assign(capacityCount, vector<double>());
+		for (size_t j = 0; j < capacityCount; j++)
+		{
+			for (int i = 0; i < COLUMN_COUNT; i++, k += 6)
+			{
+				session.outcome.at(j).push_back(make_tuple(fields.at(k), fields.at(k + 1), fields.at(k + 2), fields.at(k + 3), fields.at(k + 4)));
+				session.computation.at(j).push_back(fields.at(k + 5));
+			}
+		}
+
+		session.serverCountPerDC.clear();
+		if (GENERAL_PROBLEM == problem)
+		{
+			if (k >= fields.size()) return false;
+			size_t dcCount = (size_t)fields.at(k++);
+			if (0 == dcCount || k + SERVER_COUNT_COLUMNS.size() * dcCount > fields.size()) return false;
+			for (size_t c = 0; c < SERVER_COUNT_COLUMNS.size(); c++, k += dcCount)
+			{
+				session.serverCountPerDC.push_back(vector<double>(fields.begin() + k, fields.begin() + k + dcCount));
+			}
+		}
+
+		if (k + capacityCount > fields.size()) return false;
+		session.unprovenOptimal.clear();
+		for (size_t j = 0; j < capacityCount; j++, k++) session.unprovenOptimal.push_back((int)fields.at(k));
+
+		session.clientDelay.assign(capacityCount, vector<QuantileSketchType>(COLUMN_COUNT));
+		session.serverUtilization = session.clientDelay;
+		for (size_t j = 0; j < capacityCount; j++)
+		{
+			for (int i = 0; i < COLUMN_COUNT; i++)
+			{
+				if (!ReadSketch(fields, k, session.clientDelay.at(j).at(i)) || !ReadSketch(fields, k, session.serverUtilization.at(j).at(i))) return false;
+			}
+		}
+		return k == fields.size();
+	}
+
+	bool RunShard(const SweepGridType &grid, int shardIndex, int shardCount)
+	{
+		auto t0 = std::chrono::steady_clock::now();
+		Instrumentation::ResetPhaseHistograms(); // the phase timings of this shard only
+		Instrumentation::ResetMemoryProfile(); // and its allocations
+
+		if (shardCount <= 0 || shardIndex < 0 || shardIndex >= shardCount)
+		{
+			printf("ERROR: invalid shard %d of %d\n", shardIndex, shardCount);
+			cin.get();
+			return false;
+		}
+		if (GetShardUnits(grid).empty())
+		{
+			printf("ERROR: no sharded experiments in the grid (set its problems, delayBounds and sessionSizes)\n");
+			cin.get();
+			return false;
+		}
+
+		vector<ShardUnitType> units;
+		for (auto &unit : GetShardUnits(grid))
+		{
+			if (GetShardOfUnit(unit, shardCount) == shardIndex) units.push_back(unit);
+		}
+
+		// each problem's dataset is loaded once
+		map<ProblemType, vector<ServerAllocationProblem::ClientType*>> allClients;
+		map<ProblemType, vector<ServerAllocationProblem::DatacenterType*>> allDatacenters;
+		map<ProblemType, ofstream> shardFiles;
+		for (auto &unit : units)
+		{
+			if (allClients.count(unit.problem) > 0) continue;
+			if (!ServerAllocationProblem::Initialize(GetDataDirectoryOfProblem(unit.problem), allClients[unit.problem], allDatacenters[unit.problem]))
+			{
+				printf("ERROR: simulation initialization failed!\n");
+				cin.get();
+				return false;
+			}
+			shardFiles[unit.problem].open(GetShardFileName(unit.problem, shardIndex, shardCount));
+		}
+
+		std::mutex outputMutex;
+		std::atomic<bool> isFailed(false);
+		std::atomic<int> finishedUnitCount(0);
+
+		vector<double> unitCosts;
+		for (auto &unit : units) unitCosts.push_back((unit.lastSessionID - unit.firstSessionID + 1) * unit.SESSION_SIZE);
+
+		int threadCount = grid.threadCount > 0 ? grid.threadCount : (int)std::thread::hardware_concurrency();
+		RunTasksWithWorkStealing(unitCosts, threadCount, [&](int unitIndex)
+		{
+			if (isFailed) return; // skip the remaining units
+			const auto &unit = units.at(unitIndex);
+
+			Instrumentation::MemoryStructureScopeType topologyScope(Instrumentation::STRUCTURE_TOPOLOGY);
+			ServerAllocationProblem::WorkspaceType workspace(allClients.at(unit.problem), allDatacenters.at(unit.problem));
+			ostringstream lines;
+			for (int sessionID = unit.firstSessionID; sessionID <= unit.lastSessionID; sessionID++)
+			{
+				Instrumentation::MemoryStructureScopeType sessionScope(Instrumentation::STRUCTURE_SESSION);
+				if (!RunShardSession(unit, sessionID, grid.optimalSetting, workspace, lines))
+				{
+					printf("ERROR: infeasible session or invalid assignment\n");
+					isFailed = true;
+					return;
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(outputMutex);
+			shardFiles.at(unit.problem) << lines.str();
+			shardFiles.at(unit.problem).flush();
+			printf("shard %d of %d: [%d/%d] %s delay bounds: (%d, %d) session size: %d sessions: %d-%d\n", shardIndex, shardCount, ++finishedUnitCount, (int)units.size(),
+				(BASIC_PROBLEM == unit.problem) ? "basic" : "general", (int)unit.DELAY_BOUND_TO_G, (int)unit.DELAY_BOUND_TO_R, (int)unit.SESSION_SIZE, unit.firstSessionID, unit.lastSessionID);
+		});
+
+		for (auto &it : allClients) for (auto client : it.second) delete client;
+		for (auto &it : allDatacenters) for (auto dc : it.second) delete dc;
+
+		printf("------------------------------------------------------------------------\n");
+		if (!units.empty()) Instrumentation::WritePhaseTimings(GetDataDirectoryOfProblem(units.front().problem) + "Output\\" + "shard_" + std::to_string(shardIndex) + "_of_" + std::to_string(shardCount) + "_phaseTiming.json");
+		if (!units.empty()) Instrumentation::WriteMemoryProfile(GetDataDirectoryOfProblem(units.front().problem) + "Output\\" + "shard_" + std::to_string(shardIndex) + "_of_" + std::to_string(shardCount) + "_memoryProfile.json");
+		printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+		if (isFailed)
+		{
+			cin.get();
+			return false;
+		}
+		return true;
+	}
+
+	bool MergeShards(const SweepGridType &grid, int shardCount)
+	{
+		if (shardCount <= 0)
+		{
+			printf("ERROR: invalid shard count %d\n", shardCount);
+			cin.get();
+			return false;
+		}
+		if (GetShardUnits(grid).empty())
+		{
+			printf("ERROR: no sharded experiments in the grid (set its problems, delayBounds and sessionSizes)\n");
+			cin.get();
+			return false;
+		}
+
+		const int COLUMN_COUNT = ServerAllocationProblem::GetColumnCount(ServerAllocationProblem::LocalSearchSettingType(), grid.optimalSetting); // the shards evaluate the strategies without LS
+
+		for (auto problem : grid.problems)
+		{
+			string dataDirectory = GetDataDirectoryOfProblem(problem);
+
+			// the sessions of each experiment (G, R, size) by session id, from all shards
+			map<tuple<double, double, double>, map<int, ShardSessionType>> sessionsOfExperiments;
+			for (int shardIndex = 0; shardIndex < shardCount; shardIndex++)
+			{
+				ifstream shardFile(GetShardFileName(problem, shardIndex, shardCount));
+				string line;
+				while (std::getline(shardFile, line))
+				{
+					if (shardFile.eof()) break; // the last line of a shard that is still being written may be incomplete
+
+					vector<double> fields;
+					stringstream lineStream(line);
+					string field;
+					while (std::getline(lineStream, field, ',')) fields.push_back(stod(field));
+
+					ShardSessionType session;
+					if (fields.size() < 4 || !ParseShardSession(fields, problem, COLUMN_COUNT, session))
+					{
+						printf("ERROR: unexpected line in shard %d of %d (written with another OPT setting or by an older build?)\n", shardIndex, shardCount);
+						cin.get();
+						return false;
+					}
+
+					sessionsOfExperiments[make_tuple(fields.at(0), fields.at(1), fields.at(2))].insert(make_pair((int)fields.at(3), session)); // a session found twice is the same session
+				}
+			}
+
+			for (auto &experiment : sessionsOfExperiments)
+			{
+				double DELAY_BOUND_TO_G = get<0>(experiment.first), DELAY_BOUND_TO_R = get<1>(experiment.first), SESSION_SIZE = get<2>(experiment.first);
+				auto &sessions = experiment.second; // in session order, as in a single run
+
+				ServerAllocationProblem::OutcomeStatisticsType outcomeStatistics;
+				vector<vector<double>> serverCountPerDC(SERVER_COUNT_COLUMNS.size());
+				for (auto &it : sessions)
+				{
+					auto &session = it.second;
+					outcomeStatistics.Add(session.outcome, session.computation);
+					outcomeStatistics.AddUnprovenOptimal(session.unprovenOptimal);
+
+					// the sketches of the sessions add up to the sketch of all their values (see QuantileSketchType)
+					if (outcomeStatistics.clientDelay.empty())
+					{
+						outcomeStatistics.clientDelay.assign(session.clientDelay.size(), vector<QuantileSketchType>(COLUMN_COUNT));
+						outcomeStatistics.serverUtilization = outcomeStatistics.clientDelay;
+					}
+					for (size_t j = 0; j < session.clientDelay.size(); j++)
+					{
+						for (int i = 0; i < COLUMN_COUNT; i++)
+						{
+							outcomeStatistics.clientDelay.at(j).at(i).Merge(session.clientDelay.at(j).at(i));
+							outcomeStatistics.serverUtilization.at(j).at(i).Merge(session.serverUtilization.at(j).at(i));
+						}
+					}
+
+					for (size_t c = 0; c < session.serverCountPerDC.size(); c++)
+					{
+						serverCountPerDC.at(c).resize(session.serverCountPerDC.at(c).size(), 0);
+						for (size_t dc = 0; dc < session.serverCountPerDC.at(c).size(); dc++) serverCountPerDC.at(c).at(dc) += session.serverCountPerDC.at(c).at(dc);
+					}
+				}
+
+				string experimentSettings = std::to_string((int)DELAY_BOUND_TO_G) + "_" + std::to_string((int)DELAY_BOUND_TO_R) + "_" + std::to_string((int)SESSION_SIZE);
+
+				ServerAllocationProblem::WriteCostWastageDelayData(outcomeStatistics, dataDirectory, experimentSettings);
+				ServerAllocationProblem::WriteDelayAndUtilizationData(outcomeStatistics, dataDirectory, experimentSettings);
+				if (grid.optimalSetting.enabled) ServerAllocationProblem::WriteUnprovenOptimalData(outcomeStatistics, dataDirectory, experimentSettings);
+
+				if (GENERAL_PROBLEM == problem)
+				{
+					ofstream serverCountPerDCFile(dataDirectory + "Output\\" + experimentSettings + "_" + "serverCountPerDC.csv");
+					for (size_t c = 0; c < serverCountPerDC.size(); c++)
+					{
+						if (c > 0) serverCountPerDCFile << "\n";
+						for (auto count : serverCountPerDC.at(c)) serverCountPerDCFile << count << ",";
+					}
+					serverCountPerDCFile.close();
+				}
+
+				ServerAllocationProblem::WriteComputationData(outcomeStatistics, dataDirectory, experimentSettings, (BASIC_PROBLEM == problem) ? "," : " "); // the separator of each single run
+
+				printf("%s delay bounds: (%d, %d) session size: %d -> %d/%d sessions merged\n", (BASIC_PROBLEM == problem) ? "basic" : "general",
+					(int)DELAY_BOUND_TO_G, (int)DELAY_BOUND_TO_R, (int)SESSION_SIZE, (int)sessions.size(), (int)grid.sessionCount);
+			}
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
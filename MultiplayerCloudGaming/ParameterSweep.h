@@ -0,0 +1,88 @@
+#pragma once
+
+#include "ServerAllocationProblem.h"
+#include "MatchmakingProblem.h"
+
+namespace ParameterSweep
+{
+	enum ProblemType { BASIC_PROBLEM, GENERAL_PROBLEM };
+
+	// declarative parameter grid: every combination of the listed values is one cell
+	struct SweepGridType
+	{
+		// ServerAllocationProblem (basic problem): one cell per (delay bounds, session size, server capacity, strategy)
+		vector<pair<double, double>> delayBounds; // (DELAY_BOUND_TO_G, DELAY_BOUND_TO_R)
+		vector<double> sessionSizes;
+		vector<double> serverCapacities;
+		vector<int> strategyIDs; // the cost of each is normalized by the LB of the same session
+		double sessionCount;
+
+		// MatchmakingProblem: one cell per (client count, latency threshold)
+		vector<int> clientCounts;
+		vector<int> latencyThresholds;
+		int matchmakingSessionSize;
+		int simulationCount;
+
+		// sharded experiments (see RunShard and MergeShards): one experiment per (problem, delay bounds, session size) over all capacities and strategies, with the same output files as SimulateBasicProblem and SimulateGeneralProblem
+		vector<ProblemType> problems;
+		int sessionBlockSize; // sessions of one experiment are assigned to shards in blocks of this size
+		ServerAllocationProblem::OptimalSettingType optimalSetting; // OPT in the sharded experiments (off by default, as in a single run); shards and merge must use the same setting
+
+		int threadCount; // 0: the number of hardware threads
+
+		SweepGridType()
+		{
+			this->sessionCount = 1000;
+			this->matchmakingSessionSize = 10;
+			this->simulationCount = 1000;
+			this->sessionBlockSize = 50;
+			this->threadCount = 0;
+		}
+	};
+
+	// one cell of the grid
+	struct SweepCellType
+	{
+		bool isServerAllocation; // otherwise matchmaking
+		double DELAY_BOUND_TO_G;
+		double DELAY_BOUND_TO_R;
+		double SESSION_SIZE;
+		double serverCapacity;
+		int strategyID;
+		int clientCount;
+		int latencyThreshold;
+		double estimatedCost; // relative, for balancing the load of the workers
+	};
+
+	vector<SweepCellType> GetCellsOfGrid(const SweepGridType &);
+
+	// run all cells of the grid on a work-stealing pool, loading each dataset only once
+	// each cell's result is appended to the output file of its problem (and printed) as soon as the cell finishes
+	// return false if any cell fails
+	bool RunSweep(const SweepGridType &);
+
+	// a block of sessions of one experiment, the unit of work assigned to a shard
+	struct ShardUnitType
+	{
+		ProblemType problem;
+		double DELAY_BOUND_TO_G;
+		double DELAY_BOUND_TO_R;
+		double SESSION_SIZE;
+		int firstSessionID;
+		int lastSessionID;
+	};
+
+	vector<ShardUnitType> GetShardUnits(const SweepGridType &);
+
+	// the shard of a unit by a stable hash of the unit, so that every process (on any machine) agrees on the split
+	int GetShardOfUnit(const ShardUnitType &, int);
+
+	// run the units of one shard (shardIndex in [0, shardCount)) and write one line of results per session to Output\shard_<index>_of_<count>.csv of each problem's data directory
+	// the line carries the session's delay and utilization distributions as quantile sketches (see QuantileSketchType), so that the merged percentiles and CDFs are those of a single run
+	// the lines of a unit are written and flushed together when the unit finishes, so a shard that is still running (or has died) can already be merged
+	bool RunShard(const SweepGridType &, int, int);
+
+	// combine the sessions found in the files of all shards into the files a single run writes (costTotal, capacityWastage, averageDelay, computation, the delay and utilization percentiles and CDFs, optUnprovenCount if OPT is enabled, plus serverCountPerDC for the general problem)
+	// missing shards and sessions are allowed (the files then cover the sessions found so far)
+	bool MergeShards(const SweepGridType &, int);
+}
\ No newline at end of file
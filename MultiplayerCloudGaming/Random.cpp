@@ -0,0 +1,11 @@
+#include "Random.h"
+
+// each component is mixed in turn, so that streams differing in any one component are unrelated
+unsigned long long GetRandomStreamKey(unsigned long long seed, unsigned long long session, unsigned long long purpose, unsigned long long subStream)
+{
+	unsigned long long key = MixBits64(seed + SPLITMIX64_GAMMA);
+	key = MixBits64(key ^ (session + SPLITMIX64_GAMMA));
+	key = MixBits64(key ^ (purpose + SPLITMIX64_GAMMA));
+	key = MixBits64(key ^ (subStream + SPLITMIX64_GAMMA));
+	return key;
+}
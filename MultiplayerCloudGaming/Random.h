@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Base.h"
+
+// counter-based random numbers (splitmix64 style): the i-th number of a stream is a pure function of the stream's key and i
+// so a stream can be reproduced in isolation and skipped ahead, and does not depend on the other streams, on the order of the calls or on thread scheduling
+
+// what a random stream is used for, so that the streams of one session are independent of each other
+enum RandomPurpose
+{
+	RANDOM_PURPOSE_G_DATACENTER_ORDER = 1, // order of trying G datacenters in matchmaking
+	RANDOM_PURPOSE_CLIENT_ORDER, // order of picking clients in matchmaking
+	RANDOM_PURPOSE_RANDOM_ASSIGNMENT, // the RANDOM strategy's choices
+	RANDOM_PURPOSE_CANDIDATE_CLIENTS, // candidate clients of one round of MaximumMatchingProblem
+	RANDOM_PURPOSE_TOPOLOGY_LOCATION, // where TopologyGenerator places a client or dc
+	RANDOM_PURPOSE_TOPOLOGY_RTT_NOISE, // noise of each RTT of a client or dc (two numbers per dc, by random access)
+	RANDOM_PURPOSE_TOPOLOGY_PRICE, // the pricing row of a dc
+	RANDOM_PURPOSE_TOPOLOGY_VIOLATION // triangle inequality violations between dcs
+};
+
+const unsigned long long SPLITMIX64_GAMMA = 0x9E3779B97F4A7C15ULL; // increment between consecutive counters (golden ratio)
+
+// splitmix64 finalizer: a bijective mix of all 64 bits
+inline unsigned long long MixBits64(unsigned long long x)
+{
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+// key of the stream identified by (seed, session, purpose, sub-stream)
+unsigned long long GetRandomStreamKey(unsigned long long, unsigned long long, unsigned long long, unsigned long long subStream = 0);
+
+// one random stream, usable as a UniformRandomBitGenerator
+struct CounterRandomType
+{
+	typedef unsigned long long result_type;
+
+	unsigned long long key;
+	unsigned long long counter; // index of the next number
+
+	CounterRandomType(unsigned long long seed, unsigned long long session, unsigned long long purpose, unsigned long long subStream = 0)
+	{
+		this->key = GetRandomStreamKey(seed, session, purpose, subStream);
+		this->counter = 0;
+	}
+
+	// the index-th number of the stream (random access, does not move the counter)
+	result_type At(unsigned long long index) const
+	{
+		return MixBits64(key + (index + 1) * SPLITMIX64_GAMMA);
+	}
+
+	result_type operator()()
+	{
+		return At(counter++);
+	}
+
+	// skip ahead by count numbers
+	void Discard(unsigned long long count)
+	{
+		counter += count;
+	}
+
+	// uniform in [0, n) without modulo bias (Lemire's multiply-shift with rejection), n > 0
+	unsigned UniformInt(unsigned n)
+	{
+		unsigned long long product = (unsigned long long)(unsigned)((*this)() >> 32) * n;
+		if ((unsigned)product < n)
+		{
+			unsigned threshold = (0U - n) % n;
+			while ((unsigned)product < threshold)
+			{
+				product = (unsigned long long)(unsigned)((*this)() >> 32) * n;
+			}
+		}
+		return (unsigned)(product >> 32);
+	}
+
+	// uniform in [0, 1) with 53 random bits
+	double UniformReal()
+	{
+		return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return ~0ULL; }
+};
+
+// swap the element at position with a uniformly chosen one of [position, last)
+// calling it for each position in turn is a Fisher-Yates shuffle, so a prefix can be shuffled lazily (only as far as it is looked at)
+template <class RandomAccessIterator>
+void ShuffleNext(RandomAccessIterator position, RandomAccessIterator last, CounterRandomType &random)
+{
+	std::iter_swap(position, position + random.UniformInt((unsigned)(last - position)));
+}
+
+// replacement of random_shuffle (a Fisher-Yates shuffle drawn from the given stream)
+template <class RandomAccessIterator>
+void Shuffle(RandomAccessIterator first, RandomAccessIterator last, CounterRandomType &random)
+{
+	for (; first != last; ++first)
+	{
+		ShuffleNext(first, last, random);
+	}
+}
+
+// a uniformly chosen element of a non-empty vector
+template <class T>
+const T &PickOne(const vector<T> &v, CounterRandomType &random)
+{
+	return v.at(random.UniformInt((unsigned)v.size()));
+}
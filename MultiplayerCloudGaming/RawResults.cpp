@@ -0,0 +1,278 @@
+#include "RawResults.h"
+
+namespace RawResults
+{
+	void RawResultColumnsType::clear()
+	{
+		sessionID.clear();
+		capacityIndex.clear();
+		column.clear();
+		costTotal.clear();
+		costServer.clear();
+		costBandwidth.clear();
+		capacityWastage.clear();
+		averageDelay.clear();
+		GDatacenterID.clear();
+		computation.clear();
+		flags.clear();
+	}
+
+	template <class T>
+	void WriteValue(ofstream &file, const T &value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <class T>
+	void WriteArray(ofstream &file, const vector<T> &values)
+	{
+		if (!values.empty()) file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+
+	RawResultWriterType::RawResultWriterType(const string &givenFileName, ProblemID problem, const vector<double> &capacities, const string &experimentSettings)
+	{
+		this->fileName = givenFileName;
+		this->fillingBuffer = 0;
+		this->isBlockPending = false;
+		this->isClosing = false;
+		this->isWriteFailed = false;
+		this->rowCount = 0;
+		this->waitingTime = 0;
+
+		file.open(fileName, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			printf("ERROR: cannot write the raw results to %s\n", fileName.c_str());
+			return;
+		}
+
+		WriteValue(file, RAW_RESULTS_MAGIC);
+		WriteValue(file, RAW_RESULTS_VERSION);
+		WriteValue(file, (unsigned char)problem);
+		WriteValue(file, (unsigned int)capacities.size());
+		WriteArray(file, capacities);
+		WriteValue(file, (unsigned int)experimentSettings.size());
+		file.write(experimentSettings.data(), experimentSettings.size());
+
+		buffers[0].sessionID.reserve(BLOCK_ROW_COUNT); // the other buffer grows on its first block
+		writerThread = std::thread(&RawResultWriterType::RunWriterThread, this);
+	}
+
+	RawResultWriterType::~RawResultWriterType()
+	{
+		Close();
+	}
+
+	void RawResultWriterType::AppendSession(int sessionID, const ServerAllocationProblem::SessionResultType &result)
+	{
+		if (!writerThread.joinable()) return;
+
+		for (size_t j = 0; j < result.outcome.size(); j++) // capacities
+		{
+			for (size_t i = 0; i < result.outcome.at(j).size(); i++) // columns
+			{
+				auto &buffer = buffers[fillingBuffer];
+				auto &outcome = result.outcome.at(j).at(i);
+				buffer.sessionID.push_back(sessionID);
+				buffer.capacityIndex.push_back((unsigned char)j);
+				buffer.column.push_back((unsigned char)i);
+				buffer.costTotal.push_back(get<0>(outcome));
+				buffer.costServer.push_back(get<1>(outcome));
+				buffer.costBandwidth.push_back(get<2>(outcome));
+				buffer.capacityWastage.push_back(get<3>(outcome));
+				buffer.averageDelay.push_back(get<4>(outcome));
+				buffer.GDatacenterID.push_back(result.finalGDatacenter.empty() ? result.GDatacenterID : result.finalGDatacenter.at(j).at(i));
+				buffer.computation.push_back(result.computation.at(j).at(i));
+				buffer.flags.push_back(((!result.unprovenOptimal.empty() && result.unprovenOptimal.at(j)) ? ROW_FLAG_UNPROVEN_OPTIMAL : 0) | (result.isCached ? ROW_FLAG_CACHED : 0));
+				rowCount++;
+
+				if (buffer.size() >= BLOCK_ROW_COUNT) // hand the full block to the thread, and go on with the other buffer once the thread has written it
+				{
+					auto waitStartTime = std::chrono::steady_clock::now();
+					std::unique_lock<std::mutex> lock(mutex);
+					condition.wait(lock, [this] { return !isBlockPending; });
+					waitingTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStartTime).count();
+					fillingBuffer = 1 - fillingBuffer;
+					buffers[fillingBuffer].clear();
+					isBlockPending = true;
+					condition.notify_all();
+				}
+			}
+		}
+	}
+
+	bool RawResultWriterType::Close()
+	{
+		if (!writerThread.joinable()) return file.is_open() && !isWriteFailed;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this] { return !isBlockPending; });
+			if (buffers[fillingBuffer].size() > 0) // the last block
+			{
+				fillingBuffer = 1 - fillingBuffer;
+				isBlockPending = true;
+			}
+			isClosing = true;
+			condition.notify_all();
+		}
+		writerThread.join();
+
+		file.close();
+		if (file.fail()) isWriteFailed = true;
+		return !isWriteFailed;
+	}
+
+	void RawResultWriterType::RunWriterThread()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			condition.wait(lock, [this] { return isBlockPending || isClosing; });
+			if (isBlockPending) // the buffer the caller is not filling
+			{
+				const RawResultColumnsType &block = buffers[1 - fillingBuffer];
+				lock.unlock();
+				WriteBlock(block);
+				lock.lock();
+				isBlockPending = false;
+				condition.notify_all();
+			}
+			else break; // closing, and nothing left to write
+		}
+	}
+
+	void RawResultWriterType::WriteBlock(const RawResultColumnsType &block)
+	{
+		WriteValue(file, (unsigned int)block.size());
+		WriteArray(file, block.sessionID);
+		WriteArray(file, block.capacityIndex);
+		WriteArray(file, block.column);
+		WriteArray(file, block.costTotal);
+		WriteArray(file, block.costServer);
+		WriteArray(file, block.costBandwidth);
+		WriteArray(file, block.capacityWastage);
+		WriteArray(file, block.averageDelay);
+		WriteArray(file, block.GDatacenterID);
+		WriteArray(file, block.computation);
+		WriteArray(file, block.flags);
+		file.flush(); // a crash loses at most the blocks not handed over yet
+		if (!file) isWriteFailed = true;
+	}
+
+	bool ReadRawResults(const string &fileName, RawResultsType &results)
+	{
+		ifstream file(fileName, std::ios::binary);
+		if (!file.is_open())
+		{
+			printf("ERROR: cannot open %s\n", fileName.c_str());
+			return false;
+		}
+		string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		size_t offset = 0;
+
+		// copy the next count values (false if the file ends before them)
+		auto ReadArray = [&](void *values, size_t count, size_t valueSize)
+		{
+			if (bytes.size() - offset < count * valueSize) return false;
+			if (count > 0) memcpy(values, bytes.data() + offset, count * valueSize);
+			offset += count * valueSize;
+			return true;
+		};
+		auto AppendArray = [&](auto &values, size_t count)
+		{
+			size_t oldSize = values.size();
+			values.resize(oldSize + count);
+			return ReadArray(values.data() + oldSize, count, sizeof(values.front()));
+		};
+
+		unsigned int magic = 0, version = 0, capacityCount = 0, settingsLength = 0;
+		unsigned char problem = 0;
+		if (!ReadArray(&magic, 1, sizeof(magic)) || magic != RAW_RESULTS_MAGIC || !ReadArray(&version, 1, sizeof(version)) || version != RAW_RESULTS_VERSION
+			|| !ReadArray(&problem, 1, sizeof(problem)) || !ReadArray(&capacityCount, 1, sizeof(capacityCount)))
+		{
+			printf("ERROR: %s is not a raw results file (of version %u)\n", fileName.c_str(), RAW_RESULTS_VERSION);
+			return false;
+		}
+		results.problem = ProblemID(problem);
+		results.capacities.assign(capacityCount, 0);
+		if (!ReadArray(results.capacities.data(), capacityCount, sizeof(double)) || !ReadArray(&settingsLength, 1, sizeof(settingsLength)) || bytes.size() - offset < settingsLength)
+		{
+			printf("ERROR: %s has an incomplete header\n", fileName.c_str());
+			return false;
+		}
+		results.experimentSettings = bytes.substr(offset, settingsLength);
+		offset += settingsLength;
+
+		auto &rows = results.rows;
+		rows.clear();
+		while (offset < bytes.size())
+		{
+			size_t rowsBefore = rows.size();
+			unsigned int n = 0;
+			bool isCompleteBlock = ReadArray(&n, 1, sizeof(n)) && n <= (unsigned int)BLOCK_ROW_COUNT
+				&& AppendArray(rows.sessionID, n) && AppendArray(rows.capacityIndex, n) && AppendArray(rows.column, n)
+				&& AppendArray(rows.costTotal, n) && AppendArray(rows.costServer, n) && AppendArray(rows.costBandwidth, n) && AppendArray(rows.capacityWastage, n) && AppendArray(rows.averageDelay, n)
+				&& AppendArray(rows.GDatacenterID, n) && AppendArray(rows.computation, n) && AppendArray(rows.flags, n);
+			if (!isCompleteBlock)
+			{
+				printf("WARNING: the last block of %s is incomplete and is skipped\n", fileName.c_str());
+				for (auto values : { &rows.sessionID, &rows.GDatacenterID }) values->resize(rowsBefore);
+				for (auto values : { &rows.capacityIndex, &rows.column, &rows.flags }) values->resize(rowsBefore);
+				for (auto values : { &rows.costTotal, &rows.costServer, &rows.costBandwidth, &rows.capacityWastage, &rows.averageDelay, &rows.computation }) values->resize(rowsBefore);
+				break;
+			}
+		}
+
+		return true;
+	}
+
+	void AggregateRawResults(const RawResultsType &results, ServerAllocationProblem::OutcomeStatisticsType &statistics)
+	{
+		statistics = ServerAllocationProblem::OutcomeStatisticsType();
+		auto &rows = results.rows;
+
+		// the rows of a session are contiguous, in capacity and column order
+		for (size_t first = 0; first < rows.size();)
+		{
+			size_t last = first;
+			int columnCount = 0;
+			while (last < rows.size() && rows.sessionID.at(last) == rows.sessionID.at(first))
+			{
+				columnCount = std::max(columnCount, rows.column.at(last) + 1);
+				last++;
+			}
+
+			vector<vector<tuple<double, double, double, double, double>>> outcome(results.capacities.size(), vector<tuple<double, double, double, double, double>>(columnCount));
+			vector<vector<double>> computation(results.capacities.size(), vector<double>(columnCount, 0));
+			vector<int> unprovenOptimal(results.capacities.size(), 0);
+			bool isCached = false;
+			for (size_t k = first; k < last; k++)
+			{
+				outcome.at(rows.capacityIndex.at(k)).at(rows.column.at(k)) = make_tuple(rows.costTotal.at(k), rows.costServer.at(k), rows.costBandwidth.at(k), rows.capacityWastage.at(k), rows.averageDelay.at(k));
+				computation.at(rows.capacityIndex.at(k)).at(rows.column.at(k)) = rows.computation.at(k);
+				if (rows.flags.at(k) & ROW_FLAG_UNPROVEN_OPTIMAL) unprovenOptimal.at(rows.capacityIndex.at(k)) = 1;
+				if (rows.flags.at(k) & ROW_FLAG_CACHED) isCached = true;
+			}
+			statistics.Add(outcome, computation, isCached);
+			statistics.AddUnprovenOptimal(unprovenOptimal);
+
+			first = last;
+		}
+	}
+
+	bool WriteAggregatedData(const string &fileName, const string &dataDirectory)
+	{
+		RawResultsType results;
+		if (!ReadRawResults(fileName, results)) return false;
+
+		ServerAllocationProblem::OutcomeStatisticsType statistics;
+		AggregateRawResults(results, statistics);
+		ServerAllocationProblem::WriteCostWastageDelayData(statistics, dataDirectory, results.experimentSettings);
+		ServerAllocationProblem::WriteComputationData(statistics, dataDirectory, results.experimentSettings, (PROBLEM_BASIC == results.problem) ? "," : " "); // the separator of each simulation
+		ServerAllocationProblem::WriteUnprovenOptimalData(statistics, dataDirectory, results.experimentSettings);
+
+		printf("%s: %d sessions (%d rows) of %s aggregated into %sOutput\\\n", fileName.c_str(), (int)statistics.sessionCount, (int)results.rows.size(), results.experimentSettings.c_str(), dataDirectory.c_str());
+		return true;
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "ServerAllocationProblem.h"
+#include <condition_variable>
+#include <cstring>
+
+// raw per-session results of a simulation: one row per (session, capacity, column) with the outcome, the (final) G datacenter and the computation time, so that the results can be aggregated again (or differently) without rerunning
+// the file is a header followed by blocks of up to BLOCK_ROW_COUNT rows, each block stored column by column (all session ids, then all capacity indices, etc.) in the machine's byte order:
+//   header: uint32 RAW_RESULTS_MAGIC, uint32 RAW_RESULTS_VERSION, uint8 problem (0: basic, 1: general), uint32 capacity count, float64 capacities, uint32 length and bytes of the experiment settings (e.g. 75_50_10)
+//   block: uint32 row count n, int32 sessionID[n], uint8 capacityIndex[n], uint8 column[n], float64 costTotal[n], costServer[n], costBandwidth[n], capacityWastage[n], averageDelay[n], int32 GDatacenterID[n], float64 computation[n], uint8 flags[n] (see ROW_FLAG_UNPROVEN_OPTIMAL)
+// the doubles are stored exactly, so aggregating a file gives the same statistics as the simulation that wrote it
+namespace RawResults
+{
+	const unsigned int RAW_RESULTS_MAGIC = 0x5752434D; // "MCRW"
+	const unsigned int RAW_RESULTS_VERSION = 2;
+	const int BLOCK_ROW_COUNT = 8192;
+	const unsigned char ROW_FLAG_UNPROVEN_OPTIMAL = 1; // OPT's result at the row's session and capacity is not proven optimal (set on every column of that capacity)
+	const unsigned char ROW_FLAG_CACHED = 2; // the row's session was read from a result cache, so its computation was timed by an earlier run (and is not aggregated)
+
+	enum ProblemID { PROBLEM_BASIC = 0, PROBLEM_GENERAL = 1 };
+
+	// rows in columns (one vector per field, all of the same size)
+	struct RawResultColumnsType
+	{
+		vector<int> sessionID;
+		vector<unsigned char> capacityIndex; // into the capacities of the file
+		vector<unsigned char> column; // strategy (1: LB, etc.) minus 1, followed by the LS columns (see GetColumnCount)
+		vector<double> costTotal;
+		vector<double> costServer;
+		vector<double> costBandwidth;
+		vector<double> capacityWastage;
+		vector<double> averageDelay;
+		vector<int> GDatacenterID; // the session's G datacenter (basic problem) or the final one of the cell (general problem)
+		vector<double> computation; // wall-clock milliseconds
+		vector<unsigned char> flags; // ROW_FLAG_* bits
+
+		size_t size() const { return sessionID.size(); }
+		void clear();
+	};
+
+	// appends the sessions' rows to a file through a background thread with two buffers: the caller fills one block while the thread writes the other,
+	// so the caller only waits if the disk falls a whole block behind (the time it waited is reported by Close)
+	struct RawResultWriterType
+	{
+		string fileName;
+		ofstream file;
+		RawResultColumnsType buffers[2];
+		int fillingBuffer; // the one the caller appends to (the other one may be being written)
+		bool isBlockPending; // a full block has been handed to the thread and is not written yet
+		bool isClosing;
+		bool isWriteFailed;
+		double rowCount;
+		double waitingTime; // milliseconds the caller waited for the thread
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::thread writerThread;
+
+		// create (or overwrite) the file and start the thread; check IsOpen
+		RawResultWriterType(const string &, ProblemID, const vector<double> &, const string &);
+		~RawResultWriterType();
+		RawResultWriterType(const RawResultWriterType &) = delete;
+		RawResultWriterType &operator=(const RawResultWriterType &) = delete;
+
+		bool IsOpen() const { return file.is_open(); }
+
+		// the rows of one session, in capacity and column order
+		void AppendSession(int, const ServerAllocationProblem::SessionResultType &);
+
+		// write the last (partial) block, stop the thread and close the file (also done by the destructor)
+		// return false if any write failed
+		bool Close();
+
+		void RunWriterThread();
+		void WriteBlock(const RawResultColumnsType &);
+	};
+
+	// a whole file
+	struct RawResultsType
+	{
+		ProblemID problem;
+		vector<double> capacities;
+		string experimentSettings;
+		RawResultColumnsType rows;
+	};
+
+	// read all complete blocks of a file (a block cut short, e.g. by a crash of the writer, ends the reading with a warning)
+	// return false if the file cannot be read or is not a raw results file
+	bool ReadRawResults(const string &, RawResultsType &);
+
+	// the statistics of the file's sessions (in the order they were written), as the simulation that wrote it had them
+	void AggregateRawResults(const RawResultsType &, ServerAllocationProblem::OutcomeStatisticsType &);
+
+	// read a file and write its mean and std files (see WriteCostWastageDelayData and WriteComputationData) into the Output directory of the given data directory
+	// return false if the file cannot be read
+	bool WriteAggregatedData(const string &, const string &);
+}
@@ -1,4 +1,6 @@
 #include "ServerAllocationProblem.h"
+#include "RawResults.h"
+#include <condition_variable>
 
 namespace ServerAllocationProblem
 {	
@@ -8,6 +10,7 @@ namespace ServerAllocationProblem
 		{
 			//c->eligibleDatacenterList.clear();
 			c->eligibleDatacenters.clear();
+			c->eligibleDatacenterMask.assign((datacenters.size() + 63) / 64, 0);
 		}
 
 		for (auto d : datacenters)
@@ -31,435 +34,2438 @@ namespace ServerAllocationProblem
 		}
 	}
 
-	// matchmaking for basic problem
-	// result: the datacenter for hosting the G-server, and a list of clients to be involved
-	// return true if found
-	bool Matchmaking4BasicProblem(vector<DatacenterType*> allDatacenters,
-		vector<ClientType*> allClients,
-		int &GDatacenterID,
-		vector<ClientType*> &sessionClients,
-		double SESSION_SIZE,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R)
+	// assign each client to the dc with the given id (indexed in the same order as the clients)
+	void ApplyAssignment(const vector<ClientType*> &clients, const vector<DatacenterType*> &datacenters, const vector<int> &assignedDatacenterIDs)
 	{
-		ResetEligibiltyCoverability(allClients, allDatacenters);
-		sessionClients.clear();
+		ResetAssignment(clients, datacenters);
 
-		random_shuffle(allDatacenters.begin(), allDatacenters.end()); // for randomizing each session's G-server selection process	
+		for (size_t i = 0; i < clients.size(); i++)
+		{
+			clients.at(i)->assignedDatacenterID = assignedDatacenterIDs.at(i);
+			datacenters.at(assignedDatacenterIDs.at(i))->assignedClients.push_back(clients.at(i));
+		}
+	}
 
-		for (auto Gdc : allDatacenters) // iterating all datacenters until we find an eligible G datacenter
+	WorkspaceType::WorkspaceType(const vector<ClientType*> &givenClients, const vector<DatacenterType*> &givenDatacenters)
+	{
+		for (auto dc : givenDatacenters)
 		{
-			random_shuffle(allClients.begin(), allClients.end()); // for randomizing each session's involved clients		
+			auto copiedDC = new DatacenterType(dc->id);
+			copiedDC->priceServer = dc->priceServer;
+			copiedDC->priceBandwidth = dc->priceBandwidth;
+			copiedDC->delayToDatacenter = dc->delayToDatacenter; // delayToClient is not used by the strategies
+			datacenters.push_back(copiedDC);
+		}
 
-			for (auto client : allClients)
+		map<int, ClientType*> copiedClients; // mapped with client's id
+		for (auto client : givenClients)
+		{
+			auto copiedClient = new ClientType(client->id);
+			copiedClient->chargedTrafficVolume = client->chargedTrafficVolume;
+			copiedClient->delayToDatacenter = client->delayToDatacenter;
+			copiedClient->eligibleDatacenterMask = client->eligibleDatacenterMask;
+			copiedClient->eligibleDatacenterRank = client->eligibleDatacenterRank;
+			for (auto edc : client->eligibleDatacenters)
 			{
-				if ((int)sessionClients.size() == SESSION_SIZE) // reach the target session size
-				{
-					GDatacenterID = Gdc->id; // record the G datacenter id
-					return true; // succeed
-				}
+				copiedClient->eligibleDatacenters.push_back(datacenters.at(edc->id));
+			}
+			clients.push_back(copiedClient);
+			copiedClients[client->id] = copiedClient;
+		}
 
-				for (auto dc : allDatacenters)
+		for (auto dc : givenDatacenters)
+		{
+			for (auto client : dc->coverableClients)
+			{
+				auto it = copiedClients.find(client->id);
+				if (it != copiedClients.end()) datacenters.at(dc->id)->coverableClients.push_back(it->second);
+			}
+		}
+	}
+
+	WorkspaceType::~WorkspaceType()
+	{
+		for (auto client : clients) delete client;
+		for (auto dc : datacenters) delete dc;
+	}
+
+	thread_local const SessionRandomnessType *sessionRandomness = nullptr;
+
+	SessionRandomnessType::SessionRandomnessType(int sessionID, unsigned long long seed)
+	{
+		this->seed = seed;
+		this->sessionID = sessionID;
+		previous = sessionRandomness;
+		sessionRandomness = this;
+	}
+
+	SessionRandomnessType::SessionRandomnessType(const SessionRandomnessType *other)
+	{
+		this->seed = (nullptr == other) ? SESSION_RANDOM_SEED : other->seed;
+		this->sessionID = (nullptr == other) ? 0 : other->sessionID;
+		previous = sessionRandomness;
+		sessionRandomness = this;
+	}
+
+	SessionRandomnessType::~SessionRandomnessType()
+	{
+		sessionRandomness = previous;
+	}
+
+	CounterRandomType GetSessionRandom(RandomPurpose purpose, unsigned long long subStream)
+	{
+		if (nullptr == sessionRandomness)
+			return CounterRandomType(SESSION_RANDOM_SEED, 0, purpose, subStream);
+		else
+			return CounterRandomType(sessionRandomness->seed, (unsigned long long)sessionRandomness->sessionID, purpose, subStream);
+	}
+
+	// run the sessions firstSessionID to SESSION_COUNT and pass their results to ConsumeSession in session order
+	// threadCount = 0: one after another with the given clients and datacenters
+	// threadCount > 0: on threadCount worker threads, each with its own copy of the clients and datacenters
+	// each session uses its own random streams (see SessionRandomnessType), so the results are the same for any threadCount
+	// return false if any session fails (the remaining sessions are not started)
+	// resultCache (optional): sessions found in it are not run again, and the others are added to it in session order as they are consumed
+	bool RunSessions(
+		int firstSessionID,
+		double SESSION_COUNT,
+		int threadCount,
+		const vector<ClientType*> &allClients,
+		const vector<DatacenterType*> &allDatacenters,
+		const std::function<bool(int, const vector<ClientType*> &, const vector<DatacenterType*> &, SessionResultType &)> &RunOneSession,
+		const std::function<void(int, const SessionResultType &)> &ConsumeSession,
+		ResultCacheType *resultCache)
+	{
+		vector<int> sessionIDs; // the sessions to run or to read from the cache
+		for (int sessionID = firstSessionID; sessionID <= SESSION_COUNT; sessionID++)
+		{
+			sessionIDs.push_back(sessionID);
+		}
+
+		std::atomic<bool> isFailed(false); // a session failed, so the ones waiting below give up
+
+		// the results finished ahead of an earlier session, until it is consumed (fewer than reorderWindow, see RunAndCacheOneSession)
+		const int reorderWindow = SESSION_REORDER_WINDOW_PER_THREAD * std::max(threadCount, 1);
+		std::mutex consumeMutex;
+		std::condition_variable consumeCondition;
+		map<int, SessionResultType> waitingResults;
+		int nextSessionID = firstSessionID;
+		auto ConsumeNextSession = [&](const SessionResultType &result) // with consumeMutex locked
+		{
+			if (nullptr != resultCache && !result.isCached) resultCache->Append(nextSessionID, result); // in session order, so that the cache is read back in one pass
+			ConsumeSession(nextSessionID, result);
+			nextSessionID++;
+		};
+		auto FinishOneSession = [&](int sessionID, SessionResultType &result)
+		{
+			Instrumentation::MemoryStructureScopeType memoryScope(Instrumentation::STRUCTURE_RESULTS);
+			std::lock_guard<std::mutex> lock(consumeMutex);
+			if (sessionID != nextSessionID)
+			{
+				waitingResults[sessionID] = std::move(result);
+				return;
+			}
+			ConsumeNextSession(result);
+			for (auto it = waitingResults.begin(); it != waitingResults.end() && it->first == nextSessionID; it = waitingResults.erase(it))
+			{
+				ConsumeNextSession(it->second);
+			}
+			consumeCondition.notify_all();
+		};
+
+		// the cache is read in one forward pass, so the sessions look themselves up in session order
+		std::mutex lookupMutex;
+		std::condition_variable lookupCondition;
+		int nextLookupSessionID = firstSessionID;
+		int cachedSessionCount = 0;
+
+		auto RunAndCacheOneSession = [&](int sessionID, const vector<ClientType*> &clients, const vector<DatacenterType*> &datacenters)
+		{
+			if (threadCount > 0) // the sessions are handed out in order, so waiting here bounds the results waiting to be consumed
+			{
+				std::unique_lock<std::mutex> lock(consumeMutex);
+				consumeCondition.wait(lock, [&] { return sessionID < nextSessionID + reorderWindow || isFailed; });
+			}
+
+			SessionResultType result;
+			bool isCached = false;
+			if (nullptr != resultCache)
+			{
+				std::unique_lock<std::mutex> lock(lookupMutex);
+				lookupCondition.wait(lock, [&] { return sessionID == nextLookupSessionID || isFailed; });
+				if (isFailed) return false;
+				isCached = resultCache->ReadCachedResult(sessionID, result);
+				if (isCached) cachedSessionCount++;
+				nextLookupSessionID++;
+				lookupCondition.notify_all();
+			}
+			if (isFailed) return false;
+
+			if (!isCached)
+			{
+				SessionRandomnessType randomness(sessionID);
+				Instrumentation::MemoryStructureScopeType memoryScope(Instrumentation::STRUCTURE_SESSION);
+				if (!RunOneSession(sessionID, clients, datacenters, result))
 				{
-					if ((client->delayToDatacenter[dc->id] + dc->delayToDatacenter[Gdc->id]) <= DELAY_BOUND_TO_G
-						&& client->delayToDatacenter[dc->id] <= DELAY_BOUND_TO_R)
+					isFailed = true;
+					for (auto mutexAndCondition : { make_pair(&consumeMutex, &consumeCondition), make_pair(&lookupMutex, &lookupCondition) }) // wake up the waiting sessions
 					{
-						//client->eligibleDatacenterList.push_back(tuple<int, double, double, double, double>(dc->id, client->delayToDatacenter[dc->id], dc->priceServer, dc->priceBandwidth * client->chargedTrafficVolume, dc->priceCombined));
-						client->eligibleDatacenters.push_back(dc);
-
-						//dc->coverableClientList.push_back(client->id);
-						dc->coverableClients.push_back(client);
+						std::lock_guard<std::mutex> lock(*mutexAndCondition.first);
+						mutexAndCondition.second->notify_all();
 					}
+					return false;
 				}
+			}
+			FinishOneSession(sessionID, result);
+			return true;
+		};
 
-				if (!client->eligibleDatacenters.empty())
+		bool isDone = true;
+		if (threadCount <= 0)
+		{
+			for (auto sessionID : sessionIDs)
+			{
+				if (!RunAndCacheOneSession(sessionID, allClients, allDatacenters))
 				{
-					sessionClients.push_back(client); // put this client into the session 		
+					isDone = false;
+					break;
 				}
 			}
-
-			// reset for next round of search		
-			ResetEligibiltyCoverability(allClients, allDatacenters);
-			sessionClients.clear();
+		}
+		else
+		{
+			Instrumentation::MemoryStructureScopeType memoryScope(Instrumentation::STRUCTURE_TOPOLOGY); // each worker's copy of the clients and datacenters
+			isDone = RunTasksWithWorkspaces(sessionIDs, threadCount, allClients, allDatacenters, [&](int sessionID, WorkspaceType &workspace)
+			{
+				return RunAndCacheOneSession(sessionID, workspace.clients, workspace.datacenters);
+			});
 		}
 
-		return false;
+		if (nullptr != resultCache && isDone)
+		{
+			printf("%d sessions read from the result cache, %d sessions run\n", cachedSessionCount, (int)sessionIDs.size() - cachedSessionCount);
+		}
+		return isDone;
 	}
 
-	// just to find if there are any eligible datacenters to open GS given the input (candidate datacenters, client group, delay bounds) 
-	// record all of them if found
-	// for general problem
-	void SearchEligibleGDatacenter(vector<DatacenterType*> allDatacenters,
-		vector<ClientType*> sessionClients,
-		vector<DatacenterType*> &eligibleGDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R)
+	bool RunSessionsAdaptively(
+		double SESSION_COUNT,
+		const AdaptiveStoppingSettingType &adaptiveStopping,
+		int threadCount,
+		const vector<ClientType*> &allClients,
+		const vector<DatacenterType*> &allDatacenters,
+		const std::function<bool(int, const vector<ClientType*> &, const vector<DatacenterType*> &, SessionResultType &)> &RunOneSession,
+		const std::function<void(int, const SessionResultType &)> &ConsumeSession,
+		ResultCacheType *resultCache,
+		vector<vector<double>> &sessionCountOfCell,
+		vector<vector<double>> &relativeHalfWidthOfCell)
 	{
-		eligibleGDatacenters.clear();
+		sessionCountOfCell.clear();
+		relativeHalfWidthOfCell.clear();
 
-		for (auto GDatacenter : allDatacenters)
+		// LB-normalized total cost of each (capacity, column) cell, per stratum
+		vector<vector<map<int, StatisticsAccumulatorType>>> costOfStratumOfCell;
+		auto ConsumeAndTrackSession = [&](int sessionID, const SessionResultType &result)
 		{
-			bool isValidGDatacenter = true;
+			ConsumeSession(sessionID, result);
+			if (costOfStratumOfCell.empty()) costOfStratumOfCell.assign(result.outcome.size(), vector<map<int, StatisticsAccumulatorType>>(result.outcome.front().size()));
 
-			for (auto client : sessionClients)
+			for (size_t j = 0; j < result.outcome.size(); j++)
 			{
-				int numEligibleDC = 0;
-				for (auto dc : allDatacenters)
+				auto &outcome = result.outcome.at(j);
+				for (size_t i = 0; i < outcome.size(); i++)
 				{
-					if ((client->delayToDatacenter[dc->id] + dc->delayToDatacenter[GDatacenter->id]) <= DELAY_BOUND_TO_G &&
-						client->delayToDatacenter[dc->id] <= DELAY_BOUND_TO_R)
-					{
-						numEligibleDC++;
-					}
+					int stratum = 0;
+					if (adaptiveStopping.stratifiedByGDatacenter) stratum = result.finalGDatacenter.empty() ? result.GDatacenterID : result.finalGDatacenter.at(j).at(i); // the session's G datacenter, or the cell's final one (general problem)
+					costOfStratumOfCell.at(j).at(i)[stratum].Add(get<0>(outcome.at(i)) / get<0>(outcome.front()));
 				}
-				if (numEligibleDC < 1)
+			}
+		};
+
+		double sessionCount = std::min(SESSION_COUNT, std::max(adaptiveStopping.minSessionCount, 2.0)); // the first check
+		int firstSessionID = 1;
+		while (true)
+		{
+			if (!RunSessions(firstSessionID, sessionCount, threadCount, allClients, allDatacenters, RunOneSession, ConsumeAndTrackSession, resultCache)) return false;
+			firstSessionID = (int)sessionCount + 1;
+
+			if (sessionCountOfCell.empty())
+			{
+				sessionCountOfCell.assign(costOfStratumOfCell.size(), vector<double>(costOfStratumOfCell.front().size(), 0));
+				relativeHalfWidthOfCell = sessionCountOfCell;
+			}
+
+			bool isConverged = true;
+			double maxRelativeHalfWidth = 0;
+			for (size_t j = 0; j < sessionCountOfCell.size(); j++) // capacities
+			{
+				for (size_t i = 0; i < sessionCountOfCell.at(j).size(); i++) // columns
 				{
-					isValidGDatacenter = false; // found a client that has no eligible R-server locations given this G-server location, so this G-server location is invalid
-					break;
+					relativeHalfWidthOfCell.at(j).at(i) = GetRelativeHalfWidth(costOfStratumOfCell.at(j).at(i), adaptiveStopping);
+					maxRelativeHalfWidth = std::max(maxRelativeHalfWidth, relativeHalfWidthOfCell.at(j).at(i));
+					if (relativeHalfWidthOfCell.at(j).at(i) <= adaptiveStopping.relativeHalfWidth)
+					{
+						if (0 == sessionCountOfCell.at(j).at(i)) sessionCountOfCell.at(j).at(i) = sessionCount;
+					}
+					else isConverged = false;
 				}
 			}
 
-			if (isValidGDatacenter)	eligibleGDatacenters.push_back(GDatacenter); // put it into the list				
+			printf("adaptive stopping: %d sessions, max relative half-width %g\n", (int)sessionCount, maxRelativeHalfWidth);
+			if (isConverged || sessionCount >= SESSION_COUNT) break;
+			sessionCount = std::min(SESSION_COUNT, sessionCount + std::max(adaptiveStopping.batchSize, 1.0));
+		}
+
+		for (auto &sessionCountAtOneCapacity : sessionCountOfCell)
+		{
+			for (auto &count : sessionCountAtOneCapacity)
+			{
+				if (0 == count) count = sessionCount; // not converged
+			}
 		}
+
+		return true;
 	}
 
-	// result: a list of datacenters that are eligible for hosting the G-server, and a list of clients to be involved 
-	// return true if found
-	// for general problem
-	bool Matchmaking4GeneralProblem(vector<DatacenterType*> allDatacenters,
-		vector<ClientType*> allClients,
-		vector<ClientType*> &sessionClients,
-		vector<DatacenterType*> &eligibleGDatacenters,
-		double SESSION_SIZE,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R)
+	double GetRelativeHalfWidth(const map<int, StatisticsAccumulatorType> &costOfStratum, const AdaptiveStoppingSettingType &adaptiveStopping)
 	{
-		ResetEligibiltyCoverability(allClients, allDatacenters);
-		sessionClients.clear();
-		eligibleGDatacenters.clear();
+		StatisticsAccumulatorType cost; // of all sessions
+		for (auto &stratum : costOfStratum)
+		{
+			cost.Merge(stratum.second);
+		}
+		const double n = cost.count;
+		double pooledVariance = cost.GetSampleVariance();
 
-		int initialGDatacenter; // just for satisfying MatchmakingBasicProblem's parameters
-		if (Matchmaking4BasicProblem(allDatacenters, allClients, initialGDatacenter, sessionClients, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R))
+		// variance of the post-stratified mean: sum of (n_h / n)^2 * s_h^2 / n_h over the strata
+		// (a stratum with one session has no variance estimate of its own, so it gets the pooled variance)
+		double varianceOfMean = 0;
+		for (auto &stratum : costOfStratum)
 		{
-			SearchEligibleGDatacenter(allDatacenters, sessionClients, eligibleGDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
+			double n_h = stratum.second.count;
+			double variance_h = n_h > 1 ? stratum.second.GetSampleVariance() : pooledVariance;
+			varianceOfMean += (n_h / n) * (n_h / n) * variance_h / n_h;
 		}
 
-		return (!sessionClients.empty() && !eligibleGDatacenters.empty());
+		double z = GetStandardNormalQuantile(1 - (1 - adaptiveStopping.confidenceLevel) / 2);
+		return z * sqrt(varianceOfMean) / cost.GetMean();
 	}
 
-	// used inside each strategy function
-	// for general problem
-	void SimulationSetup4GeneralProblem(DatacenterType *GDatacenter, vector<ClientType*> sessionClients, vector<DatacenterType*> allDatacenters, double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R)
+	void OutcomeStatisticsType::Add(const vector<vector<tuple<double, double, double, double, double>>> &outcome, const vector<vector<double>> &computationOfSession, bool isCached)
 	{
-		ResetEligibiltyCoverability(sessionClients, allDatacenters);
+		if (costTotal.empty())
+		{
+			costTotal.assign(outcome.size(), vector<StatisticsAccumulatorType>(outcome.front().size()));
+			capacityWastage = averageDelay = computation = costTotal;
+		}
 
-		for (auto client : sessionClients) // find eligible datacenters for each client and coverable clients for each dc
+		for (size_t j = 0; j < outcome.size(); j++) // capacities
 		{
-			for (auto dc : allDatacenters)
+			for (size_t i = 0; i < outcome.at(j).size(); i++) // columns
 			{
-				if ((client->delayToDatacenter[dc->id] + dc->delayToDatacenter[GDatacenter->id]) <= DELAY_BOUND_TO_G && client->delayToDatacenter[dc->id] <= DELAY_BOUND_TO_R)
-				{
-					//client->eligibleDatacenterList.push_back(tuple<int, double, double, double, double>(dc->id, client->delayToDatacenter[dc->id], dc->priceServer, dc->priceBandwidth, dc->priceCombined)); // record eligible dc's id, delay, priceServer, priceBandwidth, priceCombined
-					client->eligibleDatacenters.push_back(dc);
-
-					//dc->coverableClientList.push_back(client->id);
-					dc->coverableClients.push_back(client);
-				}
+				costTotal.at(j).at(i).Add(get<0>(outcome.at(j).at(i)) / get<0>(outcome.at(j).front()));
+				capacityWastage.at(j).at(i).Add(get<3>(outcome.at(j).at(i)));
+				averageDelay.at(j).at(i).Add(get<4>(outcome.at(j).at(i)));
+				if (!isCached) computation.at(j).at(i).Add(computationOfSession.at(j).at(i)); // a cached session was timed by an earlier run (maybe of another machine or load)
 			}
 		}
+		sessionCount++;
+		if (isCached) cachedSessionCount++;
 	}
 
-	// include G-server's cost into the total cost according to the group size
-	// used inside the following strategy functions
-	// for general problem only
-	void IncludeGServerCost(DatacenterType *GDatacenter, double SESSION_SIZE, bool includingGServerCost, double &tempTotalCost)
+	void OutcomeStatisticsType::AddDistributions(const vector<vector<vector<double>>> &clientDelayOfSession, const vector<vector<vector<double>>> &serverUtilizationOfSession)
 	{
-		if (includingGServerCost)
+		if (clientDelayOfSession.empty()) return;
+		if (clientDelay.empty())
 		{
-			if (SESSION_SIZE <= 20)
-				tempTotalCost += GDatacenter->priceServer / 8;
-			else if (SESSION_SIZE <= 40)
-				tempTotalCost += GDatacenter->priceServer / 4;
-			else if (SESSION_SIZE <= 80)
-				tempTotalCost += GDatacenter->priceServer / 2;
-			else
-				tempTotalCost += GDatacenter->priceServer;
+			clientDelay.assign(clientDelayOfSession.size(), vector<QuantileSketchType>(clientDelayOfSession.front().size()));
+			serverUtilization = clientDelay;
 		}
-	}
 
-	// function to get the solution output 
-	// return <cost_total, cost_server, cost_bandwidth, capacity_wastage, average_delay>
-	tuple<double, double, double, double, double> GetSolutionOutput(
-		vector<DatacenterType*> allDatacenters, 
-		double serverCapacity,
-		vector<ClientType*> sessionClients,
-		int GDatacenterID)
-	{
-		double costServer = 0, costBandwidth = 0, numberServers = 0;
-		for (auto dc : allDatacenters)
+		for (size_t j = 0; j < clientDelayOfSession.size(); j++) // capacities
 		{
-			//dc->openServerCount = ceil(dc->assignedClientList.size() / serverCapacity);
-			dc->openServerCount = ceil(double(dc->assignedClients.size()) / serverCapacity);
-			numberServers += dc->openServerCount;
-			costServer += dc->priceServer * dc->openServerCount;
-			double totalChargedTrafficVolume = 0;
-			for (auto client : dc->assignedClients)
+			for (size_t i = 0; i < clientDelayOfSession.at(j).size(); i++) // columns
 			{
-				totalChargedTrafficVolume += client->chargedTrafficVolume;
+				for (auto delay : clientDelayOfSession.at(j).at(i)) clientDelay.at(j).at(i).Add(delay);
+				for (auto utilization : serverUtilizationOfSession.at(j).at(i)) serverUtilization.at(j).at(i).Add(utilization);
 			}
-			costBandwidth += dc->priceBandwidth * totalChargedTrafficVolume;
 		}
+	}
 
-		double totalDelay = 0;
-		for (auto client : sessionClients)
+	void OutcomeStatisticsType::AddUnprovenOptimal(const vector<int> &unprovenOptimalOfSession)
+	{
+		if (unprovenOptimalCount.size() < unprovenOptimalOfSession.size()) unprovenOptimalCount.resize(unprovenOptimalOfSession.size(), 0);
+		for (size_t j = 0; j < unprovenOptimalOfSession.size(); j++) // capacities
 		{
-			totalDelay += client->delayToDatacenter[client->assignedDatacenterID] + allDatacenters.at(client->assignedDatacenterID)->delayToDatacenter[GDatacenterID];
+			unprovenOptimalCount.at(j) += unprovenOptimalOfSession.at(j);
 		}
-
-		return tuple<double, double, double, double, double>(
-			costServer + costBandwidth,
-			costServer,
-			costBandwidth,
-			(numberServers * serverCapacity - sessionClients.size()) / sessionClients.size(),
-			totalDelay / sessionClients.size());
 	}
 
-	// return true if and only if all clients are assigned and each client is assigned to one dc
-	bool CheckIfAllClientsExactlyAssigned(vector<ClientType*> sessionClients, vector<DatacenterType*> allDatacenters)
+	void OutcomeStatisticsType::Merge(const OutcomeStatisticsType &other)
 	{
-		for (auto c : sessionClients)
+		if (costTotal.empty())
 		{
-			bool validAssignment = false;
-			for (auto edc : c->eligibleDatacenters)
+			*this = other;
+			return;
+		}
+
+		if (clientDelay.empty())
+		{
+			clientDelay = other.clientDelay;
+			serverUtilization = other.serverUtilization;
+		}
+		else
+		{
+			for (size_t j = 0; j < other.clientDelay.size(); j++)
 			{
-				if (c->assignedDatacenterID == edc->id)
+				for (size_t i = 0; i < other.clientDelay.at(j).size(); i++)
 				{
-					validAssignment = true;
-					break;
+					clientDelay.at(j).at(i).Merge(other.clientDelay.at(j).at(i));
+					serverUtilization.at(j).at(i).Merge(other.serverUtilization.at(j).at(i));
 				}
 			}
-			if (!validAssignment)
-				return false;
 		}
 
-		int totalAssignedClientCount = 0;
-		for (auto d : allDatacenters)
+		for (size_t j = 0; j < other.costTotal.size(); j++)
 		{
-			//totalAssignedClientCount += (int)d->assignedClientList.size();
-			totalAssignedClientCount += (int)d->assignedClients.size();
+			for (size_t i = 0; i < other.costTotal.at(j).size(); i++)
+			{
+				costTotal.at(j).at(i).Merge(other.costTotal.at(j).at(i));
+				capacityWastage.at(j).at(i).Merge(other.capacityWastage.at(j).at(i));
+				averageDelay.at(j).at(i).Merge(other.averageDelay.at(j).at(i));
+				computation.at(j).at(i).Merge(other.computation.at(j).at(i));
+			}
 		}
-		return (totalAssignedClientCount == (int)sessionClients.size());
+		if (unprovenOptimalCount.size() < other.unprovenOptimalCount.size()) unprovenOptimalCount.resize(other.unprovenOptimalCount.size(), 0);
+		for (size_t j = 0; j < other.unprovenOptimalCount.size(); j++)
+		{
+			unprovenOptimalCount.at(j) += other.unprovenOptimalCount.at(j);
+		}
+		sessionCount += other.sessionCount;
+		cachedSessionCount += other.cachedSessionCount;
 	}
 
-	bool Initialize(string dataDirectory, vector<ClientType*> &allClients, vector<DatacenterType*> &allDatacenters)
+	string SerializeSessionResult(int sessionID, const SessionResultType &result)
 	{
-		/* temporary stuff */
-		vector<vector<double>> ClientToDatacenterDelayMatrix;
-		vector<vector<double>> InterDatacenterDelayMatrix;
-		vector<double> priceServerList;
-		vector<double> priceBandwidthList;
-		
-		/* client-to-dc latency data */
-		auto strings_read = ReadDelimitedTextFileIntoVector(dataDirectory + "dc_to_pl_rtt.csv", ',', true);
-		if (strings_read.empty())
-		{	
-			printf("ERROR: empty file!\n");
-			cin.get();
-			return false;
-		}
-		for (auto row : strings_read)
+		ostringstream line;
+		line.precision(17);
+		line << sessionID << " " << result.GDatacenterID << " " << result.eligibleGDatacenterCount << " " << result.matchmakingTime;
+
+		line << " " << result.outcome.size();
+		for (auto &outcomeAtOneCapacity : result.outcome)
+		{
+			line << " " << outcomeAtOneCapacity.size();
+			for (auto &outcome : outcomeAtOneCapacity)
+			{
+				line << " " << get<0>(outcome) << " " << get<1>(outcome) << " " << get<2>(outcome) << " " << get<3>(outcome) << " " << get<4>(outcome);
+			}
+		}
+
+		line << " " << result.computation.size();
+		for (auto &computationAtOneCapacity : result.computation)
+		{
+			line << " " << computationAtOneCapacity.size();
+			for (auto computation : computationAtOneCapacity) line << " " << computation;
+		}
+
+		line << " " << result.finalGDatacenter.size();
+		for (auto &finalGDatacenterAtOneCapacity : result.finalGDatacenter)
+		{
+			line << " " << finalGDatacenterAtOneCapacity.size();
+			for (auto finalGDatacenter : finalGDatacenterAtOneCapacity) line << " " << finalGDatacenter;
+		}
+
+		auto WriteValuesOfCells = [&line](const vector<vector<vector<double>>> &valuesOfCells) // indexed by [capacity][strategy][k]
+		{
+			line << " " << valuesOfCells.size();
+			for (auto &valuesAtOneCapacity : valuesOfCells)
+			{
+				line << " " << valuesAtOneCapacity.size();
+				for (auto &valuesOfOneStrategy : valuesAtOneCapacity)
+				{
+					line << " " << valuesOfOneStrategy.size();
+					for (auto value : valuesOfOneStrategy) line << " " << value;
+				}
+			}
+		};
+
+		WriteValuesOfCells(result.serverCountPerDC);
+
+		line << " " << result.eligibleRDatacenterCount.size();
+		for (auto count : result.eligibleRDatacenterCount) line << " " << count;
+
+		WriteValuesOfCells(result.clientDelay);
+		WriteValuesOfCells(result.serverUtilization);
+
+		line << " " << result.unprovenOptimal.size();
+		for (auto unproven : result.unprovenOptimal) line << " " << unproven;
+
+		line << " end";
+
+		return line.str();
+	}
+
+	bool DeserializeSessionResult(const string &line, int &sessionID, SessionResultType &result)
+	{
+		istringstream lineStream(line);
+		result = SessionResultType();
+		size_t size1, size2, size3;
+
+		lineStream >> sessionID >> result.GDatacenterID >> result.eligibleGDatacenterCount >> result.matchmakingTime;
+
+		lineStream >> size1;
+		result.outcome.resize(lineStream ? size1 : 0);
+		for (auto &outcomeAtOneCapacity : result.outcome)
+		{
+			lineStream >> size2;
+			outcomeAtOneCapacity.resize(lineStream ? size2 : 0);
+			for (auto &outcome : outcomeAtOneCapacity)
+			{
+				lineStream >> get<0>(outcome) >> get<1>(outcome) >> get<2>(outcome) >> get<3>(outcome) >> get<4>(outcome);
+			}
+		}
+
+		lineStream >> size1;
+		result.computation.resize(lineStream ? size1 : 0);
+		for (auto &computationAtOneCapacity : result.computation)
+		{
+			lineStream >> size2;
+			computationAtOneCapacity.resize(lineStream ? size2 : 0);
+			for (auto &computation : computationAtOneCapacity) lineStream >> computation;
+		}
+
+		lineStream >> size1;
+		result.finalGDatacenter.resize(lineStream ? size1 : 0);
+		for (auto &finalGDatacenterAtOneCapacity : result.finalGDatacenter)
+		{
+			lineStream >> size2;
+			finalGDatacenterAtOneCapacity.resize(lineStream ? size2 : 0);
+			for (auto &finalGDatacenter : finalGDatacenterAtOneCapacity) lineStream >> finalGDatacenter;
+		}
+
+		auto ReadValuesOfCells = [&](vector<vector<vector<double>>> &valuesOfCells) // indexed by [capacity][strategy][k]
+		{
+			lineStream >> size1;
+			valuesOfCells.resize(lineStream ? size1 : 0);
+			for (auto &valuesAtOneCapacity : valuesOfCells)
+			{
+				lineStream >> size2;
+				valuesAtOneCapacity.resize(lineStream ? size2 : 0);
+				for (auto &valuesOfOneStrategy : valuesAtOneCapacity)
+				{
+					lineStream >> size3;
+					valuesOfOneStrategy.resize(lineStream ? size3 : 0);
+					for (auto &value : valuesOfOneStrategy) lineStream >> value;
+				}
+			}
+		};
+
+		ReadValuesOfCells(result.serverCountPerDC);
+
+		lineStream >> size1;
+		result.eligibleRDatacenterCount.resize(lineStream ? size1 : 0);
+		for (auto &count : result.eligibleRDatacenterCount) lineStream >> count;
+
+		ReadValuesOfCells(result.clientDelay);
+		ReadValuesOfCells(result.serverUtilization);
+
+		lineStream >> size1;
+		result.unprovenOptimal.resize(lineStream ? size1 : 0);
+		for (auto &unproven : result.unprovenOptimal) lineStream >> unproven;
+
+		string endMarker, rest;
+		lineStream >> endMarker;
+		return !lineStream.fail() && "end" == endMarker && !(lineStream >> rest); // all fields read and nothing left
+	}
+
+	string GetBuildID()
+	{
+		static const string buildID = []
+		{
+			string executablePath;
+#ifdef _WIN32
+			char *path = nullptr;
+			if (0 == _get_pgmptr(&path) && nullptr != path) executablePath = path;
+#else
+			executablePath = "/proc/self/exe";
+#endif
+			ifstream file(executablePath, std::ios::binary);
+			if (!file.is_open()) return string("built ") + __DATE__ + " " + __TIME__;
+
+			unsigned long long hash = MixBits64(SPLITMIX64_GAMMA);
+			char buffer[65536];
+			while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+			{
+				for (std::streamsize k = 0; k < file.gcount(); k++) hash = MixBits64(hash ^ ((unsigned char)buffer[k] + SPLITMIX64_GAMMA));
+			}
+
+			char id[17];
+			snprintf(id, sizeof(id), "%016llx", hash);
+			return string(id);
+		}();
+		return buildID;
+	}
+
+	string GetResultCacheKey(const string &dataDirectory, const string &parameters)
+	{
+		unsigned long long hash = MixBits64(SPLITMIX64_GAMMA);
+		auto HashBytes = [&hash](const string &bytes)
+		{
+			hash = MixBits64(hash ^ (bytes.size() + SPLITMIX64_GAMMA));
+			for (unsigned char byte : bytes) hash = MixBits64(hash ^ (byte + SPLITMIX64_GAMMA));
+		};
+
+		for (string fileName : { "dc_to_pl_rtt.csv", "dc_to_dc_rtt.csv", "dc_pricing_bandwidth_server.csv" }) // the dataset snapshot read by Initialize()
+		{
+			ifstream file(dataDirectory + fileName, std::ios::binary);
+			ostringstream bytes;
+			bytes << file.rdbuf();
+			HashBytes(bytes.str());
+		}
+		HashBytes(parameters);
+		HashBytes(std::to_string(RESULT_CACHE_VERSION) + " " + GetBuildID() + " " + std::to_string(SESSION_RANDOM_SEED));
+
+		char key[17];
+		snprintf(key, sizeof(key), "%016llx", hash);
+		return key;
+	}
+
+	ResultCacheType::ResultCacheType(const string &dataDirectory, const string &key)
+	{
+		Instrumentation::MemoryStructureScopeType memoryScope(Instrumentation::STRUCTURE_RESULTS);
+		_mkdir((dataDirectory + "Output\\cache").c_str());
+		fileName = dataDirectory + "Output\\cache\\" + key + ".txt";
+
+		// the cached lines end at the last line break: after it is the line that was being written when a previous run stopped, if any
+		cachedEnd = 0;
+		inputFile.open(fileName, std::ios::binary);
+		inputFile.seekg(0, std::ios::end);
+		std::streamoff fileSize = inputFile ? (std::streamoff)inputFile.tellg() : 0;
+		char buffer[4096];
+		for (std::streamoff chunkEnd = fileSize; chunkEnd > 0 && 0 == cachedEnd;) // backwards, chunk by chunk, to the last line break
+		{
+			std::streamoff chunkStart = std::max(chunkEnd - (std::streamoff)sizeof(buffer), (std::streamoff)0);
+			inputFile.seekg(chunkStart);
+			inputFile.read(buffer, chunkEnd - chunkStart);
+			for (std::streamoff k = chunkEnd - chunkStart; k > 0 && 0 == cachedEnd; k--)
+			{
+				if ('\n' == buffer[k - 1]) cachedEnd = chunkStart + k;
+			}
+			chunkEnd = chunkStart;
+		}
+		inputFile.clear();
+		inputFile.seekg(0);
+		hasNextLine = false;
+		nextLineSessionID = 0;
+
+		// keep the file open for appending the new sessions (the cached ones are not written again)
+		file.open(fileName, std::ios::app);
+		if (cachedEnd < fileSize) file << "\n"; // end the incomplete line, which has no end marker, so that the next session starts a line of its own
+		file.flush();
+	}
+
+	bool ResultCacheType::ReadCachedResult(int sessionID, SessionResultType &result)
+	{
+		while (true)
+		{
+			if (!hasNextLine)
+			{
+				if (!inputFile.is_open() || (std::streamoff)inputFile.tellg() >= cachedEnd || !std::getline(inputFile, nextLine)) return false; // no more cached lines
+				hasNextLine = true;
+				if (!(istringstream(nextLine) >> nextLineSessionID)) nextLineSessionID = INT_MIN; // passed below
+			}
+
+			if (nextLineSessionID > sessionID) return false; // the next cached session is a later one
+			hasNextLine = false;
+			if (nextLineSessionID < sessionID) continue; // an earlier session (or a duplicate, or a line that cannot be read)
+
+			int cachedSessionID;
+			if (DeserializeSessionResult(nextLine, cachedSessionID, result))
+			{
+				result.isCached = true;
+				return true;
+			}
+		}
+	}
+
+	void ResultCacheType::Append(int sessionID, const SessionResultType &result)
+	{
+		string line = SerializeSessionResult(sessionID, result);
+		std::lock_guard<std::mutex> lock(fileMutex);
+		file << line << "\n";
+		file.flush(); // a checkpoint after every consumed session
+	}
+
+	vector<int> GetOperationCountColumns(const LocalSearchSettingType &localSearchSetting, const OptimalSettingType &optimalSetting)
+	{
+		vector<int> columns;
+		for (int column = 0; column < GetColumnCount(localSearchSetting, optimalSetting); column++)
+		{
+			columns.push_back((column < GetBaseColumnCount(optimalSetting)) ? column + 1 : STRATEGY_COUNT + column - GetBaseColumnCount(optimalSetting) + 1);
+		}
+		return columns;
+	}
+
+	string GetSimulationParameters(string problem, double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R, double SESSION_SIZE, const vector<double> &SERVER_CAPACITY_LIST, bool capacityParametric, const LocalSearchSettingType &localSearchSetting, const OptimalSettingType &optimalSetting)
+	{
+		ostringstream parameters;
+		parameters.precision(17);
+		parameters << problem << " " << DELAY_BOUND_TO_G << " " << DELAY_BOUND_TO_R << " " << SESSION_SIZE << " capacities";
+		for (auto capacity : SERVER_CAPACITY_LIST) parameters << " " << capacity;
+		parameters << " parametric " << capacityParametric << " LS " << localSearchSetting.enabled << " " << localSearchSetting.iterationBudget << " " << localSearchSetting.timeBudget;
+		parameters << " OPT " << optimalSetting.enabled << " " << optimalSetting.timeBudget;
+		return parameters.str();
+	}
+
+	// run the given tasks in the given order on threadCount worker threads (the calling thread is one of them)
+	// each worker has its own copy of the given clients and datacenters (its scratch state), which is passed to each task it runs
+	// return false if any task fails (the remaining tasks are not started)
+	bool RunTasksWithWorkspaces(
+		const vector<int> &tasks,
+		int threadCount,
+		const vector<ClientType*> &clients,
+		const vector<DatacenterType*> &datacenters,
+		const std::function<bool(int, WorkspaceType &)> &RunTask)
+	{
+		std::atomic<size_t> nextTask(0);
+		std::atomic<bool> isFailed(false);
+		auto memoryStructure = Instrumentation::GetCurrentMemoryStructure(); // of the workspaces (the tasks may have their own)
+		auto Worker = [&]()
+		{
+			Instrumentation::MemoryStructureScopeType memoryScope(memoryStructure);
+			WorkspaceType workspace(clients, datacenters);
+			while (!isFailed)
+			{
+				size_t next = nextTask++;
+				if (next >= tasks.size()) break;
+
+				if (!RunTask(tasks.at(next), workspace)) isFailed = true;
+			}
+		};
+
+		threadCount = std::max(1, std::min(threadCount, (int)tasks.size()));
+		vector<std::thread> workers;
+		for (int i = 1; i < threadCount; i++)
+		{
+			workers.push_back(std::thread(Worker));
+		}
+		Worker();
+		for (auto &worker : workers)
+		{
+			worker.join();
+		}
+
+		return !isFailed;
+	}
+
+	// matchmaking for basic problem
+	// result: the datacenter for hosting the G-server, and a list of clients to be involved
+	// return true if found
+	bool Matchmaking4BasicProblem(vector<DatacenterType*> allDatacenters,
+		vector<ClientType*> allClients,
+		int &GDatacenterID,
+		vector<ClientType*> &sessionClients,
+		double SESSION_SIZE,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R)
+	{
+		Instrumentation::PhaseTimerType timer(Instrumentation::PHASE_MATCHMAKING);
+
+		ResetEligibiltyCoverability(allClients, allDatacenters);
+		sessionClients.clear();
+
+		CounterRandomType GDatacenterOrderRandom = GetSessionRandom(RANDOM_PURPOSE_G_DATACENTER_ORDER);
+		Shuffle(allDatacenters.begin(), allDatacenters.end(), GDatacenterOrderRandom); // for randomizing each session's G-server selection process	
+
+		for (auto Gdc : allDatacenters) // iterating all datacenters until we find an eligible G datacenter
+		{
+			CounterRandomType clientOrderRandom = GetSessionRandom(RANDOM_PURPOSE_CLIENT_ORDER, Gdc->id); // for randomizing each session's involved clients
+
+			for (size_t i = 0; i < allClients.size(); i++)
+			{
+				if ((int)sessionClients.size() == SESSION_SIZE) // reach the target session size
+				{
+					GDatacenterID = Gdc->id; // record the G datacenter id
+					return true; // succeed
+				}
+
+				ShuffleNext(allClients.begin() + i, allClients.end(), clientOrderRandom); // shuffling lazily, only as far as the clients are looked at
+				auto client = allClients.at(i);
+
+				for (auto dc : allDatacenters)
+				{
+					if ((client->delayToDatacenter[dc->id] + dc->delayToDatacenter[Gdc->id]) <= DELAY_BOUND_TO_G
+						&& client->delayToDatacenter[dc->id] <= DELAY_BOUND_TO_R)
+					{
+						//client->eligibleDatacenterList.push_back(tuple<int, double, double, double, double>(dc->id, client->delayToDatacenter[dc->id], dc->priceServer, dc->priceBandwidth * client->chargedTrafficVolume, dc->priceCombined));
+						client->eligibleDatacenters.push_back(dc);
+						client->eligibleDatacenterMask.at(dc->id / 64) |= 1ULL << (dc->id % 64);
+
+						//dc->coverableClientList.push_back(client->id);
+						dc->coverableClients.push_back(client);
+					}
+				}
+
+				if (!client->eligibleDatacenters.empty())
+				{
+					RankEligibleDatacenters(client);
+					sessionClients.push_back(client); // put this client into the session 		
+				}
+			}
+
+			// reset for next round of search		
+			ResetEligibiltyCoverability(allClients, allDatacenters);
+			sessionClients.clear();
+		}
+
+		return false;
+	}
+
+	// just to find if there are any eligible datacenters to open GS given the input (candidate datacenters, client group, delay bounds) 
+	// record all of them if found
+	// for general problem
+	void SearchEligibleGDatacenter(vector<DatacenterType*> allDatacenters,
+		vector<ClientType*> sessionClients,
+		vector<DatacenterType*> &eligibleGDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R)
+	{
+		Instrumentation::PhaseTimerType timer(Instrumentation::PHASE_ELIGIBILITY);
+
+		eligibleGDatacenters.clear();
+
+		for (auto GDatacenter : allDatacenters)
+		{
+			bool isValidGDatacenter = true;
+
+			for (auto client : sessionClients)
+			{
+				int numEligibleDC = 0;
+				for (auto dc : allDatacenters)
+				{
+					if ((client->delayToDatacenter[dc->id] + dc->delayToDatacenter[GDatacenter->id]) <= DELAY_BOUND_TO_G &&
+						client->delayToDatacenter[dc->id] <= DELAY_BOUND_TO_R)
+					{
+						numEligibleDC++;
+					}
+				}
+				if (numEligibleDC < 1)
+				{
+					isValidGDatacenter = false; // found a client that has no eligible R-server locations given this G-server location, so this G-server location is invalid
+					break;
+				}
+			}
+
+			if (isValidGDatacenter)	eligibleGDatacenters.push_back(GDatacenter); // put it into the list				
+		}
+	}
+
+	// result: a list of datacenters that are eligible for hosting the G-server, and a list of clients to be involved 
+	// return true if found
+	// for general problem
+	bool Matchmaking4GeneralProblem(vector<DatacenterType*> allDatacenters,
+		vector<ClientType*> allClients,
+		vector<ClientType*> &sessionClients,
+		vector<DatacenterType*> &eligibleGDatacenters,
+		double SESSION_SIZE,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R)
+	{
+		ResetEligibiltyCoverability(allClients, allDatacenters);
+		sessionClients.clear();
+		eligibleGDatacenters.clear();
+
+		int initialGDatacenter; // just for satisfying MatchmakingBasicProblem's parameters
+		if (Matchmaking4BasicProblem(allDatacenters, allClients, initialGDatacenter, sessionClients, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R))
+		{
+			SearchEligibleGDatacenter(allDatacenters, sessionClients, eligibleGDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
+		}
+
+		return (!sessionClients.empty() && !eligibleGDatacenters.empty());
+	}
+
+	// used inside each strategy function
+	// for general problem
+	void SimulationSetup4GeneralProblem(DatacenterType *GDatacenter, vector<ClientType*> sessionClients, vector<DatacenterType*> allDatacenters, double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R)
+	{
+		Instrumentation::PhaseTimerType timer(Instrumentation::PHASE_ELIGIBILITY);
+
+		ResetEligibiltyCoverability(sessionClients, allDatacenters);
+
+		COUNT_OPERATIONS(OPERATION_ELIGIBILITY_CHECKS, sessionClients.size() * allDatacenters.size());
+		COUNT_OPERATIONS(OPERATION_MAP_LOOKUPS, 2 * sessionClients.size() * allDatacenters.size()); // the second delay bound's lookup is counted when it is evaluated
+		for (auto client : sessionClients) // find eligible datacenters for each client and coverable clients for each dc
+		{
+			for (auto dc : allDatacenters)
+			{
+				if ((client->delayToDatacenter[dc->id] + dc->delayToDatacenter[GDatacenter->id]) <= DELAY_BOUND_TO_G && (COUNT_OPERATIONS(OPERATION_MAP_LOOKUPS, 1), client->delayToDatacenter[dc->id] <= DELAY_BOUND_TO_R))
+				{
+					//client->eligibleDatacenterList.push_back(tuple<int, double, double, double, double>(dc->id, client->delayToDatacenter[dc->id], dc->priceServer, dc->priceBandwidth, dc->priceCombined)); // record eligible dc's id, delay, priceServer, priceBandwidth, priceCombined
+					client->eligibleDatacenters.push_back(dc);
+					client->eligibleDatacenterMask.at(dc->id / 64) |= 1ULL << (dc->id % 64);
+
+					//dc->coverableClientList.push_back(client->id);
+					dc->coverableClients.push_back(client);
+				}
+			}
+			RankEligibleDatacenters(client);
+		}
+	}
+
+	// include G-server's cost into the total cost according to the group size
+	// used inside the following strategy functions
+	// for general problem only
+	void IncludeGServerCost(DatacenterType *GDatacenter, double SESSION_SIZE, bool includingGServerCost, double &tempTotalCost)
+	{
+		if (includingGServerCost)
+		{
+			if (SESSION_SIZE <= 20)
+				tempTotalCost += GDatacenter->priceServer / 8;
+			else if (SESSION_SIZE <= 40)
+				tempTotalCost += GDatacenter->priceServer / 4;
+			else if (SESSION_SIZE <= 80)
+				tempTotalCost += GDatacenter->priceServer / 2;
+			else
+				tempTotalCost += GDatacenter->priceServer;
+		}
+	}
+
+	// server capacity known at compile time (CAPACITY > 0) or only at run time (CAPACITY = 0)
+	// the strategies are compiled once per common capacity (see RunPolicy4BasicProblem), so that the divisions and moduli by the capacity in their loops fold to constants
+	template <int CAPACITY>
+	struct CapacityType
+	{
+		double value; // used only if CAPACITY = 0
+
+		explicit CapacityType(double givenValue = CAPACITY)
+		{
+			this->value = givenValue;
+		}
+
+		double Real() const { return CAPACITY > 0 ? (double)CAPACITY : value; }
+		int Integer() const { return CAPACITY > 0 ? CAPACITY : (int)value; }
+		double ServerCount(size_t clientCount) const { return CAPACITY > 0 ? (double)((clientCount + CAPACITY - 1) / CAPACITY) : ceil(double(clientCount) / value); } // whole servers for the given clients
+	};
+
+	// GetSolutionOutput at a compile-time or run-time capacity
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> GetSolutionOutput(
+		const vector<DatacenterType*> &allDatacenters,
+		CapacityType<CAPACITY> serverCapacity,
+		const vector<ClientType*> &sessionClients,
+		int GDatacenterID)
+	{
+		double costServer = 0, costBandwidth = 0, numberServers = 0;
+		for (auto dc : allDatacenters)
+		{
+			//dc->openServerCount = ceil(dc->assignedClientList.size() / serverCapacity);
+			dc->openServerCount = serverCapacity.ServerCount(dc->assignedClients.size());
+			numberServers += dc->openServerCount;
+			costServer += dc->priceServer * dc->openServerCount;
+			double totalChargedTrafficVolume = 0;
+			for (auto client : dc->assignedClients)
+			{
+				totalChargedTrafficVolume += client->chargedTrafficVolume;
+			}
+			costBandwidth += dc->priceBandwidth * totalChargedTrafficVolume;
+		}
+
+		double totalDelay = 0;
+		COUNT_OPERATIONS(OPERATION_MAP_LOOKUPS, 2 * sessionClients.size());
+		for (auto client : sessionClients)
+		{
+			totalDelay += client->delayToDatacenter[client->assignedDatacenterID] + allDatacenters.at(client->assignedDatacenterID)->delayToDatacenter[GDatacenterID];
+		}
+
+		return tuple<double, double, double, double, double>(
+			costServer + costBandwidth,
+			costServer,
+			costBandwidth,
+			(numberServers * serverCapacity.Real() - sessionClients.size()) / sessionClients.size(),
+			totalDelay / sessionClients.size());
+	}
+
+	// function to get the solution output 
+	// return <cost_total, cost_server, cost_bandwidth, capacity_wastage, average_delay>
+	tuple<double, double, double, double, double> GetSolutionOutput(
+		vector<DatacenterType*> allDatacenters, 
+		double serverCapacity,
+		vector<ClientType*> sessionClients,
+		int GDatacenterID)
+	{
+		return GetSolutionOutput(allDatacenters, CapacityType<0>(serverCapacity), sessionClients, GDatacenterID);
+	}
+
+	// function to get the solution output at each of the given capacities from the current assignment (which must be shared by all these capacities)
+	// fractional server count is used if isLowerBound is true (as in Alg_LB)
+	// return one <cost_total, cost_server, cost_bandwidth, capacity_wastage, average_delay> per capacity
+	vector<tuple<double, double, double, double, double>> GetSolutionOutputAtCapacities(
+		const vector<DatacenterType*> &allDatacenters,
+		const vector<double> &capacities,
+		const vector<ClientType*> &sessionClients,
+		int GDatacenterID,
+		bool isLowerBound)
+	{
+		// bandwidth cost and delay do not depend on server capacity, so they are computed only once
+		double costBandwidth = 0;
+		for (auto dc : allDatacenters)
+		{
+			double totalChargedTrafficVolume = 0;
+			for (auto client : dc->assignedClients)
+			{
+				totalChargedTrafficVolume += client->chargedTrafficVolume;
+			}
+			costBandwidth += dc->priceBandwidth * totalChargedTrafficVolume;
+		}
+
+		double totalDelay = 0;
+		COUNT_OPERATIONS(OPERATION_MAP_LOOKUPS, 2 * sessionClients.size());
+		for (auto client : sessionClients)
+		{
+			totalDelay += client->delayToDatacenter[client->assignedDatacenterID] + allDatacenters.at(client->assignedDatacenterID)->delayToDatacenter[GDatacenterID];
+		}
+
+		vector<tuple<double, double, double, double, double>> outcomes;
+		for (auto serverCapacity : capacities)
+		{
+			double costServer = 0, numberServers = 0;
+			for (auto dc : allDatacenters)
+			{
+				double openServerCount = isLowerBound ? double(dc->assignedClients.size()) / serverCapacity : ceil(double(dc->assignedClients.size()) / serverCapacity);
+				numberServers += openServerCount;
+				costServer += dc->priceServer * openServerCount;
+			}
+
+			outcomes.push_back(tuple<double, double, double, double, double>(
+				costServer + costBandwidth,
+				costServer,
+				costBandwidth,
+				isLowerBound ? 0 : (numberServers * serverCapacity - sessionClients.size()) / sessionClients.size(),
+				totalDelay / sessionClients.size()));
+		}
+
+		return outcomes;
+	}
+
+	void GetDelayAndUtilization(
+		const vector<DatacenterType*> &allDatacenters,
+		double serverCapacity,
+		const vector<ClientType*> &sessionClients,
+		int GDatacenterID,
+		vector<double> &clientDelay,
+		vector<double> &serverUtilization,
+		bool isLowerBound)
+	{
+		clientDelay.clear();
+		for (auto client : sessionClients)
+		{
+			clientDelay.push_back(client->delayToDatacenter[client->assignedDatacenterID] + allDatacenters.at(client->assignedDatacenterID)->delayToDatacenter[GDatacenterID]);
+		}
+
+		serverUtilization.clear();
+		for (auto dc : allDatacenters)
+		{
+			if (dc->assignedClients.empty()) continue;
+			double openServerCount = isLowerBound ? double(dc->assignedClients.size()) / serverCapacity : ceil(double(dc->assignedClients.size()) / serverCapacity);
+			serverUtilization.push_back(dc->assignedClients.size() / (openServerCount * serverCapacity));
+		}
+	}
+
+	// group the capacities (indices into the capacity list) such that the ranking of all datacenters by combined price is the same within each group
+	// LB and LCP make the same assignment at every capacity of a group, because their choices only change at the price breakpoints
+	vector<vector<size_t>> GroupCapacitiesByPriceBreakpoints(
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		const vector<double> &SERVER_CAPACITY_LIST)
+	{
+		vector<double> trafficVolumes; // distinct charged traffic volumes in this session (the ranking depends on it as well)
+		for (auto client : sessionClients)
+		{
+			if (std::find(trafficVolumes.begin(), trafficVolumes.end(), client->chargedTrafficVolume) == trafficVolumes.end())
+			{
+				trafficVolumes.push_back(client->chargedTrafficVolume);
+			}
+		}
+
+		vector<vector<size_t>> capacityGroups;
+		vector<vector<int>> rankingOfGroups;
+		for (size_t i = 0; i < SERVER_CAPACITY_LIST.size(); i++)
+		{
+			// rank of each dc = number of dcs with strictly lower combined price (so that ties share the same rank)
+			vector<int> ranking;
+			for (auto volume : trafficVolumes)
+			{
+				vector<double> priceCombined;
+				for (auto dc : allDatacenters)
+				{
+					priceCombined.push_back(dc->priceServer / SERVER_CAPACITY_LIST.at(i) + dc->priceBandwidth * volume);
+				}
+				for (auto price : priceCombined)
+				{
+					ranking.push_back((int)std::count_if(priceCombined.begin(), priceCombined.end(), [price](double p) { return p < price; }));
+				}
+			}
+
+			auto it = std::find(rankingOfGroups.begin(), rankingOfGroups.end(), ranking);
+			if (it == rankingOfGroups.end())
+			{
+				rankingOfGroups.push_back(ranking);
+				capacityGroups.push_back(vector<size_t>(1, i));
+			}
+			else
+			{
+				capacityGroups.at(it - rankingOfGroups.begin()).push_back(i);
+			}
+		}
+
+		return capacityGroups;
+	}
+
+	// sort all datacenters by the given price criterion (combined price = priceServer / serverCapacity + priceBandwidth * chargedTrafficVolume)
+	// computed once per capacity (and traffic volume) instead of recomputing the prices in every comparison
+	PriceOrderType SortDatacentersByPrice(
+		const vector<DatacenterType*> &allDatacenters,
+		PriceCriterion criterion,
+		double serverCapacity,
+		double chargedTrafficVolume)
+	{
+		vector<pair<double, DatacenterType*>> pricedDatacenters;
+		for (auto dc : allDatacenters)
+		{
+			double price;
+			if (PRICE_SERVER == criterion)
+				price = dc->priceServer;
+			else if (PRICE_BANDWIDTH == criterion)
+				price = dc->priceBandwidth;
+			else
+				price = dc->priceServer / serverCapacity + dc->priceBandwidth * chargedTrafficVolume;
+			pricedDatacenters.push_back(pair<double, DatacenterType*>(price, dc));
+		}
+		std::stable_sort(pricedDatacenters.begin(), pricedDatacenters.end(),
+			[](const pair<double, DatacenterType*> &a, const pair<double, DatacenterType*> &b) { return a.first < b.first; });
+
+		PriceOrderType priceOrder;
+		for (size_t i = 0; i < pricedDatacenters.size(); i++)
+		{
+			priceOrder.datacenters.push_back(pricedDatacenters.at(i).second);
+			if (0 == i)
+				priceOrder.tieGroup.push_back(0);
+			else if (pricedDatacenters.at(i).first == pricedDatacenters.at(i - 1).first)
+				priceOrder.tieGroup.push_back(priceOrder.tieGroup.back());
+			else
+				priceOrder.tieGroup.push_back(priceOrder.tieGroup.back() + 1);
+		}
+
+		return priceOrder;
+	}
+
+	// rank the client's eligible dcs by delay and then by position in its eligibleDatacenters, once its eligibility is known
+	// so that a tie in price costs one vector lookup per dc instead of two map lookups and two scans of eligibleDatacenters
+	void RankEligibleDatacenters(ClientType *client)
+	{
+		COUNT_OPERATIONS(OPERATION_MAP_LOOKUPS, client->eligibleDatacenters.size());
+		vector<pair<double, size_t>> delayedPositions; // (delay, position in eligibleDatacenters)
+		for (size_t k = 0; k < client->eligibleDatacenters.size(); k++)
+		{
+			delayedPositions.push_back(make_pair(client->delayToDatacenter.at(client->eligibleDatacenters[k]->id), k));
+		}
+		std::sort(delayedPositions.begin(), delayedPositions.end());
+
+		client->eligibleDatacenterRank.assign(client->eligibleDatacenterMask.size() * 64, -1);
+		for (size_t rank = 0; rank < delayedPositions.size(); rank++)
+		{
+			int id = client->eligibleDatacenters[delayedPositions[rank].second]->id;
+			if (client->eligibleDatacenterRank[id] < 0) client->eligibleDatacenterRank[id] = (int)rank; // a dc listed twice keeps its first position, as std::find did
+		}
+	}
+
+	// return the first dc in the price order that is eligible for the client (early-exit scan using the client's eligibility mask)
+	// ties in price are broken by the client's eligibleDatacenterRank, i.e. by lower delay and then by the position in its eligibleDatacenters (same as the original pairwise comparisons)
+	DatacenterType* GetFirstEligibleDatacenter(const ClientType *client, const PriceOrderType &priceOrder)
+	{
+		DatacenterType* chosenDC = nullptr;
+		int chosenTieGroup = -1;
+		for (size_t i = 0; i < priceOrder.datacenters.size(); i++)
+		{
+			if (chosenDC != nullptr && priceOrder.tieGroup[i] != chosenTieGroup) break; // all the remaining dcs are more expensive
+
+			auto dc = priceOrder.datacenters[i];
+			if (!client->IsEligible(dc->id)) continue;
+
+			if (nullptr == chosenDC)
+			{
+				chosenDC = dc;
+				chosenTieGroup = priceOrder.tieGroup[i];
+			}
+			else if (client->eligibleDatacenterRank[dc->id] < client->eligibleDatacenterRank[chosenDC->id])
+			{
+				chosenDC = dc;
+			}
+		}
+
+		return chosenDC;
+	}
+
+	// return true if and only if all clients are assigned and each client is assigned to one dc
+	bool CheckIfAllClientsExactlyAssigned(vector<ClientType*> sessionClients, vector<DatacenterType*> allDatacenters)
+	{
+		Instrumentation::PhaseTimerType timer(Instrumentation::PHASE_VALIDATION);
+
+		for (auto c : sessionClients)
+		{
+			bool validAssignment = false;
+			for (auto edc : c->eligibleDatacenters)
+			{
+				if (c->assignedDatacenterID == edc->id)
+				{
+					validAssignment = true;
+					break;
+				}
+			}
+			if (!validAssignment)
+				return false;
+		}
+
+		int totalAssignedClientCount = 0;
+		for (auto d : allDatacenters)
+		{
+			//totalAssignedClientCount += (int)d->assignedClientList.size();
+			totalAssignedClientCount += (int)d->assignedClients.size();
+		}
+		return (totalAssignedClientCount == (int)sessionClients.size());
+	}
+
+	bool Initialize(string dataDirectory, vector<ClientType*> &allClients, vector<DatacenterType*> &allDatacenters)
+	{
+		Instrumentation::PhaseTimerType timer(Instrumentation::PHASE_LOAD);
+		Instrumentation::MemoryStructureScopeType memoryScope(Instrumentation::STRUCTURE_TOPOLOGY);
+
+		/* temporary stuff */
+		vector<vector<double>> ClientToDatacenterDelayMatrix;
+		vector<vector<double>> InterDatacenterDelayMatrix;
+		vector<double> priceServerList;
+		vector<double> priceBandwidthList;
+		
+		/* client-to-dc latency data */
+		auto strings_read = ReadDelimitedTextFileIntoVector(dataDirectory + "dc_to_pl_rtt.csv", ',', true);
+		if (strings_read.empty())
+		{	
+			printf("ERROR: empty file!\n");
+			cin.get();
+			return false;
+		}
+		for (auto row : strings_read)
+		{
+			vector<double> ClientToDatacenterDelayMatrixOneRow;
+			for (size_t col = 1; col < row.size(); col++)
+			{
+				ClientToDatacenterDelayMatrixOneRow.push_back(stod(row.at(col)) / 2);
+			}
+			ClientToDatacenterDelayMatrix.push_back(ClientToDatacenterDelayMatrixOneRow);
+		}
+
+		/*dc-to-dc latency data*/
+		strings_read = ReadDelimitedTextFileIntoVector(dataDirectory + "dc_to_dc_rtt.csv", ',', true);
+		if (strings_read.empty())
+		{
+			printf("ERROR: empty file!\n");
+			cin.get();
+			return false;
+		}
+		for (auto row : strings_read)
+		{
+			vector<double> InterDatacenterDelayMatrixOneRow;
+			for (size_t col = 1; col < row.size(); col++)
+			{
+				InterDatacenterDelayMatrixOneRow.push_back(stod(row.at(col)) / 2);
+			}
+			InterDatacenterDelayMatrix.push_back(InterDatacenterDelayMatrixOneRow);
+		}
+		const int totalClientCount = int(ClientToDatacenterDelayMatrix.size());
+
+		/* bandwidth and server price data */
+		strings_read = ReadDelimitedTextFileIntoVector(dataDirectory + "dc_pricing_bandwidth_server.csv", ',', true);
+		if (strings_read.empty())
+		{
+			printf("ERROR: empty file!\n");
+			cin.get();
+			return false;
+		}
+		for (auto row : strings_read)
+		{
+			priceBandwidthList.push_back(stod(row.at(1)));
+			priceServerList.push_back(stod(row.at(2))); // 2: g2.8xlarge, 3: g2.2xlarge
+		}
+		const int totalDatacenterCount = int(ClientToDatacenterDelayMatrix.front().size());
+
+		/* creating clients */
+		allClients.clear();
+		for (int i = 0; i < totalClientCount; i++)
+		{
+			ClientType* client = new ClientType(i);
+			client->chargedTrafficVolume = 2;
+			for (int j = 0; j < totalDatacenterCount; j++)
+			{
+				client->delayToDatacenter[j] = ClientToDatacenterDelayMatrix.at(i).at(j);
+			}
+			allClients.push_back(client);
+		}
+		printf("%d clients created according to the input latency data file\n", int(allClients.size()));
+
+		/* create datacenters */
+		allDatacenters.clear();
+		for (int i = 0; i < totalDatacenterCount; i++)
+		{
+			DatacenterType* dc = new DatacenterType(i);
+			dc->priceServer = priceServerList.at(i);
+			dc->priceBandwidth = priceBandwidthList.at(i);
+			for (auto client : allClients)
+			{
+				dc->delayToClient[client->id] = client->delayToDatacenter[dc->id];
+			}
+			for (int j = 0; j < totalDatacenterCount; j++)
+			{
+				dc->delayToDatacenter[j] = InterDatacenterDelayMatrix.at(i).at(j);
+			}
+			allDatacenters.push_back(dc);
+		}
+		printf("%d datacenters created according to the input latency data file\n", int(allDatacenters.size()));
+
+		return true;
+	}
+
+	void WriteAdaptiveStoppingData(const vector<vector<double>> &sessionCountOfCell, const vector<vector<double>> &relativeHalfWidthOfCell, string dataDirectory, string experimentSettings)
+	{
+		// one row per capacity and one column per strategy, as the costTotalMean file
+		ofstream sessionCountFile(dataDirectory + "Output\\" + experimentSettings + "_" + "sessionCount.csv");
+		ofstream relativeHalfWidthFile(dataDirectory + "Output\\" + experimentSettings + "_" + "costTotalRelativeHalfWidth.csv");
+		for (size_t j = 0; j < sessionCountOfCell.size(); j++)
+		{
+			for (size_t i = 0; i < sessionCountOfCell.at(j).size(); i++)
+			{
+				sessionCountFile << sessionCountOfCell.at(j).at(i) << ",";
+				relativeHalfWidthFile << relativeHalfWidthOfCell.at(j).at(i) << ",";
+			}
+			sessionCountFile << "\n";
+			relativeHalfWidthFile << "\n";
+		}
+		sessionCountFile.close();
+		relativeHalfWidthFile.close();
+	}
+
+	void WriteUnprovenOptimalData(const OutcomeStatisticsType &statistics, string dataDirectory, string experimentSettings)
+	{
+		// one row per capacity
+		ofstream unprovenOptimalFile(dataDirectory + "Output\\" + experimentSettings + "_" + "optUnprovenCount.csv");
+		double unprovenOptimalCount = 0;
+		for (auto count : statistics.unprovenOptimalCount)
+		{
+			unprovenOptimalFile << count << "\n";
+			unprovenOptimalCount += count;
+		}
+		unprovenOptimalFile.close();
+
+		if (unprovenOptimalCount > 0) printf("WARNING: OPT's result is not proven optimal in %d (session, capacity) runs (see %s_optUnprovenCount.csv), so its column is an upper bound there\n", (int)unprovenOptimalCount, experimentSettings.c_str());
+	}
+
+	void WriteCostWastageDelayData(const OutcomeStatisticsType &statistics, string dataDirectory, string experimentSettings)
+	{
+		// one row per capacity and one column per strategy
+		auto WriteMeanAndStd = [&](const vector<vector<StatisticsAccumulatorType>> &statisticsOfCell, string metric)
+		{
+			ofstream meanFile(dataDirectory + "Output\\" + experimentSettings + "_" + metric + "Mean.csv");
+			ofstream stdFile(dataDirectory + "Output\\" + experimentSettings + "_" + metric + "Std.csv");
+			for (auto &statisticsAtOneCapacity : statisticsOfCell)
+			{
+				for (auto &cell : statisticsAtOneCapacity)
+				{
+					meanFile << cell.GetMean() << ",";
+					stdFile << cell.GetStd() << ",";
+				}
+				meanFile << "\n";
+				stdFile << "\n";
+			}
+			meanFile.close();
+			stdFile.close();
+		};
+
+		// record total cost (normalized by the LB)
+		WriteMeanAndStd(statistics.costTotal, "costTotal");
+
+		// record capacity wastage ratio
+		WriteMeanAndStd(statistics.capacityWastage, "capacityWastage");
+
+		// record average delay (client to G-server)
+		WriteMeanAndStd(statistics.averageDelay, "averageDelay");
+	}
+
+	void WriteComputationData(const OutcomeStatisticsType &statistics, string dataDirectory, string experimentSettings, string separator)
+	{
+		/*StreamWriter^ computationMeanFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "computationMean");
+		StreamWriter^ computationStdFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "computationStd");*/
+		ofstream computationMeanFile(dataDirectory + "Output\\" + experimentSettings + "_" + "computationMean.csv");
+		ofstream computationStdFile(dataDirectory + "Output\\" + experimentSettings + "_" + "computationStd.csv");
+		for (auto &computationAtOneCapacity : statistics.computation)
+		{
+			for (auto &cell : computationAtOneCapacity)
+			{
+				computationMeanFile << cell.GetMean() << separator;
+				computationStdFile << cell.GetStd() << separator;
+			}
+			computationMeanFile << "\n";
+			computationStdFile << "\n";
+		}
+		computationMeanFile.close();
+		computationStdFile.close();
+
+		if (statistics.cachedSessionCount > 0) printf("NOTE: the computation times are of the %d sessions computed by this run (%d sessions were read from the result cache)\n", (int)(statistics.sessionCount - statistics.cachedSessionCount), (int)statistics.cachedSessionCount);
+	}
+
+	void WriteDelayAndUtilizationData(const OutcomeStatisticsType &statistics, string dataDirectory, string experimentSettings)
+	{
+		auto WriteQuantilesAndCDF = [&](const vector<vector<QuantileSketchType>> &sketchOfCell, string metric)
 		{
-			vector<double> ClientToDatacenterDelayMatrixOneRow;
-			for (size_t col = 1; col < row.size(); col++)
+			for (int percentile : { 50, 95, 99 }) // one row per capacity and one column per strategy
 			{
-				ClientToDatacenterDelayMatrixOneRow.push_back(stod(row.at(col)) / 2);
+				ofstream quantileFile(dataDirectory + "Output\\" + experimentSettings + "_" + metric + "P" + std::to_string(percentile) + ".csv");
+				for (auto &sketchAtOneCapacity : sketchOfCell)
+				{
+					for (auto &cell : sketchAtOneCapacity)
+					{
+						quantileFile << cell.GetQuantile(percentile / 100.0) << ",";
+					}
+					quantileFile << "\n";
+				}
+				quantileFile.close();
 			}
-			ClientToDatacenterDelayMatrix.push_back(ClientToDatacenterDelayMatrixOneRow);
+
+			ofstream CDFFile(dataDirectory + "Output\\" + experimentSettings + "_" + metric + "CDF.csv"); // one row per capacity and strategy
+			for (auto &sketchAtOneCapacity : sketchOfCell)
+			{
+				for (auto &cell : sketchAtOneCapacity)
+				{
+					for (int percentile = 0; percentile <= 100; percentile++)
+					{
+						CDFFile << cell.GetQuantile(percentile / 100.0) << ",";
+					}
+					CDFFile << "\n";
+				}
+			}
+			CDFFile.close();
+		};
+
+		// record the delay of each client (client to G-server)
+		WriteQuantilesAndCDF(statistics.clientDelay, "clientDelay");
+
+		// record the utilization of each dc's servers
+		WriteQuantilesAndCDF(statistics.serverUtilization, "serverUtilization");
+	}
+
+	// strategy policies: each one assigns the clients of one session by its strategy (STRATEGY_ID, see STRATEGY_COUNT) at one capacity (for basic problem), and is run by the drivers below
+	// Policy_OPT forwards to Alg_OPT, whose inner loops do not depend on the capacity
+	struct Policy_LB // Lower-Bound (LB)
+	{
+		static const int STRATEGY_ID = 1;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+	struct Policy_RANDOM // Random-Assignment
+	{
+		static const int STRATEGY_ID = 2;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+	struct Policy_NEAREST // Nearest-Assignment
+	{
+		static const int STRATEGY_ID = 3;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+	struct Policy_LSP // Lowest-Server-Price-Datacenter-Assignment (LSP)
+	{
+		static const int STRATEGY_ID = 4;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+	struct Policy_LBP // Lowest-Bandwidth-Price-Datacenter-Assignment (LBP)
+	{
+		static const int STRATEGY_ID = 5;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+	struct Policy_LCP // Lowest-Combined-Price-Datacenter-Assignment (LCP)
+	{
+		static const int STRATEGY_ID = 6;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+	struct Policy_LCW // Lowest-Capacity-Wastage-Assignment (LCW)
+	{
+		static const int STRATEGY_ID = 7;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+	struct Policy_LAC // Lowest-Average-Cost-Assignment (LAC)
+	{
+		static const int STRATEGY_ID = 8;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+	struct Policy_OPT // Optimal (OPT)
+	{
+		static const int STRATEGY_ID = STRATEGY_OPT;
+		template <int CAPACITY>
+		static tuple<double, double, double, double, double> Run(const vector<ClientType*> &, const vector<DatacenterType*> &, CapacityType<CAPACITY>, int);
+	};
+
+	vector<int> GetServerCountColumns()
+	{
+		return { Policy_LCP::STRATEGY_ID - 1, Policy_LCW::STRATEGY_ID - 1, Policy_LAC::STRATEGY_ID - 1 };
+	}
+
+	// basic driver: run the policy with the compile-time instantiation of the capacity if it is a common one, and with the run-time capacity otherwise
+	// capacitySpecialization = false: always with the run-time capacity (for comparison)
+	template <class StrategyPolicy>
+	tuple<double, double, double, double, double> RunPolicy4BasicProblem(
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double serverCapacity,
+		int GDatacenterID,
+		bool capacitySpecialization = true)
+	{
+		Instrumentation::PhaseTimerType timer(Instrumentation::GetStrategyPhase(StrategyPolicy::STRATEGY_ID)); // one run at one G datacenter, in every driver
+		Instrumentation::OperationCountScopeType operationScope(serverCapacity, StrategyPolicy::STRATEGY_ID);
+
+		if (capacitySpecialization)
+		{
+			if (2 == serverCapacity) return StrategyPolicy::Run(sessionClients, allDatacenters, CapacityType<2>(), GDatacenterID);
+			if (4 == serverCapacity) return StrategyPolicy::Run(sessionClients, allDatacenters, CapacityType<4>(), GDatacenterID);
+			if (6 == serverCapacity) return StrategyPolicy::Run(sessionClients, allDatacenters, CapacityType<6>(), GDatacenterID);
+			if (8 == serverCapacity) return StrategyPolicy::Run(sessionClients, allDatacenters, CapacityType<8>(), GDatacenterID);
 		}
+		return StrategyPolicy::Run(sessionClients, allDatacenters, CapacityType<0>(serverCapacity), GDatacenterID);
+	}
 
-		/*dc-to-dc latency data*/
-		strings_read = ReadDelimitedTextFileIntoVector(dataDirectory + "dc_to_dc_rtt.csv", ',', true);
-		if (strings_read.empty())
+	// driver over the G candidates: set up the session for each eligible G datacenter, run the given basic run (which takes the G datacenter's id) and keep the one with the smallest total cost
+	// the server counts of the kept run are restored into the datacenters
+	template <class BasicRun>
+	tuple<double, double, double, double, double> RunOverGDatacenters(
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		int &finalGDatacenter,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		const BasicRun &RunAtGDatacenter)
+	{
+		tuple<double, double, double, double, double> finalOutcome;
+		double totalCost = INT_MAX;
+		finalGDatacenter = eligibleGDatacenters.front()->id;
+		vector<double> finalServerCountPerDC(allDatacenters.size(), 0); // by dc's id
+		vector<int> finalAssignment(sessionClients.size(), -1); // in the same order as the clients
+		DatacenterType *finalGDatacenterPointer = nullptr;
+
+		// the final G datacenter's eligibility, swapped out of the clients and dcs when it is chosen (the next setup resets them anyway)
+		vector<vector<DatacenterType*>> finalEligibleDatacenters(sessionClients.size()); // in the same order as the clients
+		vector<vector<unsigned long long>> finalEligibleDatacenterMask(sessionClients.size());
+		vector<vector<int>> finalEligibleDatacenterRank(sessionClients.size());
+		vector<vector<ClientType*>> finalCoverableClients(allDatacenters.size()); // in the same order as the dcs
+		auto SwapEligibility = [&]()
 		{
-			printf("ERROR: empty file!\n");
-			cin.get();
-			return false;
+			for (size_t i = 0; i < sessionClients.size(); i++)
+			{
+				sessionClients.at(i)->eligibleDatacenters.swap(finalEligibleDatacenters.at(i));
+				sessionClients.at(i)->eligibleDatacenterMask.swap(finalEligibleDatacenterMask.at(i));
+				sessionClients.at(i)->eligibleDatacenterRank.swap(finalEligibleDatacenterRank.at(i));
+			}
+			for (size_t j = 0; j < allDatacenters.size(); j++)
+			{
+				allDatacenters.at(j)->coverableClients.swap(finalCoverableClients.at(j));
+			}
+		};
+
+		for (auto GDatacenter : eligibleGDatacenters)
+		{
+			COUNT_OPERATIONS(OPERATION_G_CANDIDATES, 1);
+			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
+			auto tempOutcome = RunAtGDatacenter(GDatacenter->id);
+			double tempTotalCost = get<0>(tempOutcome);
+			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
+
+			if (tempTotalCost < totalCost) // choose the smaller cost
+			{
+				totalCost = tempTotalCost;
+				finalOutcome = tempOutcome;
+				finalGDatacenter = GDatacenter->id;
+				for (auto dc : allDatacenters)
+				{
+					finalServerCountPerDC.at(dc->id) = dc->openServerCount;
+				}
+				for (size_t i = 0; i < sessionClients.size(); i++)
+				{
+					finalAssignment.at(i) = sessionClients.at(i)->assignedDatacenterID;
+				}
+				finalGDatacenterPointer = GDatacenter;
+				SwapEligibility();
+			}
 		}
-		for (auto row : strings_read)
+
+		// leave the final G datacenter's setup and assignment (e.g. for the client delays), without running its setup again
+		if (finalGDatacenterPointer != nullptr)
 		{
-			vector<double> InterDatacenterDelayMatrixOneRow;
-			for (size_t col = 1; col < row.size(); col++)
+			SwapEligibility();
+			if (finalGDatacenterPointer != eligibleGDatacenters.back()) ApplyAssignment(sessionClients, allDatacenters, finalAssignment);
+		}
+
+		for (auto dc : allDatacenters)
+		{
+			dc->openServerCount = finalServerCountPerDC.at(dc->id);
+		}
+
+		return finalOutcome;
+	}
+
+	// general driver: the basic driver at each eligible G datacenter
+	template <class StrategyPolicy>
+	tuple<double, double, double, double, double> RunPolicy4GeneralProblem(
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		int &finalGDatacenter,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		double serverCapacity)
+	{
+		Instrumentation::OperationCountScopeType operationScope(serverCapacity, StrategyPolicy::STRATEGY_ID); // over all G candidates
+		return RunOverGDatacenters(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, [&](int GDatacenterID)
+		{
+			return RunPolicy4BasicProblem<StrategyPolicy>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+		});
+	}
+
+	// run one strategy (see STRATEGY_COUNT for the strategy ids) for basic problem
+	tuple<double, double, double, double, double> RunStrategy4BasicProblem(
+		int strategyID,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double serverCapacity,
+		int GDatacenterID,
+		bool capacitySpecialization)
+	{
+		switch (strategyID)
+		{
+		case 1:
+			return RunPolicy4BasicProblem<Policy_LB>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		case 2:
+			return RunPolicy4BasicProblem<Policy_RANDOM>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		case 3:
+			return RunPolicy4BasicProblem<Policy_NEAREST>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		case 4:
+			return RunPolicy4BasicProblem<Policy_LSP>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		case 5:
+			return RunPolicy4BasicProblem<Policy_LBP>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		case 6:
+			return RunPolicy4BasicProblem<Policy_LCP>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		case 7:
+			return RunPolicy4BasicProblem<Policy_LCW>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		case 8:
+			return RunPolicy4BasicProblem<Policy_LAC>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		case STRATEGY_OPT:
+			return RunPolicy4BasicProblem<Policy_OPT>(sessionClients, allDatacenters, serverCapacity, GDatacenterID, capacitySpecialization);
+		default:
+			return tuple<double, double, double, double, double>(0, 0, 0, 0, 0);
+		}
+	}
+
+	// run one strategy (same strategy ids as above) for general problem
+	tuple<double, double, double, double, double> RunStrategy4GeneralProblem(
+		int strategyID,
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		int &finalGDatacenter,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		double serverCapacity)
+	{
+		switch (strategyID)
+		{
+		case 1:
+			return RunPolicy4GeneralProblem<Policy_LB>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		case 2:
+			return RunPolicy4GeneralProblem<Policy_RANDOM>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		case 3:
+			return RunPolicy4GeneralProblem<Policy_NEAREST>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		case 4:
+			return RunPolicy4GeneralProblem<Policy_LSP>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		case 5:
+			return RunPolicy4GeneralProblem<Policy_LBP>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		case 6:
+			return RunPolicy4GeneralProblem<Policy_LCP>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		case 7:
+			return RunPolicy4GeneralProblem<Policy_LCW>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		case 8:
+			return RunPolicy4GeneralProblem<Policy_LAC>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		case STRATEGY_OPT:
+			return RunPolicy4GeneralProblem<Policy_OPT>(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+		default:
+			finalGDatacenter = eligibleGDatacenters.front()->id;
+			return tuple<double, double, double, double, double>(0, 0, 0, 0, 0);
+		}
+	}
+
+	vector<vector<ClientType*>> GetEligibilityComponents(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters)
+	{
+		// union-find over the dcs: all eligible dcs of a client are in its component
+		vector<int> parent(allDatacenters.size());
+		for (size_t d = 0; d < parent.size(); d++)
+		{
+			parent.at(d) = (int)d;
+		}
+		auto Find = [&parent](int d)
+		{
+			while (parent.at(d) != d)
 			{
-				InterDatacenterDelayMatrixOneRow.push_back(stod(row.at(col)) / 2);
+				parent.at(d) = parent.at(parent.at(d)); // path halving
+				d = parent.at(d);
+			}
+			return d;
+		};
+		for (auto client : sessionClients)
+		{
+			for (auto edc : client->eligibleDatacenters)
+			{
+				parent.at(Find(edc->id)) = Find(client->eligibleDatacenters.front()->id);
 			}
-			InterDatacenterDelayMatrix.push_back(InterDatacenterDelayMatrixOneRow);
 		}
-		const int totalClientCount = int(ClientToDatacenterDelayMatrix.size());
 
-		/* bandwidth and server price data */
-		strings_read = ReadDelimitedTextFileIntoVector(dataDirectory + "dc_pricing_bandwidth_server.csv", ',', true);
-		if (strings_read.empty())
+		vector<vector<ClientType*>> components;
+		map<int, size_t> componentOfRoot;
+		for (auto client : sessionClients)
 		{
-			printf("ERROR: empty file!\n");
-			cin.get();
-			return false;
+			int root = client->eligibleDatacenters.empty() ? -1 - client->id : Find(client->eligibleDatacenters.front()->id); // a client without eligible dcs is alone
+			if (componentOfRoot.find(root) == componentOfRoot.end())
+			{
+				componentOfRoot[root] = components.size();
+				components.push_back(vector<ClientType*>());
+			}
+			components.at(componentOfRoot[root]).push_back(client);
 		}
-		for (auto row : strings_read)
+
+		return components;
+	}
+
+	tuple<double, double, double, double, double> RunStrategyDecomposed4BasicProblem(
+		int strategyID,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double serverCapacity,
+		int GDatacenterID,
+		int threadCount)
+	{
+		auto components = GetEligibilityComponents(sessionClients, allDatacenters);
+		if (2 == strategyID || threadCount < 2 || components.size() < 2) return RunStrategy4BasicProblem(strategyID, sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+
+		// components share no client and no dc, so each one is solved in place on the given clients and dcs (the largest components first)
+		// through its own view of the dcs: its dcs at their ids and a price-only stand-in at every other id (so that the dc ids are still their indices and no two components touch the same dc)
+		// each dc then keeps its clients in the order its component assigned them
+		ResetAssignment(sessionClients, allDatacenters);
+		vector<double> componentSizes;
+		for (auto &component : components)
 		{
-			priceBandwidthList.push_back(stod(row.at(1)));
-			priceServerList.push_back(stod(row.at(2))); // 2: g2.8xlarge, 3: g2.2xlarge
+			componentSizes.push_back((double)component.size());
 		}
-		const int totalDatacenterCount = int(ClientToDatacenterDelayMatrix.front().size());
+		auto callerRandomness = sessionRandomness;
+		RunTasksWithWorkStealing(componentSizes, threadCount, [&](int c)
+		{
+			SessionRandomnessType randomness(callerRandomness);
+			vector<bool> isInComponent(allDatacenters.size(), false);
+			for (auto client : components.at(c))
+			{
+				for (auto edc : client->eligibleDatacenters)
+				{
+					isInComponent.at(edc->id) = true;
+				}
+			}
+			vector<DatacenterType> standIns;
+			standIns.reserve(allDatacenters.size()); // no reallocation, so the view's pointers stay valid
+			vector<DatacenterType*> componentDatacenters;
+			for (auto dc : allDatacenters)
+			{
+				if (isInComponent.at(dc->id))
+				{
+					componentDatacenters.push_back(dc);
+					continue;
+				}
+				standIns.push_back(DatacenterType(dc->id));
+				standIns.back().priceServer = dc->priceServer;
+				standIns.back().priceBandwidth = dc->priceBandwidth;
+				componentDatacenters.push_back(&standIns.back());
+			}
+			RunStrategy4BasicProblem(strategyID, components.at(c), componentDatacenters, serverCapacity, GDatacenterID);
+		});
+
+		if (1 == strategyID) // LB: fractional servers
+		{
+			for (auto dc : allDatacenters)
+			{
+				dc->openServerCount = double(dc->assignedClients.size()) / serverCapacity;
+			}
+			return GetSolutionOutputAtCapacities(allDatacenters, { serverCapacity }, sessionClients, GDatacenterID, true).front();
+		}
+		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
+	}
+
+	tuple<double, double, double, double, double> RunStrategyDecomposed4GeneralProblem(
+		int strategyID,
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		int &finalGDatacenter,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		double serverCapacity,
+		int threadCount)
+	{
+		if (strategyID < 1 || strategyID > STRATEGY_COUNT) return RunStrategy4GeneralProblem(strategyID, eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
+
+		Instrumentation::OperationCountScopeType operationScope(serverCapacity, strategyID); // the components' runs on other threads count on their own
+		return RunOverGDatacenters(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, [&](int GDatacenterID)
+		{
+			return RunStrategyDecomposed4BasicProblem(strategyID, sessionClients, allDatacenters, serverCapacity, GDatacenterID, threadCount);
+		});
+	}
+
+	// run one strategy and then improve its assignment by local search (LS)
+	// for basic problem
+	tuple<double, double, double, double, double> RunStrategyWithLocalSearch4BasicProblem(
+		int strategyID,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double serverCapacity,
+		int GDatacenterID,
+		const LocalSearchSettingType &localSearchSetting)
+	{
+		RunStrategy4BasicProblem(strategyID, sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+		Instrumentation::OperationCountScopeType operationScope(serverCapacity, STRATEGY_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY + 1); // the LS column counts the improvement (the base run counts to its own column)
+		return ImproveByLocalSearch(sessionClients, allDatacenters, serverCapacity, GDatacenterID, localSearchSetting);
+	}
+
+	// run one strategy and then improve its assignment by local search (LS) at each eligible G datacenter, and choose the smaller cost
+	// for general problem
+	tuple<double, double, double, double, double> RunStrategyWithLocalSearch4GeneralProblem(
+		int strategyID,
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		int &finalGDatacenter,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		double serverCapacity,
+		const LocalSearchSettingType &localSearchSetting)
+	{
+		Instrumentation::OperationCountScopeType operationScope(serverCapacity, STRATEGY_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY + 1); // the LS column
+		return RunOverGDatacenters(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, [&](int GDatacenterID)
+		{
+			return RunStrategyWithLocalSearch4BasicProblem(strategyID, sessionClients, allDatacenters, serverCapacity, GDatacenterID, localSearchSetting);
+		});
+	}
+
+	// run OPT within the setting's time budget
+	// for basic problem
+	tuple<double, double, double, double, double> RunOptimal4BasicProblem(
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double serverCapacity,
+		int GDatacenterID,
+		const OptimalSettingType &optimalSetting,
+		bool *isProvenOptimal)
+	{
+		Instrumentation::PhaseTimerType timer(Instrumentation::GetStrategyPhase(STRATEGY_OPT)); // as in RunPolicy4BasicProblem
+		Instrumentation::OperationCountScopeType operationScope(serverCapacity, STRATEGY_OPT);
+		return Alg_OPT(sessionClients, allDatacenters, serverCapacity, GDatacenterID, optimalSetting.timeBudget, isProvenOptimal);
+	}
+
+	// run OPT within the setting's time budget at each eligible G datacenter, and choose the smaller cost
+	// for general problem
+	tuple<double, double, double, double, double> RunOptimal4GeneralProblem(
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		int &finalGDatacenter,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		double serverCapacity,
+		const OptimalSettingType &optimalSetting,
+		bool *isProvenOptimal)
+	{
+		Instrumentation::OperationCountScopeType operationScope(serverCapacity, STRATEGY_OPT); // over all G candidates
+		bool isEveryRunProven = true;
+		auto outcome = RunOverGDatacenters(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, [&](int GDatacenterID)
+		{
+			bool isRunProven = true;
+			auto runOutcome = RunOptimal4BasicProblem(sessionClients, allDatacenters, serverCapacity, GDatacenterID, optimalSetting, &isRunProven);
+			isEveryRunProven = isEveryRunProven && isRunProven; // an unproven run may miss a cheaper solution at its G datacenter
+			return runOutcome;
+		});
+		if (isProvenOptimal) *isProvenOptimal = isEveryRunProven;
+		return outcome;
+	}
+
+	// the groups of capacities (indices into the capacity list) that share one assignment of the given strategy
+	vector<vector<size_t>> GetCapacityGroupsOfStrategy(int strategyID, const vector<vector<size_t>> &breakpointGroups, size_t capacityCount)
+	{
+		vector<vector<size_t>> capacityGroups;
+		if (Policy_LB::STRATEGY_ID == strategyID || Policy_LCP::STRATEGY_ID == strategyID) // LB and LCP: one assignment per price breakpoint interval
+		{
+			capacityGroups = breakpointGroups;
+		}
+		else if (Policy_RANDOM::STRATEGY_ID == strategyID || Policy_NEAREST::STRATEGY_ID == strategyID || Policy_LSP::STRATEGY_ID == strategyID || Policy_LBP::STRATEGY_ID == strategyID) // RANDOM, NEAREST, LSP and LBP: capacity-independent assignment
+		{
+			capacityGroups.push_back(vector<size_t>());
+			for (size_t i = 0; i < capacityCount; i++) capacityGroups.back().push_back(i);
+		}
+		else // LCW, LAC and OPT: rerun at each capacity
+		{
+			for (size_t i = 0; i < capacityCount; i++) capacityGroups.push_back(vector<size_t>(1, i));
+		}
+		return capacityGroups;
+	}
+
+	// run all strategies at each capacity for one session of basic problem
+	// result: outcome and computation time indexed by [capacity][column] (OPT only if it is enabled, followed by the LS columns if LS is enabled)
+	// return false if any assignment is invalid
+	bool EvaluateStrategies4BasicProblem(
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		const vector<double> &SERVER_CAPACITY_LIST,
+		int GDatacenterID,
+		vector<vector<tuple<double, double, double, double, double>>> &outcomeAtOneSession,
+		vector<vector<double>> &computationAtOneSession,
+		vector<vector<vector<double>>> &clientDelayAtOneSession,
+		vector<vector<vector<double>>> &serverUtilizationAtOneSession,
+		vector<int> &unprovenOptimalAtOneSession,
+		const LocalSearchSettingType &localSearchSetting,
+		const OptimalSettingType &optimalSetting)
+	{
+		const int BASE_COLUMN_COUNT = GetBaseColumnCount(optimalSetting); // the strategies 1 to BASE_COLUMN_COUNT, since OPT is the last one
+
+		outcomeAtOneSession.clear();
+		computationAtOneSession.clear();
+		clientDelayAtOneSession.clear();
+		serverUtilizationAtOneSession.clear();
+		unprovenOptimalAtOneSession.clear();
+
+		for (auto serverCapacity : SERVER_CAPACITY_LIST)
+		{
+			bool isProvenOptimal = true; // per capacity
+			vector<tuple<double, double, double, double, double>> outcomeAtOneCapacity; // per capacity
+			vector<double> computationAtOneCapacity; // per capacity
+			vector<tuple<double, double, double, double, double>> outcomeWithLocalSearchAtOneCapacity; // per capacity
+			vector<double> computationWithLocalSearchAtOneCapacity; // per capacity
+			vector<vector<double>> clientDelayAtOneCapacity(GetColumnCount(localSearchSetting, optimalSetting)); // per capacity
+			vector<vector<double>> serverUtilizationAtOneCapacity(clientDelayAtOneCapacity.size()); // per capacity
+
+			for (int strategyID = 1; strategyID <= BASE_COLUMN_COUNT; strategyID++)
+			{
+				auto timePoint = std::chrono::steady_clock::now();
+				auto outcome = (STRATEGY_OPT == strategyID) ?
+					RunOptimal4BasicProblem(sessionClients, allDatacenters, serverCapacity, GDatacenterID, optimalSetting, &isProvenOptimal) :
+					RunStrategy4BasicProblem(strategyID, sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+				computationAtOneCapacity.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count()); // record computation time (ms) per strategy
+				outcomeAtOneCapacity.push_back(outcome); // record outcome per strategy
+
+				if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters)) return false;
+				GetDelayAndUtilization(allDatacenters, serverCapacity, sessionClients, GDatacenterID, clientDelayAtOneCapacity.at(strategyID - 1), serverUtilizationAtOneCapacity.at(strategyID - 1), 1 == strategyID);
+
+				if (localSearchSetting.enabled && strategyID >= LOCAL_SEARCH_FIRST_STRATEGY && strategyID <= LOCAL_SEARCH_LAST_STRATEGY) // improve the above assignment
+				{
+					Instrumentation::OperationCountScopeType operationScope(serverCapacity, STRATEGY_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY + 1);
+					outcomeWithLocalSearchAtOneCapacity.push_back(ImproveByLocalSearch(sessionClients, allDatacenters, serverCapacity, GDatacenterID, localSearchSetting));
+					computationWithLocalSearchAtOneCapacity.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count()); // including the base strategy's time
+
+					if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters)) return false;
+					const int localSearchColumn = BASE_COLUMN_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY;
+					GetDelayAndUtilization(allDatacenters, serverCapacity, sessionClients, GDatacenterID, clientDelayAtOneCapacity.at(localSearchColumn), serverUtilizationAtOneCapacity.at(localSearchColumn));
+				}
+
+				cout << "*";
+			} // end of strategy loop
+
+			// LS columns after the base strategies
+			outcomeAtOneCapacity.insert(outcomeAtOneCapacity.end(), outcomeWithLocalSearchAtOneCapacity.begin(), outcomeWithLocalSearchAtOneCapacity.end());
+			computationAtOneCapacity.insert(computationAtOneCapacity.end(), computationWithLocalSearchAtOneCapacity.begin(), computationWithLocalSearchAtOneCapacity.end());
+
+			outcomeAtOneSession.push_back(outcomeAtOneCapacity); // record outcome per capacity
+			computationAtOneSession.push_back(computationAtOneCapacity); // record computation time per capacity	
+			clientDelayAtOneSession.push_back(clientDelayAtOneCapacity); // per capacity
+			serverUtilizationAtOneSession.push_back(serverUtilizationAtOneCapacity); // per capacity
+			unprovenOptimalAtOneSession.push_back(isProvenOptimal ? 0 : 1); // per capacity
+
+			cout << endl;
+		} // end of capacity loop
+
+		return true;
+	}
+
+	// capacity-parametric version of the above: the whole capacity list is evaluated in one pass
+	// RANDOM, NEAREST, LSP and LBP assign once, LB and LCP assign once per price breakpoint interval, and only LCW, LAC and OPT are rerun at each capacity
+	bool EvaluateStrategiesParametric4BasicProblem(
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		const vector<double> &SERVER_CAPACITY_LIST,
+		int GDatacenterID,
+		vector<vector<tuple<double, double, double, double, double>>> &outcomeAtOneSession,
+		vector<vector<double>> &computationAtOneSession,
+		vector<vector<vector<double>>> &clientDelayAtOneSession,
+		vector<vector<vector<double>>> &serverUtilizationAtOneSession,
+		vector<int> &unprovenOptimalAtOneSession,
+		const LocalSearchSettingType &localSearchSetting,
+		const OptimalSettingType &optimalSetting)
+	{
+		const int BASE_COLUMN_COUNT = GetBaseColumnCount(optimalSetting);
+		const int COLUMN_COUNT = GetColumnCount(localSearchSetting, optimalSetting);
+		outcomeAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<tuple<double, double, double, double, double>>(COLUMN_COUNT));
+		computationAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<double>(COLUMN_COUNT, 0));
+		clientDelayAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT));
+		serverUtilizationAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT));
+		unprovenOptimalAtOneSession.assign(SERVER_CAPACITY_LIST.size(), 0);
 
-		/* creating clients */
-		allClients.clear();
-		for (int i = 0; i < totalClientCount; i++)
-		{
-			ClientType* client = new ClientType(i);
-			client->chargedTrafficVolume = 2;
-			for (int j = 0; j < totalDatacenterCount; j++)
-			{
-				client->delayToDatacenter[j] = ClientToDatacenterDelayMatrix.at(i).at(j);
-			}
-			allClients.push_back(client);
-		}
-		printf("%d clients created according to the input latency data file\n", int(allClients.size()));
+		auto breakpointGroups = GroupCapacitiesByPriceBreakpoints(sessionClients, allDatacenters, SERVER_CAPACITY_LIST);
 
-		/* create datacenters */
-		allDatacenters.clear();
-		for (int i = 0; i < totalDatacenterCount; i++)
+		for (int strategyID = 1; strategyID <= BASE_COLUMN_COUNT; strategyID++)
 		{
-			DatacenterType* dc = new DatacenterType(i);
-			dc->priceServer = priceServerList.at(i);
-			dc->priceBandwidth = priceBandwidthList.at(i);
-			for (auto client : allClients)
-			{
-				dc->delayToClient[client->id] = client->delayToDatacenter[dc->id];
-			}
-			for (int j = 0; j < totalDatacenterCount; j++)
+			for (auto &group : GetCapacityGroupsOfStrategy(strategyID, breakpointGroups, SERVER_CAPACITY_LIST.size()))
 			{
-				dc->delayToDatacenter[j] = InterDatacenterDelayMatrix.at(i).at(j);
+				vector<double> capacities;
+				for (auto i : group) capacities.push_back(SERVER_CAPACITY_LIST.at(i));
+
+				bool isProvenOptimal = true;
+				auto timePoint = std::chrono::steady_clock::now();
+				if (STRATEGY_OPT == strategyID)
+					RunOptimal4BasicProblem(sessionClients, allDatacenters, capacities.front(), GDatacenterID, optimalSetting, &isProvenOptimal);
+				else
+					RunStrategy4BasicProblem(strategyID, sessionClients, allDatacenters, capacities.front(), GDatacenterID);
+				auto outcomes = GetSolutionOutputAtCapacities(allDatacenters, capacities, sessionClients, GDatacenterID, 1 == strategyID);
+				double computation = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count() / group.size(); // computation time of a shared assignment is split among its capacities
+
+				if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters)) return false;
+
+				for (size_t k = 0; k < group.size(); k++)
+				{
+					if (!isProvenOptimal) unprovenOptimalAtOneSession.at(group.at(k)) = 1;
+					outcomeAtOneSession.at(group.at(k)).at(strategyID - 1) = outcomes.at(k);
+					computationAtOneSession.at(group.at(k)).at(strategyID - 1) = computation;
+					GetDelayAndUtilization(allDatacenters, capacities.at(k), sessionClients, GDatacenterID, clientDelayAtOneSession.at(group.at(k)).at(strategyID - 1), serverUtilizationAtOneSession.at(group.at(k)).at(strategyID - 1), 1 == strategyID);
+				}
+
+				if (localSearchSetting.enabled && strategyID >= LOCAL_SEARCH_FIRST_STRATEGY && strategyID <= LOCAL_SEARCH_LAST_STRATEGY) // improve the shared assignment at each capacity of the group
+				{
+					vector<int> sharedAssignment;
+					for (auto client : sessionClients) sharedAssignment.push_back(client->assignedDatacenterID);
+
+					for (size_t k = 0; k < group.size(); k++)
+					{
+						auto localSearchTimePoint = std::chrono::steady_clock::now();
+						ApplyAssignment(sessionClients, allDatacenters, sharedAssignment);
+						Instrumentation::OperationCountScopeType operationScope(capacities.at(k), STRATEGY_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY + 1);
+						outcomeAtOneSession.at(group.at(k)).at(BASE_COLUMN_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY) = ImproveByLocalSearch(sessionClients, allDatacenters, capacities.at(k), GDatacenterID, localSearchSetting);
+						computationAtOneSession.at(group.at(k)).at(BASE_COLUMN_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY) = computation + std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - localSearchTimePoint).count(); // including the base strategy's time
+
+						if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters)) return false;
+						GetDelayAndUtilization(allDatacenters, capacities.at(k), sessionClients, GDatacenterID, clientDelayAtOneSession.at(group.at(k)).at(BASE_COLUMN_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY), serverUtilizationAtOneSession.at(group.at(k)).at(BASE_COLUMN_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY));
+					}
+				}
 			}
-			allDatacenters.push_back(dc);
-		}
-		printf("%d datacenters created according to the input latency data file\n", int(allDatacenters.size()));
+
+			cout << "*";
+		} // end of strategy loop
+
+		cout << endl;
 
 		return true;
 	}
 
-	void WriteCostWastageDelayData(int STRATEGY_COUNT, vector<double> SERVER_CAPACITY_LIST, double SESSION_COUNT,
-		vector<vector<vector<tuple<double, double, double, double, double>>>>& outcomeAtAllSessions,
-		string dataDirectory, string experimentSettings)
+	// run all strategies at each capacity for one session of general problem
+	// result: outcome, computation time, final G datacenter and server count per dc (indexed by dc's id) indexed by [capacity][strategy]
+	// return false if any assignment is invalid
+	bool EvaluateStrategies4GeneralProblem(
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		const vector<double> &SERVER_CAPACITY_LIST,
+		vector<vector<tuple<double, double, double, double, double>>> &outcomeAtOneSession,
+		vector<vector<double>> &computationAtOneSession,
+		vector<vector<int>> &finalGDatacenterAtOneSession,
+		vector<vector<vector<double>>> &serverCountPerDCAtOneSession,
+		vector<vector<vector<double>>> &clientDelayAtOneSession,
+		vector<vector<vector<double>>> &serverUtilizationAtOneSession,
+		vector<int> &unprovenOptimalAtOneSession,
+		const LocalSearchSettingType &localSearchSetting,
+		int componentThreadCount,
+		const OptimalSettingType &optimalSetting)
 	{
-		// record total cost to files
-		vector<vector<vector<double>>> costTotalStrategyCapacitySession;
-		for (int i = 0; i < STRATEGY_COUNT; i++) // columns
+		outcomeAtOneSession.clear();
+		computationAtOneSession.clear();
+		finalGDatacenterAtOneSession.clear();
+		serverCountPerDCAtOneSession.clear();
+		clientDelayAtOneSession.clear();
+		serverUtilizationAtOneSession.clear();
+		unprovenOptimalAtOneSession.clear();
+
+		for (auto serverCapacity : SERVER_CAPACITY_LIST)
 		{
-			vector<vector<double>> costTotalCapacitySession;
-			for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++) // rows
+			bool isProvenOptimal = true; // per capacity
+			vector<tuple<double, double, double, double, double>> outcomeAtOneCapacity; // per capacity		
+			vector<double> computationAtOneCapacity; // per capacity
+			vector<int> finalGDatacenterAtOneCapacity; // per capacity	
+			vector<vector<double>> serverCountPerDCAtOneCapacity; // per capacity
+			vector<vector<double>> clientDelayAtOneCapacity; // per capacity
+			vector<vector<double>> serverUtilizationAtOneCapacity; // per capacity
+
+			for (int strategyID = 1; strategyID <= GetBaseColumnCount(optimalSetting); strategyID++)
 			{
-				vector<double> costTotalSession;
-				for (int k = 0; k < SESSION_COUNT; k++) // entries
+				int finalGDatacenter;
+				auto timePoint = std::chrono::steady_clock::now();
+				auto outcome = (STRATEGY_OPT == strategyID) ? // OPT splits the instance into its components itself
+					RunOptimal4GeneralProblem(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity, optimalSetting, &isProvenOptimal) :
+					(componentThreadCount > 0 ?
+						RunStrategyDecomposed4GeneralProblem(strategyID, eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity, componentThreadCount) :
+						RunStrategy4GeneralProblem(strategyID, eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity));
+				computationAtOneCapacity.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count()); // per strategy
+				outcomeAtOneCapacity.push_back(outcome); // per strategy					
+				finalGDatacenterAtOneCapacity.push_back(finalGDatacenter); // per strategy
+
+				vector<double> serverCountPerDC;
+				for (auto dc : allDatacenters)
 				{
-					//costTotalSession.push_back(get<0>(outcomeAtAllSessions.at(k).at(j).at(i))); // for each session k of this capacity of this strategy (raw data)
-					costTotalSession.push_back(get<0>(outcomeAtAllSessions.at(k).at(j).at(i)) / get<0>(outcomeAtAllSessions.at(k).at(j).front())); // normalized by the LB
+					serverCountPerDC.push_back(dc->openServerCount);
 				}
-				costTotalCapacitySession.push_back(costTotalSession); // for each capacity j of this strategy
-			}
-			costTotalStrategyCapacitySession.push_back(costTotalCapacitySession); // for each strategy i
-		}
+				serverCountPerDCAtOneCapacity.push_back(serverCountPerDC); // per strategy
 
-		/*StreamWriter^ costTotalMeanFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "costTotalMean");
-		StreamWriter^ costTotalStdFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "costTotalStd");*/
-		ofstream costTotalMeanFile(dataDirectory + "Output\\" + experimentSettings + "_" + "costTotalMean.csv");
-		ofstream costTotalStdFile(dataDirectory + "Output\\" + experimentSettings + "_" + "costTotalStd.csv");
-		for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
-		{
-			for (int i = 0; i < STRATEGY_COUNT; i++)
+				if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters)) return false;
+				clientDelayAtOneCapacity.push_back(vector<double>()); // per strategy
+				serverUtilizationAtOneCapacity.push_back(vector<double>()); // per strategy
+				GetDelayAndUtilization(allDatacenters, serverCapacity, sessionClients, finalGDatacenter, clientDelayAtOneCapacity.back(), serverUtilizationAtOneCapacity.back(), 1 == strategyID);
+
+				cout << "*";
+			} // end of strategy loop
+
+			if (localSearchSetting.enabled) // LS columns after the base strategies (each G datacenter is searched again, since the general strategies keep only the best one's outcome)
 			{
-				costTotalMeanFile << GetMeanValue(costTotalStrategyCapacitySession.at(i).at(j)) << ",";
-				costTotalStdFile << GetStdValue(costTotalStrategyCapacitySession.at(i).at(j)) << ",";
+				for (int strategyID = LOCAL_SEARCH_FIRST_STRATEGY; strategyID <= LOCAL_SEARCH_LAST_STRATEGY; strategyID++)
+				{
+					int finalGDatacenter;
+					auto timePoint = std::chrono::steady_clock::now();
+					auto outcome = RunStrategyWithLocalSearch4GeneralProblem(strategyID, eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity, localSearchSetting);
+					computationAtOneCapacity.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count()); // per strategy
+					outcomeAtOneCapacity.push_back(outcome); // per strategy
+					finalGDatacenterAtOneCapacity.push_back(finalGDatacenter); // per strategy
+
+					vector<double> serverCountPerDC;
+					for (auto dc : allDatacenters)
+					{
+						serverCountPerDC.push_back(dc->openServerCount);
+					}
+					serverCountPerDCAtOneCapacity.push_back(serverCountPerDC); // per strategy
+
+					if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters)) return false;
+					clientDelayAtOneCapacity.push_back(vector<double>()); // per strategy
+					serverUtilizationAtOneCapacity.push_back(vector<double>()); // per strategy
+					GetDelayAndUtilization(allDatacenters, serverCapacity, sessionClients, finalGDatacenter, clientDelayAtOneCapacity.back(), serverUtilizationAtOneCapacity.back());
+
+					cout << "+";
+				}
 			}
-			costTotalMeanFile << "\n";
-			costTotalStdFile << "\n";
-		}
-		costTotalMeanFile.close();
-		costTotalStdFile.close();
 
-		// record capacity wastage ratio
-		vector<vector<vector<double>>> capacityWastageStrategyCapacitySession;
-		for (int i = 0; i < STRATEGY_COUNT; i++)
+			outcomeAtOneSession.push_back(outcomeAtOneCapacity); // per capacity
+			computationAtOneSession.push_back(computationAtOneCapacity); // per capacity	
+			finalGDatacenterAtOneSession.push_back(finalGDatacenterAtOneCapacity); // per capacity
+			serverCountPerDCAtOneSession.push_back(serverCountPerDCAtOneCapacity); // per capacity
+			clientDelayAtOneSession.push_back(clientDelayAtOneCapacity); // per capacity
+			serverUtilizationAtOneSession.push_back(serverUtilizationAtOneCapacity); // per capacity
+			unprovenOptimalAtOneSession.push_back(isProvenOptimal ? 0 : 1); // per capacity
+
+			cout << endl;
+		} // end of capacity loop
+
+		return true;
+	}
+
+	// capacity-parametric version of the above (see EvaluateStrategiesParametric4BasicProblem)
+	bool EvaluateStrategiesParametric4GeneralProblem(
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		const vector<double> &SERVER_CAPACITY_LIST,
+		vector<vector<tuple<double, double, double, double, double>>> &outcomeAtOneSession,
+		vector<vector<double>> &computationAtOneSession,
+		vector<vector<int>> &finalGDatacenterAtOneSession,
+		vector<vector<vector<double>>> &serverCountPerDCAtOneSession,
+		vector<vector<vector<double>>> &clientDelayAtOneSession,
+		vector<vector<vector<double>>> &serverUtilizationAtOneSession,
+		vector<int> &unprovenOptimalAtOneSession,
+		const LocalSearchSettingType &localSearchSetting,
+		const OptimalSettingType &optimalSetting)
+	{
+		const int BASE_COLUMN_COUNT = GetBaseColumnCount(optimalSetting);
+		const int COLUMN_COUNT = GetColumnCount(localSearchSetting, optimalSetting);
+		outcomeAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<tuple<double, double, double, double, double>>(COLUMN_COUNT));
+		computationAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<double>(COLUMN_COUNT, 0));
+		finalGDatacenterAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<int>(COLUMN_COUNT, eligibleGDatacenters.front()->id));
+		serverCountPerDCAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT, vector<double>(allDatacenters.size(), 0)));
+		clientDelayAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT));
+		serverUtilizationAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT));
+		unprovenOptimalAtOneSession.assign(SERVER_CAPACITY_LIST.size(), 0);
+
+		auto breakpointGroups = GroupCapacitiesByPriceBreakpoints(sessionClients, allDatacenters, SERVER_CAPACITY_LIST); // price ranking does not depend on the G datacenter
+
+		for (int strategyID = 1; strategyID <= BASE_COLUMN_COUNT; strategyID++)
 		{
-			vector<vector<double>> capacityWastageCapacitySession;
-			for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+			auto capacityGroups = GetCapacityGroupsOfStrategy(strategyID, breakpointGroups, SERVER_CAPACITY_LIST.size());
+			vector<double> totalCost(SERVER_CAPACITY_LIST.size(), INT_MAX);
+			bool isLocalSearchApplied = localSearchSetting.enabled && strategyID >= LOCAL_SEARCH_FIRST_STRATEGY && strategyID <= LOCAL_SEARCH_LAST_STRATEGY;
+			const int localSearchColumn = BASE_COLUMN_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY;
+			vector<double> totalCostWithLocalSearch(SERVER_CAPACITY_LIST.size(), INT_MAX);
+			double localSearchComputation = 0;
+
+			auto timePoint = std::chrono::steady_clock::now();
+			for (auto GDatacenter : eligibleGDatacenters)
 			{
-				vector<double> capacityWastageSession;
-				for (int k = 0; k < SESSION_COUNT; k++)
+				SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
+
+				for (auto &group : capacityGroups)
 				{
-					capacityWastageSession.push_back(get<3>(outcomeAtAllSessions.at(k).at(j).at(i))); // for each session k of this capacity of this strategy
+					vector<double> capacities;
+					for (auto i : group) capacities.push_back(SERVER_CAPACITY_LIST.at(i));
+
+					bool isProvenOptimal = true;
+					if (STRATEGY_OPT == strategyID)
+						RunOptimal4BasicProblem(sessionClients, allDatacenters, capacities.front(), GDatacenter->id, optimalSetting, &isProvenOptimal);
+					else
+						RunStrategy4BasicProblem(strategyID, sessionClients, allDatacenters, capacities.front(), GDatacenter->id);
+					if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters)) return false;
+					auto outcomes = GetSolutionOutputAtCapacities(allDatacenters, capacities, sessionClients, GDatacenter->id, 1 == strategyID);
+
+					for (size_t k = 0; k < group.size(); k++)
+					{
+						size_t i = group.at(k);
+						if (!isProvenOptimal) unprovenOptimalAtOneSession.at(i) = 1; // at any G datacenter
+						if (get<0>(outcomes.at(k)) < totalCost.at(i)) // choose the smaller cost at each capacity
+						{
+							totalCost.at(i) = get<0>(outcomes.at(k));
+							outcomeAtOneSession.at(i).at(strategyID - 1) = outcomes.at(k);
+							finalGDatacenterAtOneSession.at(i).at(strategyID - 1) = GDatacenter->id;
+							for (auto dc : allDatacenters)
+							{
+								double openServerCount = double(dc->assignedClients.size()) / capacities.at(k);
+								serverCountPerDCAtOneSession.at(i).at(strategyID - 1).at(dc->id) = (1 == strategyID) ? openServerCount : ceil(openServerCount);
+							}
+							GetDelayAndUtilization(allDatacenters, capacities.at(k), sessionClients, GDatacenter->id, clientDelayAtOneSession.at(i).at(strategyID - 1), serverUtilizationAtOneSession.at(i).at(strategyID - 1), 1 == strategyID);
+						}
+					}
+
+					if (isLocalSearchApplied) // improve the shared assignment at each capacity of the group
+					{
+						auto localSearchTimePoint = std::chrono::steady_clock::now();
+						vector<int> sharedAssignment;
+						for (auto client : sessionClients) sharedAssignment.push_back(client->assignedDatacenterID);
+
+						for (size_t k = 0; k < group.size(); k++)
+						{
+							size_t i = group.at(k);
+							ApplyAssignment(sessionClients, allDatacenters, sharedAssignment);
+							Instrumentation::OperationCountScopeType operationScope(capacities.at(k), STRATEGY_COUNT + strategyID - LOCAL_SEARCH_FIRST_STRATEGY + 1); // at each G candidate
+							auto outcome = ImproveByLocalSearch(sessionClients, allDatacenters, capacities.at(k), GDatacenter->id, localSearchSetting);
+							if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters)) return false;
+
+							if (get<0>(outcome) < totalCostWithLocalSearch.at(i)) // choose the smaller cost at each capacity
+							{
+								totalCostWithLocalSearch.at(i) = get<0>(outcome);
+								outcomeAtOneSession.at(i).at(localSearchColumn) = outcome;
+								finalGDatacenterAtOneSession.at(i).at(localSearchColumn) = GDatacenter->id;
+								for (auto dc : allDatacenters)
+								{
+									serverCountPerDCAtOneSession.at(i).at(localSearchColumn).at(dc->id) = dc->openServerCount;
+								}
+								GetDelayAndUtilization(allDatacenters, capacities.at(k), sessionClients, GDatacenter->id, clientDelayAtOneSession.at(i).at(localSearchColumn), serverUtilizationAtOneSession.at(i).at(localSearchColumn));
+							}
+						}
+						localSearchComputation += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - localSearchTimePoint).count();
+					}
 				}
-				capacityWastageCapacitySession.push_back(capacityWastageSession); // for each capacity j of this strategy
 			}
-			capacityWastageStrategyCapacitySession.push_back(capacityWastageCapacitySession); // for each strategy i
-		}
+			double computation = (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count() - localSearchComputation) / SERVER_CAPACITY_LIST.size(); // computation time of this strategy is split among all capacities
 
-		/*StreamWriter^ capacityWastageMeanFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "capacityWastageMean");
-		StreamWriter^ capacityWastageStdFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "capacityWastageStd");*/
-		ofstream capacityWastageMeanFile(dataDirectory + "Output\\" + experimentSettings + "_" + "capacityWastageMean.csv");
-		ofstream capacityWastageStdFile(dataDirectory + "Output\\" + experimentSettings + "_" + "capacityWastageStd.csv");
-		for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
-		{
-			for (int i = 0; i < STRATEGY_COUNT; i++)
+			for (size_t i = 0; i < SERVER_CAPACITY_LIST.size(); i++)
 			{
-				capacityWastageMeanFile << GetMeanValue(capacityWastageStrategyCapacitySession.at(i).at(j)) << ",";
-				capacityWastageStdFile << GetStdValue(capacityWastageStrategyCapacitySession.at(i).at(j)) << ",";
+				computationAtOneSession.at(i).at(strategyID - 1) = computation;
+				if (isLocalSearchApplied) computationAtOneSession.at(i).at(localSearchColumn) = computation + localSearchComputation / SERVER_CAPACITY_LIST.size(); // including the base strategy's time
 			}
-			capacityWastageMeanFile << "\n";
-			capacityWastageStdFile << "\n";
-		}
-		capacityWastageMeanFile.close();
-		capacityWastageStdFile.close();
 
-		// record average delay (client to G-server)
-		vector<vector<vector<double>>> averageDelayStrategyCapacitySession;
-		for (int i = 0; i < STRATEGY_COUNT; i++)
+			cout << "*";
+		} // end of strategy loop
+
+		cout << endl;
+
+		return true;
+	}
+
+	// cells of one session (indices of [capacity][column] in row-major order), with the OPT cells (if enabled) first since they take the longest
+	vector<int> GetCellsOfSession(size_t capacityCount, int columnCount, const OptimalSettingType &optimalSetting)
+	{
+		vector<int> cells;
+		for (int pass = 0; pass < 2; pass++)
 		{
-			vector<vector<double>> averageDelayCapacitySession;
-			for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+			for (size_t j = 0; j < capacityCount; j++)
 			{
-				vector<double> averageDelaySession;
-				for (int k = 0; k < SESSION_COUNT; k++)
+				for (int column = 0; column < columnCount; column++)
 				{
-					averageDelaySession.push_back(get<4>(outcomeAtAllSessions.at(k).at(j).at(i))); // for each session k of this capacity of this strategy
+					if ((0 == pass) == (optimalSetting.enabled && STRATEGY_OPT == column + 1)) cells.push_back((int)j * columnCount + column);
 				}
-				averageDelayCapacitySession.push_back(averageDelaySession); // for each capacity j of this strategy
 			}
-			averageDelayStrategyCapacitySession.push_back(averageDelayCapacitySession); // for each strategy i
 		}
+		return cells;
+	}
 
-		/*StreamWriter^ averageDelayMeanFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "averageDelayMean");
-		StreamWriter^ averageDelayStdFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "averageDelayStd");*/
-		ofstream averageDelayMeanFile(dataDirectory + "Output\\" + experimentSettings + "_" + "averageDelayMean.csv");
-		ofstream averageDelayStdFile(dataDirectory + "Output\\" + experimentSettings + "_" + "averageDelayStd.csv");
-		for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+	// intra-session parallel version of EvaluateStrategies4BasicProblem: each (strategy, capacity) cell is evaluated as its own task on threadCount threads, each with private copies of the session's clients and datacenters
+	// each cell uses the caller's session randomness, so the results are the same as the serial evaluation
+	bool EvaluateStrategiesFanOut4BasicProblem(
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		const vector<double> &SERVER_CAPACITY_LIST,
+		int GDatacenterID,
+		vector<vector<tuple<double, double, double, double, double>>> &outcomeAtOneSession,
+		vector<vector<double>> &computationAtOneSession,
+		vector<vector<vector<double>>> &clientDelayAtOneSession,
+		vector<vector<vector<double>>> &serverUtilizationAtOneSession,
+		vector<int> &unprovenOptimalAtOneSession,
+		const LocalSearchSettingType &localSearchSetting,
+		const OptimalSettingType &optimalSetting,
+		int threadCount)
+	{
+		const int BASE_COLUMN_COUNT = GetBaseColumnCount(optimalSetting);
+		const int COLUMN_COUNT = GetColumnCount(localSearchSetting, optimalSetting);
+		outcomeAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<tuple<double, double, double, double, double>>(COLUMN_COUNT));
+		computationAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<double>(COLUMN_COUNT, 0));
+		clientDelayAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT));
+		serverUtilizationAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT));
+		unprovenOptimalAtOneSession.assign(SERVER_CAPACITY_LIST.size(), 0);
+
+		const SessionRandomnessType *callerRandomness = sessionRandomness;
+
+		bool isValidAssignment = RunTasksWithWorkspaces(GetCellsOfSession(SERVER_CAPACITY_LIST.size(), COLUMN_COUNT, optimalSetting), threadCount, sessionClients, allDatacenters, [&](int cell, WorkspaceType &workspace)
+		{
+			size_t j = cell / COLUMN_COUNT;
+			int column = cell % COLUMN_COUNT;
+			int strategyID = (column < BASE_COLUMN_COUNT) ? column + 1 : column - BASE_COLUMN_COUNT + LOCAL_SEARCH_FIRST_STRATEGY;
+			SessionRandomnessType cellRandomness(callerRandomness);
+
+			bool isProvenOptimal = true;
+			auto timePoint = std::chrono::steady_clock::now();
+			auto outcome = (column < BASE_COLUMN_COUNT) ?
+				((STRATEGY_OPT == strategyID) ?
+					RunOptimal4BasicProblem(workspace.clients, workspace.datacenters, SERVER_CAPACITY_LIST.at(j), GDatacenterID, optimalSetting, &isProvenOptimal) :
+					RunStrategy4BasicProblem(strategyID, workspace.clients, workspace.datacenters, SERVER_CAPACITY_LIST.at(j), GDatacenterID)) :
+				RunStrategyWithLocalSearch4BasicProblem(strategyID, workspace.clients, workspace.datacenters, SERVER_CAPACITY_LIST.at(j), GDatacenterID, localSearchSetting);
+			computationAtOneSession.at(j).at(column) = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count();
+			outcomeAtOneSession.at(j).at(column) = outcome;
+			if (!isProvenOptimal) unprovenOptimalAtOneSession.at(j) = 1; // only the OPT cell of capacity j writes it
+
+			cout << "*";
+
+			if (!CheckIfAllClientsExactlyAssigned(workspace.clients, workspace.datacenters)) return false;
+			GetDelayAndUtilization(workspace.datacenters, SERVER_CAPACITY_LIST.at(j), workspace.clients, GDatacenterID, clientDelayAtOneSession.at(j).at(column), serverUtilizationAtOneSession.at(j).at(column), 0 == column);
+			return true;
+		});
+
+		cout << endl;
+
+		return isValidAssignment;
+	}
+
+	// intra-session parallel version of EvaluateStrategies4GeneralProblem (see EvaluateStrategiesFanOut4BasicProblem)
+	bool EvaluateStrategiesFanOut4GeneralProblem(
+		const vector<DatacenterType*> &eligibleGDatacenters,
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		double DELAY_BOUND_TO_G,
+		double DELAY_BOUND_TO_R,
+		const vector<double> &SERVER_CAPACITY_LIST,
+		vector<vector<tuple<double, double, double, double, double>>> &outcomeAtOneSession,
+		vector<vector<double>> &computationAtOneSession,
+		vector<vector<int>> &finalGDatacenterAtOneSession,
+		vector<vector<vector<double>>> &serverCountPerDCAtOneSession,
+		vector<vector<vector<double>>> &clientDelayAtOneSession,
+		vector<vector<vector<double>>> &serverUtilizationAtOneSession,
+		vector<int> &unprovenOptimalAtOneSession,
+		const LocalSearchSettingType &localSearchSetting,
+		const OptimalSettingType &optimalSetting,
+		int threadCount)
+	{
+		const int BASE_COLUMN_COUNT = GetBaseColumnCount(optimalSetting);
+		const int COLUMN_COUNT = GetColumnCount(localSearchSetting, optimalSetting);
+		outcomeAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<tuple<double, double, double, double, double>>(COLUMN_COUNT));
+		computationAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<double>(COLUMN_COUNT, 0));
+		finalGDatacenterAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<int>(COLUMN_COUNT, eligibleGDatacenters.front()->id));
+		serverCountPerDCAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT, vector<double>(allDatacenters.size(), 0)));
+		clientDelayAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT));
+		serverUtilizationAtOneSession.assign(SERVER_CAPACITY_LIST.size(), vector<vector<double>>(COLUMN_COUNT));
+		unprovenOptimalAtOneSession.assign(SERVER_CAPACITY_LIST.size(), 0);
+
+		const SessionRandomnessType *callerRandomness = sessionRandomness;
+
+		bool isValidAssignment = RunTasksWithWorkspaces(GetCellsOfSession(SERVER_CAPACITY_LIST.size(), COLUMN_COUNT, optimalSetting), threadCount, sessionClients, allDatacenters, [&](int cell, WorkspaceType &workspace)
 		{
-			for (int i = 0; i < STRATEGY_COUNT; i++)
+			size_t j = cell / COLUMN_COUNT;
+			int column = cell % COLUMN_COUNT;
+			int strategyID = (column < BASE_COLUMN_COUNT) ? column + 1 : column - BASE_COLUMN_COUNT + LOCAL_SEARCH_FIRST_STRATEGY;
+			SessionRandomnessType cellRandomness(callerRandomness);
+
+			vector<DatacenterType*> workspaceEligibleGDatacenters;
+			for (auto dc : eligibleGDatacenters) workspaceEligibleGDatacenters.push_back(workspace.datacenters.at(dc->id));
+
+			int finalGDatacenter;
+			bool isProvenOptimal = true;
+			auto timePoint = std::chrono::steady_clock::now();
+			auto outcome = (column < BASE_COLUMN_COUNT) ?
+				((STRATEGY_OPT == strategyID) ?
+					RunOptimal4GeneralProblem(workspaceEligibleGDatacenters, finalGDatacenter, workspace.clients, workspace.datacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, SERVER_CAPACITY_LIST.at(j), optimalSetting, &isProvenOptimal) :
+					RunStrategy4GeneralProblem(strategyID, workspaceEligibleGDatacenters, finalGDatacenter, workspace.clients, workspace.datacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, SERVER_CAPACITY_LIST.at(j))) :
+				RunStrategyWithLocalSearch4GeneralProblem(strategyID, workspaceEligibleGDatacenters, finalGDatacenter, workspace.clients, workspace.datacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, SERVER_CAPACITY_LIST.at(j), localSearchSetting);
+			computationAtOneSession.at(j).at(column) = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count();
+			outcomeAtOneSession.at(j).at(column) = outcome;
+			if (!isProvenOptimal) unprovenOptimalAtOneSession.at(j) = 1; // only the OPT cell of capacity j writes it
+			finalGDatacenterAtOneSession.at(j).at(column) = finalGDatacenter;
+			for (auto dc : workspace.datacenters)
 			{
-				averageDelayMeanFile << GetMeanValue(averageDelayStrategyCapacitySession.at(i).at(j)) << + ",";
-				averageDelayStdFile << GetStdValue(averageDelayStrategyCapacitySession.at(i).at(j)) << + ",";
+				serverCountPerDCAtOneSession.at(j).at(column).at(dc->id) = dc->openServerCount;
 			}
-			averageDelayMeanFile << "\n";
-			averageDelayStdFile << "\n";
-		}
-		averageDelayMeanFile.close();
-		averageDelayStdFile.close();
+
+			cout << "*";
+
+			if (!CheckIfAllClientsExactlyAssigned(workspace.clients, workspace.datacenters)) return false;
+			GetDelayAndUtilization(workspace.datacenters, SERVER_CAPACITY_LIST.at(j), workspace.clients, finalGDatacenter, clientDelayAtOneSession.at(j).at(column), serverUtilizationAtOneSession.at(j).at(column), 0 == column);
+			return true;
+		});
+
+		cout << endl;
+
+		return isValidAssignment;
 	}
 
-	void SimulateBasicProblem(double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R, double SESSION_SIZE, double SESSION_COUNT)
+	void SimulateBasicProblem(double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R, double SESSION_SIZE, const SimulationSettingType &simulationSetting)
 	{
-		//srand((unsigned)time(nullptr)); // using current time as the seed for random_shuffle() and rand(), otherwise, they will generate the same sequence of random numbers in every run
+		// the randomness of each session is reproducible from SESSION_RANDOM_SEED and the session id (see SessionRandomnessType)
 
-		auto t0 = clock(); // start time	
+		auto t0 = std::chrono::steady_clock::now(); // start time
+		Instrumentation::ResetPhaseHistograms(); // the phase timings of this simulation only
+		Instrumentation::ResetMemoryProfile(); // and its allocations
+		Instrumentation::ResetOperationCounts(); // and its operation counts
 
 		string dataDirectory = ".\\Data\\ProblemBasic\\";
 		vector<ClientType*> allClients;
@@ -471,121 +2477,103 @@ namespace ServerAllocationProblem
 			return;
 		}
 		
-		// data structures for storing results
-		vector<vector<vector<tuple<double, double, double, double, double>>>> outcomeAtAllSessions;
-		vector<vector<vector<double>>> computationAtAllSessions;
-		vector<int> eligibleRDatacenterCount;
-		vector<int> GDatacenterIDAtAllSessions;
-		vector<double> matchmakingTimeAtAllSessions;
+		string experimentSettings = std::to_string((int)DELAY_BOUND_TO_G) + "_" + std::to_string((int)DELAY_BOUND_TO_R) + "_" + std::to_string((int)SESSION_SIZE);
+
+		// data structures for storing results (updated as each session finishes)
+		OutcomeStatisticsType outcomeStatistics;
+		ofstream matchmakingTimeFile(dataDirectory + "Output\\" + experimentSettings + "_" + "matchmakingTime.csv"); // matchmaking's time (ms) per session
 
 		vector<double> SERVER_CAPACITY_LIST = { 2, 4, 6, 8 };
-		int STRATEGY_COUNT = 8;
 
-		for (int sessionID = 1; sessionID <= SESSION_COUNT; sessionID++)
+		// one session with the given (shared or per-worker) clients and datacenters
+		auto RunOneSession = [&](int sessionID, const vector<ClientType*> &workerClients, const vector<DatacenterType*> &workerDatacenters, SessionResultType &result)
 		{
 			vector<ClientType*> sessionClients;
-			int GDatacenterID;
 
-			auto matchmakingStartTime = clock();
-			bool isFeasibleSession = Matchmaking4BasicProblem(allDatacenters, allClients, GDatacenterID, sessionClients, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
-			matchmakingTimeAtAllSessions.push_back(difftime(clock(), matchmakingStartTime));
+			auto matchmakingStartTime = std::chrono::steady_clock::now();
+			bool isFeasibleSession = Matchmaking4BasicProblem(workerDatacenters, workerClients, result.GDatacenterID, sessionClients, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
+			result.matchmakingTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - matchmakingStartTime).count();
 			if (!isFeasibleSession)
 			{
 				printf("--------------------------------------------------------------------\n");
 				printf("ERROR: infeasible session\n");
-				printf("total elapsed time: %d seconds\n", (int)(difftime(clock(), t0) / 1000));
-				cin.get();
-				return;
+				return false;
 			}
-			GDatacenterIDAtAllSessions.push_back(GDatacenterID);
 			for (auto client : sessionClients)
 			{
 				//eligibleRDatacenterCount.push_back((int)client->eligibleDatacenterList.size());
-				eligibleRDatacenterCount.push_back((int)client->eligibleDatacenters.size());
+				result.eligibleRDatacenterCount.push_back((int)client->eligibleDatacenters.size());
 			}
 
 			printf("------------------------------------------------------------------------\n");
 			printf("delay bounds: (%d, %d) session size: %d session: %d\n", (int)DELAY_BOUND_TO_G, (int)DELAY_BOUND_TO_R, (int)SESSION_SIZE, sessionID);
 			printf("executing strategies\n");
 
-			vector<vector<tuple<double, double, double, double, double>>> outcomeAtOneSession; // per session
-			vector<vector<double>> computationAtOneSession; // per session				
-
-			for (auto serverCapacity : SERVER_CAPACITY_LIST)
+			bool isValidAssignment = simulationSetting.capacityParametric ?
+				EvaluateStrategiesParametric4BasicProblem(sessionClients, workerDatacenters, SERVER_CAPACITY_LIST, result.GDatacenterID, result.outcome, result.computation, result.clientDelay, result.serverUtilization, result.unprovenOptimal, simulationSetting.localSearchSetting, simulationSetting.optimalSetting) :
+				(simulationSetting.cellThreadCount > 0 ?
+					EvaluateStrategiesFanOut4BasicProblem(sessionClients, workerDatacenters, SERVER_CAPACITY_LIST, result.GDatacenterID, result.outcome, result.computation, result.clientDelay, result.serverUtilization, result.unprovenOptimal, simulationSetting.localSearchSetting, simulationSetting.optimalSetting, simulationSetting.cellThreadCount) :
+					EvaluateStrategies4BasicProblem(sessionClients, workerDatacenters, SERVER_CAPACITY_LIST, result.GDatacenterID, result.outcome, result.computation, result.clientDelay, result.serverUtilization, result.unprovenOptimal, simulationSetting.localSearchSetting, simulationSetting.optimalSetting));
+			if (!isValidAssignment)
 			{
-				//for (auto dc : allDatacenters)
-				//{
-				//	dc->priceCombined = (dc->priceServer / serverCapacity) + dc->priceBandwidth; // dependent on server capacity
-				//}
-
-				vector<tuple<double, double, double, double, double>> outcomeAtOneCapacity; // per capacity
-				vector<double> computationAtOneCapacity; // per capacity
-
-				for (int strategyID = 1; strategyID <= STRATEGY_COUNT; strategyID++)
-				{
-					tuple<double, double, double, double, double> outcome;	
-					auto timePoint = clock();
-					switch (strategyID)
-					{
-					case 1:
-						outcome = Alg_LB(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
-						break;
-					case 2:
-						outcome = Alg_RANDOM(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
-						break;
-					case 3:
-						outcome = Alg_NEAREST(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
-						break;
-					case 4:
-						outcome = Alg_LSP(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
-						break;
-					case 5:
-						outcome = Alg_LBP(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
-						break;
-					case 6:
-						outcome = Alg_LCP(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
-						break;
-					case 7:
-						outcome = Alg_LCW(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
-						break;
-					case 8:
-						outcome = Alg_LAC(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
-						break;
-					default:
-						outcome = tuple<double, double, double, double, double>(0, 0, 0, 0, 0);
-						break;
-					}		
-					computationAtOneCapacity.push_back((double)(clock() - timePoint)); // record computation time per strategy
-					outcomeAtOneCapacity.push_back(outcome); // record outcome per strategy
-
-					if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters))
-					{
-						printf("Something wrong with client-to-datacenter assignment!\n");
-						cin.get();
-						return;
-					}
-
-					cout << "*";
-				} // end of strategy loop
+				printf("Something wrong with client-to-datacenter assignment!\n");
+				return false;
+			}
 
-				outcomeAtOneSession.push_back(outcomeAtOneCapacity); // record outcome per capacity
-				computationAtOneSession.push_back(computationAtOneCapacity); // record computation time per capacity	
+			printf("end of executing strategies\n");
+			return true;
+		};
 
-				cout << endl;
-			} // end of capacity loop
+		// checkpoint of the per-session results, so that an interrupted run only loses the sessions not consumed yet
+		ResultCacheType *resultCache = nullptr;
+		if (simulationSetting.resultCaching && !(simulationSetting.localSearchSetting.enabled && simulationSetting.localSearchSetting.timeBudget > 0) && !(simulationSetting.optimalSetting.enabled && simulationSetting.optimalSetting.timeBudget > 0))
+		{
+			resultCache = new ResultCacheType(dataDirectory, GetResultCacheKey(dataDirectory, GetSimulationParameters("basic", DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, SESSION_SIZE, SERVER_CAPACITY_LIST, simulationSetting.capacityParametric, simulationSetting.localSearchSetting, simulationSetting.optimalSetting)));
+		}
 
-			outcomeAtAllSessions.push_back(outcomeAtOneSession); // per session size
-			computationAtAllSessions.push_back(computationAtOneSession); // per session size
+		// every session's rows, written by a background thread
+		RawResults::RawResultWriterType *rawResultWriter = nullptr;
+		if (simulationSetting.rawResults) rawResultWriter = new RawResults::RawResultWriterType(dataDirectory + "Output\\" + experimentSettings + "_" + "rawResults.bin", RawResults::PROBLEM_BASIC, SERVER_CAPACITY_LIST, experimentSettings);
 
-			printf("end of executing strategies\n");
+		// merge in session order
+		auto ConsumeSession = [&](int sessionID, const SessionResultType &result)
+		{
+			if (rawResultWriter) rawResultWriter->AppendSession(sessionID, result);
+			outcomeStatistics.Add(result.outcome, result.computation, result.isCached);
+			outcomeStatistics.AddDistributions(result.clientDelay, result.serverUtilization);
+			outcomeStatistics.AddUnprovenOptimal(result.unprovenOptimal);
+			if (!result.isCached) matchmakingTimeFile << result.matchmakingTime << "\n"; // not the time of an earlier run
+		};
+
+		vector<vector<double>> sessionCountOfCell, relativeHalfWidthOfCell; // of the adaptive stopping
+		bool isSimulationDone = simulationSetting.adaptiveStopping.enabled ?
+			RunSessionsAdaptively(simulationSetting.SESSION_COUNT, simulationSetting.adaptiveStopping, simulationSetting.threadCount, allClients, allDatacenters, RunOneSession, ConsumeSession, resultCache, sessionCountOfCell, relativeHalfWidthOfCell) :
+			RunSessions(1, simulationSetting.SESSION_COUNT, simulationSetting.threadCount, allClients, allDatacenters, RunOneSession, ConsumeSession, resultCache);
+		delete resultCache;
+		if (rawResultWriter)
+		{
+			if (!rawResultWriter->Close()) printf("ERROR: writing %s failed\n", rawResultWriter->fileName.c_str());
+			else printf("%d rows written to %s (the sessions waited %.1f ms for the writer)\n", (int)rawResultWriter->rowCount, rawResultWriter->fileName.c_str(), rawResultWriter->waitingTime);
+			delete rawResultWriter;
+		}
+		if (!isSimulationDone)
+		{
+			printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+			cin.get();
+			return;
 		}
 
 		/*******************************************************************************************************/
 
-		string experimentSettings = std::to_string((int)DELAY_BOUND_TO_G) + "_" + std::to_string((int)DELAY_BOUND_TO_R) + "_" + std::to_string((int)SESSION_SIZE);
+		Instrumentation::PhaseTimerType outputTimer(Instrumentation::PHASE_OUTPUT);
 
 		// record cost, wastage and delay
-		WriteCostWastageDelayData(STRATEGY_COUNT, SERVER_CAPACITY_LIST, SESSION_COUNT, outcomeAtAllSessions, dataDirectory, experimentSettings);
+		WriteCostWastageDelayData(outcomeStatistics, dataDirectory, experimentSettings);
+		WriteDelayAndUtilizationData(outcomeStatistics, dataDirectory, experimentSettings);
+		if (simulationSetting.optimalSetting.enabled) WriteUnprovenOptimalData(outcomeStatistics, dataDirectory, experimentSettings);
+
+		// record the sessions used by each cell and its final precision
+		if (simulationSetting.adaptiveStopping.enabled) WriteAdaptiveStoppingData(sessionCountOfCell, relativeHalfWidthOfCell, dataDirectory, experimentSettings);
 
 		// record eligible RDatacenter count
 		//StreamWriter^ eligibleRDatacenterCountFile = gcnew StreamWriter(dataDirectory + "Output\\eligibleRDatacenterCount\\" + experimentSettings + "_" + "eligibleRDatacenterCount");
@@ -605,60 +2593,33 @@ namespace ServerAllocationProblem
 		}
 		GDatacenterIDFile.close();*/
 
-		//// record matchmaking's time
-		//StreamWriter^ matchmakingTimeFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "matchmakingTime");
-		//for (auto it : matchmakingTimeAtAllSessions)
-		//{
-		//	matchmakingTimeFile->WriteLine(it);
-		//}
-		//matchmakingTimeFile->Close();	
+		// record matchmaking's time (ms) per session (written as the sessions finished)
+		matchmakingTimeFile.close();
 
 		// record computation time
-		vector<vector<vector<double>>> computationStrategyCapacitySession;
-		for (int i = 0; i < STRATEGY_COUNT; i++)
-		{
-			vector<vector<double>> computationCapacitySession;
-			for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
-			{
-				vector<double> computationSession;
-				for (int k = 0; k < SESSION_COUNT; k++)
-				{
-					computationSession.push_back(computationAtAllSessions.at(k).at(j).at(i)); // for each session k of this capacity of this strategy
-				}
-				computationCapacitySession.push_back(computationSession); // for each capacity j of this strategy
-			}
-			computationStrategyCapacitySession.push_back(computationCapacitySession); // for each strategy i
-		}
-		/*StreamWriter^ computationMeanFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "computationMean");
-		StreamWriter^ computationStdFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "computationStd");*/
-		ofstream computationMeanFile(dataDirectory + "Output\\" + experimentSettings + "_" + "computationMean.csv");
-		ofstream computationStdFile(dataDirectory + "Output\\" + experimentSettings + "_" + "computationStd.csv");
-		for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
-		{
-			for (int i = 0; i < STRATEGY_COUNT; i++)
-			{
-				computationMeanFile << GetMeanValue(computationStrategyCapacitySession.at(i).at(j)) << ",";
-				computationStdFile << GetStdValue(computationStrategyCapacitySession.at(i).at(j)) << ",";
-			}
-			computationMeanFile << "\n";
-			computationStdFile << "\n";
-		}
-		computationMeanFile.close();
-		computationStdFile.close();
+		WriteComputationData(outcomeStatistics, dataDirectory, experimentSettings, ",");
+		Instrumentation::WriteOperationCounts(dataDirectory + "Output\\" + experimentSettings + "_", SERVER_CAPACITY_LIST, GetOperationCountColumns(simulationSetting.localSearchSetting, simulationSetting.optimalSetting), ","); // mean operation counts per run (with OPERATION_COUNTING)
+
+		outputTimer.Stop();
 
 		/*******************************************************************************************************/
 
 		printf("------------------------------------------------------------------------\n");
-		printf("total elapsed time: %d seconds\n", (int)(difftime(clock(), t0) / 1000)); // elapsed time of the process
+		Instrumentation::WritePhaseTimings(dataDirectory + "Output\\" + experimentSettings + "_" + "phaseTiming.json");
+		Instrumentation::WriteMemoryProfile(dataDirectory + "Output\\" + experimentSettings + "_" + "memoryProfile.json");
+		printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count()); // elapsed time of the process
 		//cin.get();
 		return;
 	}
 
-	void SimulateGeneralProblem(double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R, double SESSION_SIZE, double SESSION_COUNT)
+	void SimulateGeneralProblem(double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R, double SESSION_SIZE, const SimulationSettingType &simulationSetting)
 	{
-		//srand((unsigned)time(nullptr)); // using current time as the seed for random_shuffle() and rand(), otherwise, they will generate the same sequence of random numbers in every run
+		// the randomness of each session is reproducible from SESSION_RANDOM_SEED and the session id (see SessionRandomnessType)
 
-		auto t0 = clock(); // start time	
+		auto t0 = std::chrono::steady_clock::now(); // start time
+		Instrumentation::ResetPhaseHistograms(); // the phase timings of this simulation only
+		Instrumentation::ResetMemoryProfile(); // and its allocations
+		Instrumentation::ResetOperationCounts(); // and its operation counts
 
 		string dataDirectory = ".\\Data\\ProblemGeneral\\";
 		vector<ClientType*> allClients;
@@ -670,159 +2631,128 @@ namespace ServerAllocationProblem
 			return;
 		}
 
-		// data structures for storing results
-		vector<vector<vector<tuple<double, double, double, double, double>>>> outcomeAtAllSessions;
-		vector<vector<vector<double>>> computationAtAllSessions;
-		vector<vector<vector<int>>> finalGDatacenterAtAllSessions;
+		string experimentSettings = std::to_string((int)DELAY_BOUND_TO_G) + "_" + std::to_string((int)DELAY_BOUND_TO_R) + "_" + std::to_string((int)SESSION_SIZE);
 
-		vector<int> eligibleGDatacenterCountAtAllSessions;
-		vector<double> matchmakingTimeAtAllSessions;
+		// data structures for storing results (updated as each session finishes)
+		OutcomeStatisticsType outcomeStatistics;
+		ofstream matchmakingTimeFile(dataDirectory + "Output\\" + experimentSettings + "_" + "matchmakingTime.csv"); // matchmaking's time (ms) per session
 
 		map<int, double> serverCountPerDC4LCP;
 		map<int, double> serverCountPerDC4LCW;
 		map<int, double> serverCountPerDC4LAC;
-		for (auto dc : allDatacenters)
-		{
-			serverCountPerDC4LCP[dc->id] = 0;
-			serverCountPerDC4LCW[dc->id] = 0;
-			serverCountPerDC4LAC[dc->id] = 0;
-		}
-
-		vector<double> SERVER_CAPACITY_LIST = { 2, 4, 6, 8 };
-
-		int STRATEGY_COUNT = 8;
-
-		for (int sessionID = 1; sessionID <= SESSION_COUNT; sessionID++)
-		{
-			vector<ClientType*> sessionClients;
-			vector<DatacenterType*> eligibleGDatacenters;
-
-			auto matchmakingStartTime = clock();
-
-			bool isFeasibleSession = Matchmaking4GeneralProblem(allDatacenters, allClients, sessionClients, eligibleGDatacenters, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
-
-			matchmakingTimeAtAllSessions.push_back(difftime(clock(), matchmakingStartTime));
-
-			if (!isFeasibleSession)
-			{
-				printf("*********************************************************************\n");
-				printf("ERROR: infeasible session\n");
-				printf("total elapsed time: %d seconds\n", (int)(difftime(clock(), t0) / 1000));
-				cin.get();
-				return;
-			}
-
-			printf("------------------------------------------------------------------------");
-			printf("delay bounds: (%d, %d)   session size: %d   session: %d\n", (int)DELAY_BOUND_TO_G, (int)DELAY_BOUND_TO_R, (int)SESSION_SIZE, sessionID);
-			printf("start of one session\n");
-
-			vector<vector<tuple<double, double, double, double, double>>> outcomeAtOneSession; // per session
-			vector<vector<double>> computationAtOneSession; // per session
-			vector<vector<int>> finalGDatacenterAtOneSession; // per session		
-
-			for (auto serverCapacity : SERVER_CAPACITY_LIST)
-			{
-				//for (auto dc : allDatacenters)
-				//{
-				//	dc->priceCombined = (dc->priceServer / serverCapacity) + dc->priceBandwidth; // dependent on server capacity
-				//}
-
-				vector<tuple<double, double, double, double, double>> outcomeAtOneCapacity; // per capacity		
-				vector<double> computationAtOneCapacity; // per capacity
-				vector<int> finalGDatacenterAtOneCapacity; // per capacity	
-
-				for (int strategyID = 1; strategyID <= STRATEGY_COUNT; strategyID++)
-				{
-					tuple<double, double, double, double, double> outcome;				
-					int finalGDatacenter;
-					auto timePoint = clock();
-					switch (strategyID)
-					{
-					case 1:
-						outcome = Alg_LB(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
-						break;
-					case 2:
-						outcome = Alg_RANDOM(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
-						break;
-					case 3:
-						outcome = Alg_NEAREST(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
-						break;
-					case 4:
-						outcome = Alg_LSP(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
-						break;
-					case 5:
-						outcome = Alg_LBP(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
-						break;
-					case 6:
-						outcome = Alg_LCP(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
-						if (8 == serverCapacity)
-						{
-							for (auto dc : allDatacenters)
-							{
-								serverCountPerDC4LCP[dc->id] += dc->openServerCount;
-							}
-						}
-						break;
-					case 7:
-						outcome = Alg_LCW(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
-						if (8 == serverCapacity)
-						{
-							for (auto dc : allDatacenters)
-							{
-								serverCountPerDC4LCW[dc->id] += dc->openServerCount;
-							}
-						}
-						break;
-					case 8:
-						outcome = Alg_LAC(eligibleGDatacenters, finalGDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, serverCapacity);
-						if (8 == serverCapacity)
-						{
-							for (auto dc : allDatacenters)
-							{
-								serverCountPerDC4LAC[dc->id] += dc->openServerCount;
-							}
-						}
-						break;
-					default:
-						outcome = tuple<double, double, double, double, double>(0, 0, 0, 0, 0);
-						break;
-					}
-					computationAtOneCapacity.push_back((double)(clock() - timePoint)); // per strategy
-					outcomeAtOneCapacity.push_back(outcome); // per strategy					
-					finalGDatacenterAtOneCapacity.push_back(finalGDatacenter); // per strategy
+		for (auto dc : allDatacenters)
+		{
+			serverCountPerDC4LCP[dc->id] = 0;
+			serverCountPerDC4LCW[dc->id] = 0;
+			serverCountPerDC4LAC[dc->id] = 0;
+		}
 
-					if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters))
-					{
-						printf("Something wrong with the assignment!\n");
-						cin.get();
-						return;
-					}			
+		vector<double> SERVER_CAPACITY_LIST = { 2, 4, 6, 8 };
+
+		// one session with the given (shared or per-worker) clients and datacenters
+		auto RunOneSession = [&](int sessionID, const vector<ClientType*> &workerClients, const vector<DatacenterType*> &workerDatacenters, SessionResultType &result)
+		{
+			vector<ClientType*> sessionClients;
+			vector<DatacenterType*> eligibleGDatacenters;
 
-					cout << "*";
-				} // end of strategy loop
+			auto matchmakingStartTime = std::chrono::steady_clock::now();
 
-				outcomeAtOneSession.push_back(outcomeAtOneCapacity); // per capacity
-				computationAtOneSession.push_back(computationAtOneCapacity); // per capacity	
-				finalGDatacenterAtOneSession.push_back(finalGDatacenterAtOneCapacity); // per capacity
+			bool isFeasibleSession = Matchmaking4GeneralProblem(workerDatacenters, workerClients, sessionClients, eligibleGDatacenters, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
 
-				cout << endl;
-			} // end of capacity loop
+			result.matchmakingTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - matchmakingStartTime).count();
+
+			if (!isFeasibleSession)
+			{
+				printf("*********************************************************************\n");
+				printf("ERROR: infeasible session\n");
+				return false;
+			}
+
+			printf("------------------------------------------------------------------------");
+			printf("delay bounds: (%d, %d)   session size: %d   session: %d\n", (int)DELAY_BOUND_TO_G, (int)DELAY_BOUND_TO_R, (int)SESSION_SIZE, sessionID);
+			printf("start of one session\n");
 
-			outcomeAtAllSessions.push_back(outcomeAtOneSession); // per session
-			computationAtAllSessions.push_back(computationAtOneSession); // per session
-			finalGDatacenterAtAllSessions.push_back(finalGDatacenterAtOneSession); // per session
+			bool isValidAssignment = simulationSetting.capacityParametric ?
+				EvaluateStrategiesParametric4GeneralProblem(eligibleGDatacenters, sessionClients, workerDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, SERVER_CAPACITY_LIST, result.outcome, result.computation, result.finalGDatacenter, result.serverCountPerDC, result.clientDelay, result.serverUtilization, result.unprovenOptimal, simulationSetting.localSearchSetting, simulationSetting.optimalSetting) :
+				(simulationSetting.cellThreadCount > 0 ?
+					EvaluateStrategiesFanOut4GeneralProblem(eligibleGDatacenters, sessionClients, workerDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, SERVER_CAPACITY_LIST, result.outcome, result.computation, result.finalGDatacenter, result.serverCountPerDC, result.clientDelay, result.serverUtilization, result.unprovenOptimal, simulationSetting.localSearchSetting, simulationSetting.optimalSetting, simulationSetting.cellThreadCount) :
+					EvaluateStrategies4GeneralProblem(eligibleGDatacenters, sessionClients, workerDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, SERVER_CAPACITY_LIST, result.outcome, result.computation, result.finalGDatacenter, result.serverCountPerDC, result.clientDelay, result.serverUtilization, result.unprovenOptimal, simulationSetting.localSearchSetting, simulationSetting.componentThreadCount, simulationSetting.optimalSetting));
+			if (!isValidAssignment)
+			{
+				printf("Something wrong with the assignment!\n");
+				return false;
+			}
 
-			eligibleGDatacenterCountAtAllSessions.push_back((int)eligibleGDatacenters.size()); // per session
+			result.eligibleGDatacenterCount = (int)eligibleGDatacenters.size();
 
 			printf("end of one session\n");
-		} // end of session iteration
+			return true;
+		};
+
+		// checkpoint of the per-session results, so that an interrupted run only loses the sessions not consumed yet
+		ResultCacheType *resultCache = nullptr;
+		if (simulationSetting.resultCaching && !(simulationSetting.localSearchSetting.enabled && simulationSetting.localSearchSetting.timeBudget > 0) && !(simulationSetting.optimalSetting.enabled && simulationSetting.optimalSetting.timeBudget > 0))
+		{
+			resultCache = new ResultCacheType(dataDirectory, GetResultCacheKey(dataDirectory, GetSimulationParameters("general", DELAY_BOUND_TO_G, DELAY_BOUND_TO_R, SESSION_SIZE, SERVER_CAPACITY_LIST, simulationSetting.capacityParametric, simulationSetting.localSearchSetting, simulationSetting.optimalSetting)));
+		}
+
+		// every session's rows, written by a background thread
+		RawResults::RawResultWriterType *rawResultWriter = nullptr;
+		if (simulationSetting.rawResults) rawResultWriter = new RawResults::RawResultWriterType(dataDirectory + "Output\\" + experimentSettings + "_" + "rawResults.bin", RawResults::PROBLEM_GENERAL, SERVER_CAPACITY_LIST, experimentSettings);
+
+		// merge in session order
+		const vector<int> SERVER_COUNT_COLUMNS = GetServerCountColumns(); // LCP, LCW and LAC
+		auto ConsumeSession = [&](int sessionID, const SessionResultType &result)
+		{
+			if (rawResultWriter) rawResultWriter->AppendSession(sessionID, result);
+			for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+			{
+				if (8 == SERVER_CAPACITY_LIST.at(j))
+				{
+					for (auto dc : allDatacenters)
+					{
+						serverCountPerDC4LCP[dc->id] += result.serverCountPerDC.at(j).at(SERVER_COUNT_COLUMNS.at(0)).at(dc->id);
+						serverCountPerDC4LCW[dc->id] += result.serverCountPerDC.at(j).at(SERVER_COUNT_COLUMNS.at(1)).at(dc->id);
+						serverCountPerDC4LAC[dc->id] += result.serverCountPerDC.at(j).at(SERVER_COUNT_COLUMNS.at(2)).at(dc->id);
+					}
+				}
+			}
+
+			outcomeStatistics.Add(result.outcome, result.computation, result.isCached);
+			outcomeStatistics.AddDistributions(result.clientDelay, result.serverUtilization);
+			outcomeStatistics.AddUnprovenOptimal(result.unprovenOptimal);
+			if (!result.isCached) matchmakingTimeFile << result.matchmakingTime << "\n"; // not the time of an earlier run
+		};
+
+		vector<vector<double>> sessionCountOfCell, relativeHalfWidthOfCell; // of the adaptive stopping
+		bool isSimulationDone = simulationSetting.adaptiveStopping.enabled ?
+			RunSessionsAdaptively(simulationSetting.SESSION_COUNT, simulationSetting.adaptiveStopping, simulationSetting.threadCount, allClients, allDatacenters, RunOneSession, ConsumeSession, resultCache, sessionCountOfCell, relativeHalfWidthOfCell) :
+			RunSessions(1, simulationSetting.SESSION_COUNT, simulationSetting.threadCount, allClients, allDatacenters, RunOneSession, ConsumeSession, resultCache);
+		delete resultCache;
+		if (rawResultWriter)
+		{
+			if (!rawResultWriter->Close()) printf("ERROR: writing %s failed\n", rawResultWriter->fileName.c_str());
+			else printf("%d rows written to %s (the sessions waited %.1f ms for the writer)\n", (int)rawResultWriter->rowCount, rawResultWriter->fileName.c_str(), rawResultWriter->waitingTime);
+			delete rawResultWriter;
+		}
+		if (!isSimulationDone)
+		{
+			printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+			cin.get();
+			return;
+		}
 
 		/*******************************************************************************************************/
 
-		string experimentSettings = std::to_string((int)DELAY_BOUND_TO_G) + "_" + std::to_string((int)DELAY_BOUND_TO_R) + "_" + std::to_string((int)SESSION_SIZE);
+		Instrumentation::PhaseTimerType outputTimer(Instrumentation::PHASE_OUTPUT);
 
 		// record cost, wastage and delay
-		WriteCostWastageDelayData(STRATEGY_COUNT, SERVER_CAPACITY_LIST, SESSION_COUNT, outcomeAtAllSessions, dataDirectory, experimentSettings);
+		WriteCostWastageDelayData(outcomeStatistics, dataDirectory, experimentSettings);
+		WriteDelayAndUtilizationData(outcomeStatistics, dataDirectory, experimentSettings);
+		if (simulationSetting.optimalSetting.enabled) WriteUnprovenOptimalData(outcomeStatistics, dataDirectory, experimentSettings);
+
+		// record the sessions used by each cell and its final precision
+		if (simulationSetting.adaptiveStopping.enabled) WriteAdaptiveStoppingData(sessionCountOfCell, relativeHalfWidthOfCell, dataDirectory, experimentSettings);
 
 		// record server count at each datacenter in all sessions
 		//StreamWriter^ serverCountPerDCFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "serverCountPerDC");
@@ -868,77 +2798,232 @@ namespace ServerAllocationProblem
 		}
 		eligibleGDatacenterCountFile.close();*/
 
+		// record matchmaking's time (ms) per session (written as the sessions finished)
+		matchmakingTimeFile.close();
+
 		// record computation time
-		vector<vector<vector<double>>> computationStrategyCapacitySession;
-		for (int i = 0; i < STRATEGY_COUNT; i++)
+		WriteComputationData(outcomeStatistics, dataDirectory, experimentSettings, " ");
+		Instrumentation::WriteOperationCounts(dataDirectory + "Output\\" + experimentSettings + "_", SERVER_CAPACITY_LIST, GetOperationCountColumns(simulationSetting.localSearchSetting, simulationSetting.optimalSetting), " "); // mean operation counts per run (with OPERATION_COUNTING)
+
+		outputTimer.Stop();
+
+		/*******************************************************************************************************/
+
+		printf("------------------------------------------------------------------------\n");
+		Instrumentation::WritePhaseTimings(dataDirectory + "Output\\" + experimentSettings + "_" + "phaseTiming.json");
+		Instrumentation::WriteMemoryProfile(dataDirectory + "Output\\" + experimentSettings + "_" + "memoryProfile.json");
+		printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count()); // elapsed time of the process
+		//cin.get();
+		return;
+	}
+
+	// run the portfolio allocator on each session of basic problem, and record its cost, winning strategies and best-so-far traces
+	void SimulatePortfolio4BasicProblem(double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R, double SESSION_SIZE, double SESSION_COUNT, PortfolioSettingType portfolioSetting)
+	{
+		auto t0 = std::chrono::steady_clock::now(); // start time
+		Instrumentation::ResetPhaseHistograms(); // the phase timings of this simulation only
+		Instrumentation::ResetMemoryProfile(); // and its allocations
+		Instrumentation::ResetOperationCounts(); // and its operation counts
+
+		string dataDirectory = ".\\Data\\ProblemBasic\\";
+		vector<ClientType*> allClients;
+		vector<DatacenterType*> allDatacenters;
+		if (!Initialize(dataDirectory, allClients, allDatacenters))
+		{
+			printf("ERROR: simulation initialization failed!\n");
+			cin.get();
+			return;
+		}
+
+		string experimentSettings = std::to_string((int)DELAY_BOUND_TO_G) + "_" + std::to_string((int)DELAY_BOUND_TO_R) + "_" + std::to_string((int)SESSION_SIZE);
+
+		vector<double> SERVER_CAPACITY_LIST = { 2, 4, 6, 8 };
+
+		// data structures for storing results
+		vector<vector<double>> costTotalAtAllCapacities(SERVER_CAPACITY_LIST.size()); // normalized by the LB, per capacity
+		vector<vector<int>> winCountAtAllCapacities(SERVER_CAPACITY_LIST.size(), vector<int>(STRATEGY_COUNT + 1, 0)); // wins of each strategy followed by the wins improved by LS, per capacity
+
+		// record each best-so-far solution: session, capacity, elapsed time (ms), total cost (normalized by the LB), strategy, improved by LS
+		ofstream portfolioTraceFile(dataDirectory + "Output\\" + experimentSettings + "_" + "portfolioTrace.csv");
+
+		for (int sessionID = 1; sessionID <= SESSION_COUNT; sessionID++)
 		{
-			vector<vector<double>> computationCapacitySession;
+			SessionRandomnessType randomness(sessionID);
+			vector<ClientType*> sessionClients;
+			int GDatacenterID;
+			if (!Matchmaking4BasicProblem(allDatacenters, allClients, GDatacenterID, sessionClients, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R))
+			{
+				printf("--------------------------------------------------------------------\n");
+				printf("ERROR: infeasible session\n");
+				printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+				cin.get();
+				return;
+			}
+
+			printf("------------------------------------------------------------------------\n");
+			printf("delay bounds: (%d, %d) session size: %d session: %d\n", (int)DELAY_BOUND_TO_G, (int)DELAY_BOUND_TO_R, (int)SESSION_SIZE, sessionID);
+			printf("executing portfolio\n");
+
 			for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
 			{
-				vector<double> computationSession;
-				for (int k = 0; k < SESSION_COUNT; k++)
+				double lowerBound = get<0>(Alg_LB(sessionClients, allDatacenters, SERVER_CAPACITY_LIST.at(j), GDatacenterID));
+				auto portfolioOutcome = AllocateByPortfolio(sessionClients, allDatacenters, SERVER_CAPACITY_LIST.at(j), GDatacenterID, portfolioSetting);
+				if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters))
 				{
-					computationSession.push_back(computationAtAllSessions.at(k).at(j).at(i)); // for each session k of this capacity of this strategy
+					printf("Something wrong with client-to-datacenter assignment!\n");
+					cin.get();
+					return;
 				}
-				computationCapacitySession.push_back(computationSession); // for each capacity j of this strategy
-			}
-			computationStrategyCapacitySession.push_back(computationCapacitySession); // for each strategy i
+
+				costTotalAtAllCapacities.at(j).push_back(get<0>(portfolioOutcome.outcome) / lowerBound);
+				winCountAtAllCapacities.at(j).at(portfolioOutcome.winningStrategyID - 1)++;
+				if (portfolioOutcome.isImprovedByLocalSearch) winCountAtAllCapacities.at(j).back()++;
+				for (auto &entry : portfolioOutcome.trace)
+				{
+					portfolioTraceFile << sessionID << "," << SERVER_CAPACITY_LIST.at(j) << "," << entry.elapsedTime << "," << entry.costTotal / lowerBound << "," << entry.strategyID << "," << entry.isImprovedByLocalSearch << "\n";
+				}
+
+				cout << "*";
+			} // end of capacity loop
+
+			cout << endl;
+			printf("end of executing portfolio\n");
 		}
-		/*StreamWriter^ computationMeanFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "computationMean");
-		StreamWriter^ computationStdFile = gcnew StreamWriter(dataDirectory + "Output\\" + experimentSettings + "_" + "computationStd");*/
-		ofstream computationMeanFile(dataDirectory + "Output\\" + experimentSettings + "_" + "computationMean.csv");
-		ofstream computationStdFile(dataDirectory + "Output\\" + experimentSettings + "_" + "computationStd.csv");
+		portfolioTraceFile.close();
+
+		/*******************************************************************************************************/
+
+		Instrumentation::PhaseTimerType outputTimer(Instrumentation::PHASE_OUTPUT);
+
+		// record total cost
+		ofstream costTotalMeanFile(dataDirectory + "Output\\" + experimentSettings + "_" + "portfolioCostTotalMean.csv");
+		ofstream costTotalStdFile(dataDirectory + "Output\\" + experimentSettings + "_" + "portfolioCostTotalStd.csv");
+		for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+		{
+			costTotalMeanFile << GetMeanValue(costTotalAtAllCapacities.at(j)) << ",\n";
+			costTotalStdFile << GetStdValue(costTotalAtAllCapacities.at(j)) << ",\n";
+		}
+		costTotalMeanFile.close();
+		costTotalStdFile.close();
+
+		// record winning strategies
+		ofstream winCountFile(dataDirectory + "Output\\" + experimentSettings + "_" + "portfolioWinner.csv");
 		for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
 		{
-			for (int i = 0; i < STRATEGY_COUNT; i++)
+			for (auto winCount : winCountAtAllCapacities.at(j))
 			{
-				computationMeanFile << GetMeanValue(computationStrategyCapacitySession.at(i).at(j)) << " ";
-				computationStdFile << GetStdValue(computationStrategyCapacitySession.at(i).at(j)) << " ";
+				winCountFile << winCount << ",";
 			}
-			computationMeanFile << "\n";
-			computationStdFile << "\n";
+			winCountFile << "\n";
 		}
-		computationMeanFile.close();
-		computationStdFile.close();
+		winCountFile.close();
+
+		outputTimer.Stop();
 
 		/*******************************************************************************************************/
 
 		printf("------------------------------------------------------------------------\n");
-		printf("total elapsed time: %d seconds\n", (int)(difftime(clock(), t0) / 1000)); // elapsed time of the process
-		//cin.get();
+		Instrumentation::WritePhaseTimings(dataDirectory + "Output\\" + experimentSettings + "_" + "portfolioPhaseTiming.json");
+		Instrumentation::WriteMemoryProfile(dataDirectory + "Output\\" + experimentSettings + "_" + "portfolioMemoryProfile.json");
+		printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count()); // elapsed time of the process
 		return;
 	}
 
-	// Lower-Bound (LB)
-	// for basic problem
-	tuple<double, double, double, double, double> Alg_LB(
+	void BenchmarkCapacitySpecialization(double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R, double SESSION_SIZE, double SESSION_COUNT, int repetitionCount)
+	{
+		string dataDirectory = ".\\Data\\ProblemBasic\\";
+		vector<ClientType*> allClients;
+		vector<DatacenterType*> allDatacenters;
+		if (!Initialize(dataDirectory, allClients, allDatacenters))
+		{
+			printf("ERROR: simulation initialization failed!\n");
+			cin.get();
+			return;
+		}
+
+		const vector<double> SERVER_CAPACITY_LIST = { 2, 4, 6, 8 };
+		const int LAST_STRATEGY = 8; // LAC (OPT does not depend on the capacity specialization)
+
+		// milliseconds with the run-time and with the compile-time capacity, indexed by [capacity][strategy]
+		vector<vector<double>> runTimeCapacityTime(SERVER_CAPACITY_LIST.size(), vector<double>(LAST_STRATEGY, 0));
+		vector<vector<double>> compileTimeCapacityTime = runTimeCapacityTime;
+
+		for (int sessionID = 1; sessionID <= SESSION_COUNT; sessionID++)
+		{
+			SessionRandomnessType randomness(sessionID);
+			int GDatacenterID;
+			vector<ClientType*> sessionClients;
+			if (!Matchmaking4BasicProblem(allDatacenters, allClients, GDatacenterID, sessionClients, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R))
+			{
+				printf("ERROR: infeasible session\n");
+				cin.get();
+				return;
+			}
+
+			for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+			{
+				for (int strategyID = 1; strategyID <= LAST_STRATEGY; strategyID++)
+				{
+					tuple<double, double, double, double, double> outcome[2];
+					for (int k = 0; k < 2; k++)
+					{
+						int specialized = (sessionID + k) % 2; // which one runs first alternates between sessions
+						auto timePoint = std::chrono::steady_clock::now();
+						for (int repetition = 0; repetition < repetitionCount; repetition++)
+						{
+							outcome[specialized] = RunStrategy4BasicProblem(strategyID, sessionClients, allDatacenters, SERVER_CAPACITY_LIST.at(j), GDatacenterID, 1 == specialized);
+						}
+						double elapsedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count();
+						(1 == specialized ? compileTimeCapacityTime : runTimeCapacityTime).at(j).at(strategyID - 1) += elapsedTime;
+					}
+
+					if (outcome[0] != outcome[1])
+					{
+						printf("ERROR: strategy %d at capacity %d has a different outcome with the compile-time capacity\n", strategyID, (int)SERVER_CAPACITY_LIST.at(j));
+						cin.get();
+						return;
+					}
+				}
+			}
+		}
+
+		ofstream benchmarkFile(dataDirectory + "Output\\" + "capacitySpecialization.csv");
+		benchmarkFile << "capacity,strategy,runTimeCapacity,compileTimeCapacity,speedup\n";
+		double runTimeCapacityTotal = 0, compileTimeCapacityTotal = 0;
+		for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+		{
+			for (int i = 0; i < LAST_STRATEGY; i++)
+			{
+				double runTime = runTimeCapacityTime.at(j).at(i), compileTime = compileTimeCapacityTime.at(j).at(i);
+				benchmarkFile << SERVER_CAPACITY_LIST.at(j) << "," << i + 1 << "," << runTime << "," << compileTime << "," << runTime / compileTime << "\n";
+				printf("capacity %d strategy %d: %.1f ms with the run-time capacity, %.1f ms with the compile-time capacity (%.2fx)\n", (int)SERVER_CAPACITY_LIST.at(j), i + 1, runTime, compileTime, runTime / compileTime);
+				runTimeCapacityTotal += runTime;
+				compileTimeCapacityTotal += compileTime;
+			}
+		}
+		benchmarkFile.close();
+		printf("total: %.1f ms with the run-time capacity, %.1f ms with the compile-time capacity (%.2fx)\n", runTimeCapacityTotal, compileTimeCapacityTotal, runTimeCapacityTotal / compileTimeCapacityTotal);
+	}
+
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_LB::Run(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double serverCapacity,
+		CapacityType<CAPACITY> serverCapacity,
 		int GDatacenterID)
 	{
 		ResetAssignment(sessionClients, allDatacenters);
 
+		PriceOrderType priceOrder; // sorted once per capacity (and traffic volume)
+		double orderedTrafficVolume = -1;
 		for (auto client : sessionClients)
 		{
-			//client->assignedDatacenterID = get<0>(*min_element(client->eligibleDatacenterList.begin(), client->eligibleDatacenterList.end(), EligibleDCComparatorByPriceCombined));
-			client->assignedDatacenterID = client->eligibleDatacenters.front()->id;
-			for (auto edc : client->eligibleDatacenters)
+			if (client->chargedTrafficVolume != orderedTrafficVolume)
 			{
-				double priceCombinedPrevious = allDatacenters.at(client->assignedDatacenterID)->priceServer / serverCapacity + allDatacenters.at(client->assignedDatacenterID)->priceBandwidth * client->chargedTrafficVolume;
-				double priceCombinedCurrent = edc->priceServer / serverCapacity + edc->priceBandwidth * client->chargedTrafficVolume;
-				if (priceCombinedCurrent < priceCombinedPrevious)
-				{
-					client->assignedDatacenterID = edc->id;
-				}
-				else if (priceCombinedCurrent == priceCombinedPrevious)
-				{
-					if (client->delayToDatacenter.at(edc->id) < client->delayToDatacenter.at(client->assignedDatacenterID))
-					{
-						client->assignedDatacenterID = edc->id;
-					}
-				}
+				priceOrder = SortDatacentersByPrice(allDatacenters, PRICE_COMBINED, serverCapacity.Real(), client->chargedTrafficVolume);
+				orderedTrafficVolume = client->chargedTrafficVolume;
 			}
+			client->assignedDatacenterID = GetFirstEligibleDatacenter(client, priceOrder)->id;
 
 			//allDatacenters.at(client->assignedDatacenterID)->assignedClientList.push_back(client->id);
 			allDatacenters.at(client->assignedDatacenterID)->assignedClients.push_back(client);
@@ -948,7 +3033,7 @@ namespace ServerAllocationProblem
 		for (auto dc : allDatacenters)
 		{
 			//dc->openServerCount = dc->assignedClientList.size() / serverCapacity;
-			dc->openServerCount = double(dc->assignedClients.size()) / serverCapacity;
+			dc->openServerCount = double(dc->assignedClients.size()) / serverCapacity.Real();
 			numberServers += dc->openServerCount;
 			costServer += dc->priceServer * dc->openServerCount;
 			double totalChargedTrafficVolume = 0;
@@ -960,6 +3045,7 @@ namespace ServerAllocationProblem
 		}
 
 		double totalDelay = 0;
+		COUNT_OPERATIONS(OPERATION_MAP_LOOKUPS, 2 * sessionClients.size());
 		for (auto client : sessionClients)
 		{
 			totalDelay += client->delayToDatacenter[client->assignedDatacenterID] + allDatacenters.at(client->assignedDatacenterID)->delayToDatacenter[GDatacenterID];
@@ -973,56 +3059,21 @@ namespace ServerAllocationProblem
 			totalDelay / sessionClients.size());
 	}
 
-	// Lower-Bound (LB)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LB(
-		vector<DatacenterType*> eligibleGDatacenters,
-		int &finalGDatacenter,
-		const vector<ClientType*> &sessionClients,
-		const vector<DatacenterType*> &allDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R,
-		double serverCapacity,
-		bool includingGServerCost)
-	{
-		tuple<double, double, double, double, double> finalOutcome;
-		double totalCost = INT_MAX;
-		int tempFinalGDatacenter = eligibleGDatacenters.front()->id;
-
-		for (auto GDatacenter : eligibleGDatacenters)
-		{
-			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R); // initilization		
-			auto tempOutcome = Alg_LB(sessionClients, allDatacenters, serverCapacity, GDatacenter->id);
-			double tempTotalCost = get<0>(tempOutcome);
-			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
-			if (tempTotalCost < totalCost) // choose the smaller cost
-			{
-				totalCost = tempTotalCost;
-				finalOutcome = tempOutcome;
-				tempFinalGDatacenter = GDatacenter->id;
-			}
-		}
-
-		finalGDatacenter = tempFinalGDatacenter;
-		return finalOutcome;
-	}
-
-	// Random-Assignment
-	// for basic problem
-	tuple<double, double, double, double, double> Alg_RANDOM(
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_RANDOM::Run(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double serverCapacity,
+		CapacityType<CAPACITY> serverCapacity,
 		int GDatacenterID)
 	{
 		ResetAssignment(sessionClients, allDatacenters);
 
+		CounterRandomType assignmentRandom = GetSessionRandom(RANDOM_PURPOSE_RANDOM_ASSIGNMENT, GDatacenterID); // the same choices at every capacity and in every thread for this G datacenter
+
 		for (auto client : sessionClients) // choose a dc for each client
 		{
 			//client->assignedDatacenterID = get<0>(client->eligibleDatacenterList.at(rand() % (int)client->eligibleDatacenterList.size()));
-			vector<DatacenterType*> copyEligibleDatacenters(client->eligibleDatacenters);
-			std::random_shuffle(copyEligibleDatacenters.begin(), copyEligibleDatacenters.end());
-			client->assignedDatacenterID = copyEligibleDatacenters.front()->id;
+			client->assignedDatacenterID = PickOne(client->eligibleDatacenters, assignmentRandom)->id;
 		
 			//allDatacenters.at(client->assignedDatacenterID)->assignedClientList.push_back(client->id); // add this client to the chosen dc's assigned client list
 			allDatacenters.at(client->assignedDatacenterID)->assignedClients.push_back(client);
@@ -1031,46 +3082,11 @@ namespace ServerAllocationProblem
 		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
 	}
 
-	// Random-Assignment
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_RANDOM(
-		vector<DatacenterType*> eligibleGDatacenters,
-		int &finalGDatacenter,
-		const vector<ClientType*> &sessionClients,
-		const vector<DatacenterType*> &allDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R,
-		double serverCapacity,
-		bool includingGServerCost)
-	{
-		tuple<double, double, double, double, double> finalOutcome;
-		double totalCost = INT_MAX;
-		int tempFinalGDatacenter = eligibleGDatacenters.front()->id;
-
-		for (auto GDatacenter : eligibleGDatacenters)
-		{
-			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R); // initilization		
-			auto tempOutcome = Alg_RANDOM(sessionClients, allDatacenters, serverCapacity, GDatacenter->id);
-			double tempTotalCost = get<0>(tempOutcome);
-			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
-			if (tempTotalCost < totalCost) // choose the smaller cost
-			{
-				totalCost = tempTotalCost;
-				finalOutcome = tempOutcome;
-				tempFinalGDatacenter = GDatacenter->id;
-			}
-		}
-
-		finalGDatacenter = tempFinalGDatacenter;
-		return finalOutcome;
-	}
-
-	// Nearest-Assignment
-	// for basic problem
-	tuple<double, double, double, double, double> Alg_NEAREST(
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_NEAREST::Run(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double serverCapacity,
+		CapacityType<CAPACITY> serverCapacity,
 		int GDatacenterID)
 	{
 		ResetAssignment(sessionClients, allDatacenters);
@@ -1094,68 +3110,40 @@ namespace ServerAllocationProblem
 		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
 	}
 
-	// Nearest-Assignment
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_NEAREST(
-		vector<DatacenterType*> eligibleGDatacenters,
-		int &finalGDatacenter,
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_LSP::Run(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R,
-		double serverCapacity,
-		bool includingGServerCost)
+		CapacityType<CAPACITY> serverCapacity,
+		int GDatacenterID)
 	{
-		tuple<double, double, double, double, double> finalOutcome;
-		double totalCost = INT_MAX;
-		int tempFinalGDatacenter = eligibleGDatacenters.front()->id;
+		ResetAssignment(sessionClients, allDatacenters);
 
-		for (auto GDatacenter : eligibleGDatacenters)
+		auto priceOrder = SortDatacentersByPrice(allDatacenters, PRICE_SERVER); // sorted once per call
+		for (auto client : sessionClients)
 		{
-			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R); // initilization				
-			auto tempOutcome = Alg_NEAREST(sessionClients, allDatacenters, serverCapacity, GDatacenter->id);
-			double tempTotalCost = get<0>(tempOutcome);
-			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
-			if (tempTotalCost < totalCost) // choose the smaller cost
-			{
-				totalCost = tempTotalCost;
-				finalOutcome = tempOutcome;
-				tempFinalGDatacenter = GDatacenter->id;
-			}
+			client->assignedDatacenterID = GetFirstEligibleDatacenter(client, priceOrder)->id;
+
+			//allDatacenters.at(client->assignedDatacenterID)->assignedClientList.push_back(client->id); // add this client to the chosen dc's assigned client list
+			allDatacenters.at(client->assignedDatacenterID)->assignedClients.push_back(client);
 		}
 
-		finalGDatacenter = tempFinalGDatacenter;
-		return finalOutcome;
+		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
 	}
 
-	// Lowest-Server-Price-Datacenter-Assignment (LSP)
-	// for basic problem
-	tuple<double, double, double, double, double> Alg_LSP(
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_LBP::Run(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double serverCapacity,
+		CapacityType<CAPACITY> serverCapacity,
 		int GDatacenterID)
 	{
 		ResetAssignment(sessionClients, allDatacenters);
 
+		auto priceOrder = SortDatacentersByPrice(allDatacenters, PRICE_BANDWIDTH); // sorted once per call
 		for (auto client : sessionClients)
 		{
-			//client->assignedDatacenterID = get<0>(*min_element(client->eligibleDatacenterList.begin(), client->eligibleDatacenterList.end(), EligibleDCComparatorByPriceServer));
-			client->assignedDatacenterID = client->eligibleDatacenters.front()->id;
-			for (auto edc : client->eligibleDatacenters)
-			{
-				if (edc->priceServer < allDatacenters.at(client->assignedDatacenterID)->priceServer)
-				{
-					client->assignedDatacenterID = edc->id;
-				}
-				else if (edc->priceServer == allDatacenters.at(client->assignedDatacenterID)->priceServer)
-				{
-					if (client->delayToDatacenter.at(edc->id) < client->delayToDatacenter.at(client->assignedDatacenterID))
-					{
-						client->assignedDatacenterID = edc->id;
-					}
-				}
-			}
+			client->assignedDatacenterID = GetFirstEligibleDatacenter(client, priceOrder)->id;
 
 			//allDatacenters.at(client->assignedDatacenterID)->assignedClientList.push_back(client->id); // add this client to the chosen dc's assigned client list
 			allDatacenters.at(client->assignedDatacenterID)->assignedClients.push_back(client);
@@ -1164,472 +3152,877 @@ namespace ServerAllocationProblem
 		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
 	}
 
-	// Lowest-Bandwidth-Price-Datacenter-Assignment (LBP)
-	// for basic problem
-	tuple<double, double, double, double, double> Alg_LBP(
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_LCP::Run(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double serverCapacity,
+		CapacityType<CAPACITY> serverCapacity,
 		int GDatacenterID)
 	{
 		ResetAssignment(sessionClients, allDatacenters);
 
-		auto clock_begin = clock();
+		PriceOrderType priceOrder; // sorted once per capacity (and traffic volume)
+		double orderedTrafficVolume = -1;
 		for (auto client : sessionClients)
 		{
-			//client->assignedDatacenterID = get<0>(*min_element(client->eligibleDatacenterList.begin(), client->eligibleDatacenterList.end(), EligibleDCComparatorByPriceBandwidth));
-			client->assignedDatacenterID = client->eligibleDatacenters.front()->id;
-			for (auto edc : client->eligibleDatacenters)
+			if (client->chargedTrafficVolume != orderedTrafficVolume)
 			{
-				if (edc->priceBandwidth < allDatacenters.at(client->assignedDatacenterID)->priceBandwidth)
-				{
-					client->assignedDatacenterID = edc->id;
-				}
-				else if (edc->priceBandwidth == allDatacenters.at(client->assignedDatacenterID)->priceBandwidth)
-				{
-					if (client->delayToDatacenter.at(edc->id) < client->delayToDatacenter.at(client->assignedDatacenterID))
-					{
-						client->assignedDatacenterID = edc->id;
-					}
-				}
+				priceOrder = SortDatacentersByPrice(allDatacenters, PRICE_COMBINED, serverCapacity.Real(), client->chargedTrafficVolume);
+				orderedTrafficVolume = client->chargedTrafficVolume;
 			}
+			client->assignedDatacenterID = GetFirstEligibleDatacenter(client, priceOrder)->id;
 
-			//allDatacenters.at(client->assignedDatacenterID)->assignedClientList.push_back(client->id); // add this client to the chosen dc's assigned client list
+			//allDatacenters.at(client->assignedDatacenterID)->assignedClientList.push_back(client->id);
 			allDatacenters.at(client->assignedDatacenterID)->assignedClients.push_back(client);
 		}
 
 		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
 	}
 
-	// Lowest-Combined-Price-Datacenter-Assignment (LCP)
-	// for basic problem
-	tuple<double, double, double, double, double> Alg_LCP(
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_LCW::Run(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double serverCapacity,
+		CapacityType<CAPACITY> serverCapacity,
 		int GDatacenterID)
 	{
+		if (serverCapacity.Real() < 2) return Policy_LCP::Run(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+
 		ResetAssignment(sessionClients, allDatacenters);
 
-		for (auto client : sessionClients)
+		while (true)
 		{
-			//client->assignedDatacenterID = get<0>(*min_element(client->eligibleDatacenterList.begin(), client->eligibleDatacenterList.end(), EligibleDCComparatorByPriceCombined));
-			client->assignedDatacenterID = client->eligibleDatacenters.front()->id;
-			for (auto edc : client->eligibleDatacenters)
+			COUNT_OPERATIONS(OPERATION_ITERATIONS, 1);
+			vector<DatacenterType*> candidateDatacenters;
+			candidateDatacenters.clear();
+			for (auto dc : allDatacenters)
 			{
-				double priceCombinedPrevious = allDatacenters.at(client->assignedDatacenterID)->priceServer / serverCapacity + allDatacenters.at(client->assignedDatacenterID)->priceBandwidth * client->chargedTrafficVolume;
-				double priceCombinedCurrent = edc->priceServer / serverCapacity + edc->priceBandwidth * client->chargedTrafficVolume;
-				if (priceCombinedCurrent < priceCombinedPrevious)
-				{
-					client->assignedDatacenterID = edc->id;
-				}
-				else if (priceCombinedCurrent == priceCombinedPrevious)
+				dc->unassignedCoverableClients.clear(); // reset for new iteration
+				COUNT_OPERATIONS(OPERATION_COVERABLE_CLIENT_SCANS, dc->coverableClients.size());
+
+				for (auto client : dc->coverableClients)
 				{
-					if (client->delayToDatacenter.at(edc->id) < client->delayToDatacenter.at(client->assignedDatacenterID))
+					if (client->assignedDatacenterID < 0)
 					{
-						client->assignedDatacenterID = edc->id;
+						dc->unassignedCoverableClients.push_back(client);
 					}
 				}
+
+				if (!dc->unassignedCoverableClients.empty())
+				{
+					candidateDatacenters.push_back(dc);
+				}
+			}
+			if (candidateDatacenters.empty()) // indicating that no more datacenters that have unassigned coverable clients
+			{
+				break; // terminate
 			}
 
-			//allDatacenters.at(client->assignedDatacenterID)->assignedClientList.push_back(client->id); // add this client to the chosen dc's assigned client list
-			allDatacenters.at(client->assignedDatacenterID)->assignedClients.push_back(client);
+			DatacenterType* nextDC = candidateDatacenters.front(); // initialization
+			for (auto dc : candidateDatacenters)
+			{
+				double utilization_dc; // compute utilization for the current dc
+				int unassignedClientCount_dc = (int)dc->unassignedCoverableClients.size();
+				if (unassignedClientCount_dc % serverCapacity.Integer() == 0)
+					utilization_dc = 1;
+				else
+					utilization_dc = (double)(unassignedClientCount_dc % serverCapacity.Integer()) / serverCapacity.Real();
+
+				double utilization_nextDC; // compute utilization for the previously selected dc (the one with highest utilization so far)
+				int unassignedClientCount_nextDC = (int)nextDC->unassignedCoverableClients.size();
+				if (unassignedClientCount_nextDC % serverCapacity.Integer() == 0)
+					utilization_nextDC = 1;
+				else
+					utilization_nextDC = (double)(unassignedClientCount_nextDC % serverCapacity.Integer()) / serverCapacity.Real();
+
+				// choose the one with higher projected utilization	
+				// if two utilizations tie, select the one with lower server price
+				if (utilization_dc > utilization_nextDC || (utilization_dc == utilization_nextDC && dc->priceServer < nextDC->priceServer))
+				{
+					nextDC = dc;
+				}
+			}
+
+			for (auto client : nextDC->unassignedCoverableClients) // client-to-datacenter assignment
+			{
+				client->assignedDatacenterID = nextDC->id;
+				//nextDC->assignedClientList.push_back(client->id);
+				nextDC->assignedClients.push_back(client);
+			}
 		}
 
 		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
 	}
 
-	// Lowest-Server-Price-Datacenter-Assignment (LSP)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LSP(
-		vector<DatacenterType*> eligibleGDatacenters,
-		int &finalGDatacenter,
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_LAC::Run(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R,
-		double serverCapacity,
-		bool includingGServerCost)
+		CapacityType<CAPACITY> serverCapacity,
+		int GDatacenterID)
 	{
-		tuple<double, double, double, double, double> finalOutcome;
-
-		double totalCost = INT_MAX;
-		int tempFinalGDatacenter = eligibleGDatacenters.front()->id;
+		if (serverCapacity.Real() < 2) return Policy_LCP::Run(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
 
-		map<int, double> finalServerCountPerDC; // newly added
+		ResetAssignment(sessionClients, allDatacenters);
 
-		for (auto GDatacenter : eligibleGDatacenters)
+		while (true)
 		{
-			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
-			auto tempOutcome = Alg_LSP(sessionClients, allDatacenters, serverCapacity, GDatacenter->id);
-			double tempTotalCost = get<0>(tempOutcome);
-
-			map<int, double> tempServerCountPerDC; // newly added
-			for (auto dc : allDatacenters) // newly added
+			// update for the new iteration
+			COUNT_OPERATIONS(OPERATION_ITERATIONS, 1);
+			vector<DatacenterType*> candidateDatacenters;
+			candidateDatacenters.clear();
+			for (auto dc : allDatacenters)
 			{
-				tempServerCountPerDC[dc->id] = dc->openServerCount;
-			}
+				dc->unassignedCoverableClients.clear();
+				COUNT_OPERATIONS(OPERATION_COVERABLE_CLIENT_SCANS, dc->coverableClients.size());
 
-			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
+				for (auto client : dc->coverableClients)
+				{
+					if (client->assignedDatacenterID < 0) { dc->unassignedCoverableClients.push_back(client); }
+				}
 
-			if (tempTotalCost < totalCost) // choose the smaller cost
+				if (!dc->unassignedCoverableClients.empty()) { candidateDatacenters.push_back(dc); }
+			}
+
+			// all clients are assigned, so terminate the iteration
+			if (candidateDatacenters.empty())
 			{
-				totalCost = tempTotalCost;
+				break;
+			}
 
-				finalOutcome = tempOutcome;
+			// compute the average cost per client if opening a server in each dc		
+			for (auto dc : candidateDatacenters)
+			{				
+				if (dc->unassignedCoverableClients.empty())
+				{
+					dc->averageCostPerClient = INT_MAX;
+				}
+				else if (dc->unassignedCoverableClients.size() <= serverCapacity.Real())
+				{					
+					double avgServerCostPerClient = dc->priceServer / dc->unassignedCoverableClients.size();
+					double totalChargedTrafficVolume = 0;
+					for (auto client : dc->unassignedCoverableClients)
+					{
+						totalChargedTrafficVolume += client->chargedTrafficVolume;
+					}
+					double avgBandwidthCostPerClient = (dc->priceBandwidth * totalChargedTrafficVolume) / dc->unassignedCoverableClients.size();
+					
+					dc->averageCostPerClient = avgServerCostPerClient + avgBandwidthCostPerClient;
+				}
+				else
+				{
+					double avgServerCostPerClient = dc->priceServer / serverCapacity.Real();
+					double totalChargedTrafficVolume = 0;
+					for (auto client : dc->unassignedCoverableClients)
+					{
+						totalChargedTrafficVolume += client->chargedTrafficVolume;
+					}
+					double avgBandwidthCostPerClient = (dc->priceBandwidth * totalChargedTrafficVolume) / dc->unassignedCoverableClients.size();
 
-				tempFinalGDatacenter = GDatacenter->id;
+					dc->averageCostPerClient = avgServerCostPerClient + avgBandwidthCostPerClient;
+				}
+			}
 
-				finalServerCountPerDC = tempServerCountPerDC; // newly added
+			//assign at most (serverCapacity) unassignedCoverable clients to the dc with the lowest averageCostPerClient
+			//DatacenterType* nextDC = *min_element(candidateDatacenters.begin(), candidateDatacenters.end(), DCComparatorByAverageCostPerClient);
+			auto nextDC = candidateDatacenters.front();
+			for (auto cdc : candidateDatacenters)
+			{
+				if (cdc->averageCostPerClient < nextDC->averageCostPerClient)
+				{
+					nextDC = cdc;
+				}
+			}
+			int unassignedCoverableClientCountNextDC = (int)nextDC->unassignedCoverableClients.size();
+			int numberOfClientsToBeAssigned = (unassignedCoverableClientCountNextDC <= serverCapacity.Real()) ? unassignedCoverableClientCountNextDC : serverCapacity.Integer();
+			for (int i = 0; i < numberOfClientsToBeAssigned; i++)
+			{
+				nextDC->unassignedCoverableClients.at(i)->assignedDatacenterID = nextDC->id;
+				//nextDC->assignedClientList.push_back(nextDC->unassignedCoverableClients.at(i)->id);
+				nextDC->assignedClients.push_back(nextDC->unassignedCoverableClients.at(i));
 			}
 		}
 
-		finalGDatacenter = tempFinalGDatacenter;
+		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
+	}
 
-		for (auto dc : allDatacenters) // newly added
-		{
-			dc->openServerCount = finalServerCountPerDC[dc->id];
-		}
+	template <int CAPACITY>
+	tuple<double, double, double, double, double> Policy_OPT::Run(
+		const vector<ClientType*> &sessionClients,
+		const vector<DatacenterType*> &allDatacenters,
+		CapacityType<CAPACITY> serverCapacity,
+		int GDatacenterID)
+	{
+		return Alg_OPT(sessionClients, allDatacenters, serverCapacity.Real(), GDatacenterID);
+	}
 
-		return finalOutcome;
+	// Lower-Bound (LB)
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_LB(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters, double serverCapacity, int GDatacenterID)
+	{
+		return RunPolicy4BasicProblem<Policy_LB>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+	}
+
+	// Random-Assignment
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_RANDOM(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters, double serverCapacity, int GDatacenterID)
+	{
+		return RunPolicy4BasicProblem<Policy_RANDOM>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+	}
+
+	// Nearest-Assignment
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_NEAREST(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters, double serverCapacity, int GDatacenterID)
+	{
+		return RunPolicy4BasicProblem<Policy_NEAREST>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+	}
+
+	// Lowest-Server-Price-Datacenter-Assignment (LSP)
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_LSP(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters, double serverCapacity, int GDatacenterID)
+	{
+		return RunPolicy4BasicProblem<Policy_LSP>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
 	}
 
 	// Lowest-Bandwidth-Price-Datacenter-Assignment (LBP)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LBP(
-		vector<DatacenterType*> eligibleGDatacenters,
-		int &finalGDatacenter,
-		const vector<ClientType*> &sessionClients,
-		const vector<DatacenterType*> &allDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R,
-		double serverCapacity,
-		bool includingGServerCost)
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_LBP(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters, double serverCapacity, int GDatacenterID)
 	{
-		tuple<double, double, double, double, double> finalOutcome;
+		return RunPolicy4BasicProblem<Policy_LBP>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+	}
 
-		double totalCost = INT_MAX;
-		int tempFinalGDatacenter = eligibleGDatacenters.front()->id;
+	// Lowest-Combined-Price-Datacenter-Assignment (LCP)
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_LCP(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters, double serverCapacity, int GDatacenterID)
+	{
+		return RunPolicy4BasicProblem<Policy_LCP>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+	}
 
-		for (auto GDatacenter : eligibleGDatacenters)
+	// Lowest-Capacity-Wastage-Assignment (LCW)
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_LCW(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters, double serverCapacity, int GDatacenterID)
+	{
+		return RunPolicy4BasicProblem<Policy_LCW>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+	}
+
+	// Lowest-Average-Cost-Assignment (LAC)
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_LAC(const vector<ClientType*> &sessionClients, const vector<DatacenterType*> &allDatacenters, double serverCapacity, int GDatacenterID)
+	{
+		return RunPolicy4BasicProblem<Policy_LAC>(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+	}
+
+	void FlowNetworkType::Reset(int nodeCount)
+	{
+		if ((int)adjacency.size() < nodeCount) adjacency.resize(nodeCount);
+		for (auto &edges : adjacency) edges.clear(); // keeping their memory
+		adjacency.resize(nodeCount);
+	}
+
+	int FlowNetworkType::AddEdge(int from, int to, int capacity, double cost)
+	{
+		adjacency[from].push_back(EdgeType{ to, (int)adjacency[to].size(), capacity, capacity, cost });
+		adjacency[to].push_back(EdgeType{ from, (int)adjacency[from].size() - 1, 0, 0, -cost });
+		return (int)adjacency[from].size() - 1;
+	}
+
+	void FlowNetworkType::ClearFlow()
+	{
+		for (auto &edges : adjacency)
 		{
-			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
-			auto tempOutcome = Alg_LBP(sessionClients, allDatacenters, serverCapacity, GDatacenter->id);
-			double tempTotalCost = get<0>(tempOutcome);
-			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
-			if (tempTotalCost < totalCost) // choose the smaller cost
-			{
-				totalCost = tempTotalCost;
-				finalOutcome = tempOutcome;
-				tempFinalGDatacenter = GDatacenter->id;
-			}
+			for (auto &edge : edges) edge.capacity = edge.capacityLimit;
 		}
-
-		finalGDatacenter = tempFinalGDatacenter;
-		return finalOutcome;
 	}
 
-	// Lowest-Combined-Price-Datacenter-Assignment (LCP)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LCP(
-		vector<DatacenterType*> eligibleGDatacenters,
-		int &finalGDatacenter,
-		const vector<ClientType*> &sessionClients,
-		const vector<DatacenterType*> &allDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R,
-		double serverCapacity,
-		bool includingGServerCost)
+	// send up to maxFlow units from source to sink at the minimum cost
+	// return the amount of flow actually sent
+	int FlowNetworkType::MinCostFlow(int source, int sink, int maxFlow, double &totalCost)
 	{
-		tuple<double, double, double, double, double> finalOutcome;
-		double totalCost = INT_MAX;
-		int tempFinalGDatacenter = eligibleGDatacenters.front()->id;
+		const int nodeCount = (int)adjacency.size();
+		int totalFlow = 0;
+		totalCost = 0;
+
+		distance.resize(nodeCount);
+		previousNode.resize(nodeCount);
+		previousEdge.resize(nodeCount);
+		isQueued.resize(nodeCount);
+		nodeQueue.resize(nodeCount + 1); // circular, a node is queued at most once at a time
+		while (totalFlow < maxFlow)
+		{
+			// shortest augmenting path in the residual network (queue-based Bellman-Ford, as residual costs can be negative)
+			std::fill(distance.begin(), distance.end(), std::numeric_limits<double>::max());
+			std::fill(isQueued.begin(), isQueued.end(), false);
+			int queueHead = 0, queueTail = 0;
+			distance[source] = 0;
+			nodeQueue[queueTail++] = source;
+			while (queueHead != queueTail)
+			{
+				int u = nodeQueue[queueHead];
+				queueHead = (queueHead + 1) % (nodeCount + 1);
+				isQueued[u] = false;
+				for (int i = 0; i < (int)adjacency[u].size(); i++)
+				{
+					auto &edge = adjacency[u][i];
+					if (edge.capacity > 0 && distance[u] + edge.cost < distance[edge.to] - 1e-12)
+					{
+						distance[edge.to] = distance[u] + edge.cost;
+						previousNode[edge.to] = u;
+						previousEdge[edge.to] = i;
+						if (!isQueued[edge.to])
+						{
+							isQueued[edge.to] = true;
+							nodeQueue[queueTail] = edge.to;
+							queueTail = (queueTail + 1) % (nodeCount + 1);
+						}
+					}
+				}
+			}
+			if (distance[sink] == std::numeric_limits<double>::max()) break; // no more augmenting path
 
-		for (auto GDatacenter : eligibleGDatacenters)
-		{
-			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
-			auto tempOutcome = Alg_LCP(sessionClients, allDatacenters, serverCapacity, GDatacenter->id);
-			double tempTotalCost = get<0>(tempOutcome);
-			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
-			if (tempTotalCost < totalCost) // choose the smaller cost
+			int pushedFlow = maxFlow - totalFlow;
+			for (int v = sink; v != source; v = previousNode[v])
 			{
-				totalCost = tempTotalCost;
-				finalOutcome = tempOutcome;
-				tempFinalGDatacenter = GDatacenter->id;
+				pushedFlow = std::min(pushedFlow, adjacency[previousNode[v]][previousEdge[v]].capacity);
 			}
+			for (int v = sink; v != source; v = previousNode[v])
+			{
+				auto &edge = adjacency[previousNode[v]][previousEdge[v]];
+				edge.capacity -= pushedFlow;
+				adjacency[v][edge.reverseEdge].capacity += pushedFlow;
+			}
+			totalFlow += pushedFlow;
+			totalCost += pushedFlow * distance[sink];
 		}
 
-		finalGDatacenter = tempFinalGDatacenter;
-		return finalOutcome;
+		return totalFlow;
 	}
 
-	// Lowest-Capacity-Wastage-Assignment (LCW)
-	// if server capacity < 2, reduce to LCP
+	// Optimal (OPT)
+	// exact solution of the integer problem by branch-and-bound on the server count of each dc
+	// the bound at each node is a Lagrangian relaxation: the LP relaxation (fractional servers above the branched lower bounds), solved as a min-cost flow from client types to dcs,
+	// with the cut "the servers of a component hold all its clients" (at least ceil(clientCount / serverCapacity) servers) priced in at the component's cheapest server price
+	// if TIME_BUDGET (wall-clock milliseconds) is positive and used up, the best solution found so far is returned
 	// for basic problem
-	tuple<double, double, double, double, double> Alg_LCW(
+	tuple<double, double, double, double, double> Alg_OPT(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
 		double serverCapacity,
-		int GDatacenterID)
+		int GDatacenterID,
+		double TIME_BUDGET,
+		bool *isProvenOptimal)
 	{
-		if (serverCapacity < 2)	return Alg_LCP(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+		auto startTime = std::chrono::steady_clock::now();
+		if (isProvenOptimal) *isProvenOptimal = true;
 
 		ResetAssignment(sessionClients, allDatacenters);
 
-		while (true)
+		// clients with the same eligible dcs and traffic volume are interchangeable, so they are grouped into one client type
+		vector<vector<ClientType*>> clientTypes;
+		map<pair<vector<unsigned long long>, double>, size_t> clientTypeIndex;
+		for (auto client : sessionClients)
 		{
-			vector<DatacenterType*> candidateDatacenters;
-			candidateDatacenters.clear();
-			for (auto dc : allDatacenters)
+			auto key = make_pair(client->eligibleDatacenterMask, client->chargedTrafficVolume);
+			auto it = clientTypeIndex.find(key);
+			if (it == clientTypeIndex.end())
 			{
-				dc->unassignedCoverableClients.clear(); // reset for new iteration
+				clientTypeIndex[key] = clientTypes.size();
+				clientTypes.push_back(vector<ClientType*>(1, client));
+			}
+			else
+			{
+				clientTypes.at(it->second).push_back(client);
+			}
+		}
 
-				for (auto client : dc->coverableClients)
+		const int typeCount = (int)clientTypes.size();
+		const int datacenterCount = (int)allDatacenters.size();
+
+		// dcs that share no client type are independent, so each connected component is solved on its own (the search trees would multiply otherwise)
+		vector<int> componentOfDC(datacenterCount);
+		for (int d = 0; d < datacenterCount; d++) componentOfDC[d] = d;
+		for (auto &clientType : clientTypes)
+		{
+			int first = componentOfDC[clientType.front()->eligibleDatacenters.front()->id];
+			for (auto edc : clientType.front()->eligibleDatacenters)
+			{
+				int other = componentOfDC[edc->id];
+				if (other != first)
 				{
-					if (client->assignedDatacenterID < 0)
-					{
-						dc->unassignedCoverableClients.push_back(client);
-					}
+					for (auto &component : componentOfDC) if (component == other) component = first;
 				}
+			}
+		}
 
-				if (!dc->unassignedCoverableClients.empty())
+		// one network and one node arena for all the components and search nodes
+		FlowNetworkType network;
+		vector<int> componentTypes, componentDCs, localDCIndex(datacenterCount, -1); // a component's types and dcs, and each dc's index among its component's dcs
+		vector<int> lowerEdge, upperEdge; // per dc of the component: its edges to the sink in the network
+		vector<int> openNodes; // depth-first stack of the search nodes, each as the lower and then the upper bound on the server count of each dc of the component
+		vector<int> node, clientCountPerDC, relaxedClientCountPerTypeDC, bestClientCountPerTypeDC; // per type and dc of the component: relaxedClientCountPerTypeDC[t * componentDCCount + d]
+		vector<vector<int>> clientCountPerTypeDC(typeCount, vector<int>(datacenterCount, 0)); // final solution
+		for (int component = 0; component < datacenterCount; component++)
+		{
+			componentTypes.clear();
+			int componentClientCount = 0;
+			for (int t = 0; t < typeCount; t++)
+			{
+				if (componentOfDC[clientTypes.at(t).front()->eligibleDatacenters.front()->id] == component)
 				{
-					candidateDatacenters.push_back(dc);
+					componentTypes.push_back(t);
+					componentClientCount += (int)clientTypes.at(t).size();
 				}
 			}
-			if (candidateDatacenters.empty()) // indicating that no more datacenters that have unassigned coverable clients
+			if (componentTypes.empty()) continue;
+
+			componentDCs.clear();
+			double cheapestPriceServer = std::numeric_limits<double>::max();
+			for (auto dc : allDatacenters)
 			{
-				break; // terminate
+				if (componentOfDC[dc->id] != component) continue;
+				localDCIndex[dc->id] = (int)componentDCs.size();
+				componentDCs.push_back(dc->id);
+				cheapestPriceServer = std::min(cheapestPriceServer, dc->priceServer);
 			}
+			const int componentTypeCount = (int)componentTypes.size(), componentDCCount = (int)componentDCs.size();
+			const int minServerCount = (int)ceil(componentClientCount / serverCapacity - 1e-9); // the cut's right-hand side
 
-			DatacenterType* nextDC = candidateDatacenters.front(); // initialization
-			for (auto dc : candidateDatacenters)
+			// type t is node 1 + t, and dc d is node 1 + componentTypeCount + d (indexed within the component)
+			const int sourceNode = 0, sinkNode = componentTypeCount + componentDCCount + 1;
+			network.Reset(sinkNode + 1);
+			for (int t = 0; t < componentTypeCount; t++)
 			{
-				double utilization_dc; // compute utilization for the current dc
-				int unassignedClientCount_dc = (int)dc->unassignedCoverableClients.size();
-				if (unassignedClientCount_dc % (int)serverCapacity == 0)
-					utilization_dc = 1;
-				else
-					utilization_dc = (double)(unassignedClientCount_dc % (int)serverCapacity) / serverCapacity;
-
-				double utilization_nextDC; // compute utilization for the previously selected dc (the one with highest utilization so far)
-				int unassignedClientCount_nextDC = (int)nextDC->unassignedCoverableClients.size();
-				if (unassignedClientCount_nextDC % (int)serverCapacity == 0)
-					utilization_nextDC = 1;
-				else
-					utilization_nextDC = (double)(unassignedClientCount_nextDC % (int)serverCapacity) / serverCapacity;
-
-				// choose the one with higher projected utilization	
-				// if two utilizations tie, select the one with lower server price
-				if (utilization_dc > utilization_nextDC || (utilization_dc == utilization_nextDC && dc->priceServer < nextDC->priceServer))
+				auto &clientType = clientTypes.at(componentTypes[t]);
+				network.AddEdge(sourceNode, 1 + t, (int)clientType.size(), 0);
+				for (auto edc : clientType.front()->eligibleDatacenters)
 				{
-					nextDC = dc;
+					network.AddEdge(1 + t, 1 + componentTypeCount + localDCIndex[edc->id], (int)clientType.size(), edc->priceBandwidth * clientType.front()->chargedTrafficVolume);
 				}
 			}
-
-			for (auto client : nextDC->unassignedCoverableClients) // client-to-datacenter assignment
+			// servers below the lower bound are paid anyway, while the ones above are paid per client (as in Alg_LB)
+			lowerEdge.resize(componentDCCount);
+			upperEdge.resize(componentDCCount);
+			for (int d = 0; d < componentDCCount; d++)
 			{
-				client->assignedDatacenterID = nextDC->id;
-				//nextDC->assignedClientList.push_back(client->id);
-				nextDC->assignedClients.push_back(client);
+				lowerEdge[d] = network.AddEdge(1 + componentTypeCount + d, sinkNode, 0, 0);
+				upperEdge[d] = network.AddEdge(1 + componentTypeCount + d, sinkNode, 0, 0);
 			}
-		}
 
-		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
-	}
+			// clients held by the servers below the lower bound of the dc's server count in the current node (rounded up, so that the relaxation stays below the integer cost), and by all of its servers
+			auto GetUpperCapacity = [&](int d) { return (int)floor(node[componentDCCount + d] * serverCapacity + 1e-9); };
+			auto GetLowerCapacity = [&](int d) { return std::min((int)ceil(node[d] * serverCapacity - 1e-9), GetUpperCapacity(d)); };
 
-	// Lowest-Capacity-Wastage-Assignment (LCW)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LCW(
-		vector<DatacenterType*> eligibleGDatacenters,
-		int &finalGDatacenter,
-		const vector<ClientType*> &sessionClients,
-		const vector<DatacenterType*> &allDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R,
-		double serverCapacity,
-		bool includingGServerCost)
-	{
-		tuple<double, double, double, double, double> finalOutcome;
-		double totalCost = INT_MAX;
-		int tempFinalGDatacenter = eligibleGDatacenters.front()->id;
+			// the relaxation given the lower and upper bound of each dc's server count in the current node, with the cut priced in at cutPrice (0: the LP relaxation)
+			// result: the bound, the number of clients assigned to each dc and the number of clients of each type assigned to each dc
+			// return false if infeasible
+			auto SolveRelaxation = [&](double cutPrice, double &bound)
+			{
+				bound = cutPrice * minServerCount;
+				for (int d = 0; d < componentDCCount; d++)
+				{
+					double priceServer = allDatacenters.at(componentDCs[d])->priceServer - cutPrice;
+					int lowerCapacity = GetLowerCapacity(d);
+					int upperCapacity = GetUpperCapacity(d);
+					network.SetCapacityLimit(1 + componentTypeCount + d, lowerEdge[d], lowerCapacity);
+					network.SetCapacityLimit(1 + componentTypeCount + d, upperEdge[d], upperCapacity - lowerCapacity);
+					network.SetCost(1 + componentTypeCount + d, upperEdge[d], priceServer / serverCapacity);
+					bound += priceServer * node[d];
+				}
+				network.ClearFlow();
 
-		map<int, double> finalServerCountPerDC; // newly added
+				double flowCost;
+				if (network.MinCostFlow(sourceNode, sinkNode, componentClientCount, flowCost) < componentClientCount) return false;
+				bound += flowCost;
 
-		for (auto GDatacenter : eligibleGDatacenters)
-		{
-			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
-			auto tempOutcome = Alg_LCW(sessionClients, allDatacenters, serverCapacity, GDatacenter->id);
-			double tempTotalCost = get<0>(tempOutcome);
+				clientCountPerDC.assign(componentDCCount, 0);
+				relaxedClientCountPerTypeDC.assign(componentTypeCount * componentDCCount, 0);
+				for (int t = 0; t < componentTypeCount; t++)
+				{
+					for (int i = 0; i < (int)network.adjacency[1 + t].size(); i++)
+					{
+						int d = network.adjacency[1 + t][i].to - 1 - componentTypeCount;
+						if (d >= 0) // edges from a type node to dc nodes (the one to the source node is a reverse edge)
+						{
+							relaxedClientCountPerTypeDC[t * componentDCCount + d] += network.GetFlow(1 + t, i);
+							clientCountPerDC[d] += network.GetFlow(1 + t, i);
+						}
+					}
+				}
+				return true;
+			};
 
-			map<int, double> tempServerCountPerDC; // newly added
-			for (auto dc : allDatacenters) // newly added
+			// depth-first branch-and-bound, each node is a pair of lower and upper bounds on the server count of each dc
+			openNodes.assign(2 * componentDCCount, 0);
+			for (auto t : componentTypes)
+			{
+				for (auto edc : clientTypes.at(t).front()->eligibleDatacenters)
+				{
+					openNodes.at(componentDCCount + localDCIndex[edc->id]) += (int)clientTypes.at(t).size();
+				}
+			}
+			for (int d = 0; d < componentDCCount; d++)
 			{
-				tempServerCountPerDC[dc->id] = dc->openServerCount;
+				openNodes.at(componentDCCount + d) = (int)ceil(openNodes.at(componentDCCount + d) / serverCapacity - 1e-9);
 			}
+			node.resize(2 * componentDCCount);
 
-			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
+			const int MAX_NODE_COUNT = 1000000; // safeguard only, the search is exact unless this is reached
+			int nodeCount = 0;
+			double bestCost = INT_MAX;
+			bestClientCountPerTypeDC.clear();
+			while (!openNodes.empty() && nodeCount < MAX_NODE_COUNT)
+			{
+				// the root node is always solved, so that each component has a solution
+				if (TIME_BUDGET > 0 && nodeCount > 0 && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= TIME_BUDGET) break;
+
+				std::copy(openNodes.end() - 2 * componentDCCount, openNodes.end(), node.begin());
+				openNodes.resize(openNodes.size() - 2 * componentDCCount);
+				nodeCount++;
+
+				// the relaxation with the cut first, and then the LP relaxation if the cut does not bind (the former opens more servers than the cut asks for, so it is no stronger and its solution is not branched on)
+				int branchDC = -1;
+				bool isSettled = false;
+				double cutBound = 0;
+				for (double cutPrice : { cheapestPriceServer, 0.0 })
+				{
+					double bound;
+					if (!SolveRelaxation(cutPrice, bound) || std::max(bound, cutBound) >= bestCost - 1e-9) // infeasible, or cannot improve
+					{
+						isSettled = true;
+						break;
+					}
+					bound = std::max(bound, cutBound);
 
-			if (tempTotalCost < totalCost) // choose the smaller cost
+					// the assignment of the relaxation is feasible for the integer problem as well
+					double integerCost = 0;
+					for (int t = 0; t < componentTypeCount; t++)
+					{
+						auto &clientType = clientTypes.at(componentTypes[t]);
+						for (int d = 0; d < componentDCCount; d++)
+						{
+							integerCost += relaxedClientCountPerTypeDC[t * componentDCCount + d] * allDatacenters.at(componentDCs[d])->priceBandwidth * clientType.front()->chargedTrafficVolume;
+						}
+					}
+					for (int d = 0; d < componentDCCount; d++)
+					{
+						integerCost += allDatacenters.at(componentDCs[d])->priceServer * ceil(clientCountPerDC[d] / serverCapacity - 1e-9);
+					}
+					if (integerCost < bestCost)
+					{
+						bestCost = integerCost;
+						bestClientCountPerTypeDC = relaxedClientCountPerTypeDC;
+					}
+					if (bound >= integerCost - 1e-9) // the relaxation is tight
+					{
+						isSettled = true;
+						break;
+					}
+
+					// branch on the dc whose server count costs the most above the relaxed one
+					double relaxedServerCount = 0, largestGap = 1e-9;
+					for (int d = 0; d < componentDCCount; d++)
+					{
+						double dcServerCount = node[d] + std::max(0, clientCountPerDC[d] - GetLowerCapacity(d)) / serverCapacity;
+						relaxedServerCount += dcServerCount;
+						double gap = allDatacenters.at(componentDCs[d])->priceServer * (ceil(clientCountPerDC[d] / serverCapacity - 1e-9) - dcServerCount);
+						if (gap > largestGap)
+						{
+							largestGap = gap;
+							branchDC = d;
+						}
+					}
+					if (cutPrice > 0 && (relaxedServerCount > minServerCount + 1e-9 || branchDC < 0))
+					{
+						cutBound = bound;
+						branchDC = -1;
+						continue;
+					}
+					break;
+				}
+				if (isSettled || branchDC < 0) continue; // the LP relaxation is already integral
+
+				int roundedUpServerCount = (int)ceil(clientCountPerDC[branchDC] / serverCapacity - 1e-9);
+				openNodes.insert(openNodes.end(), node.begin(), node.end()); // at least the rounded-up server count
+				openNodes.at(openNodes.size() - 2 * componentDCCount + branchDC) = roundedUpServerCount;
+				openNodes.insert(openNodes.end(), node.begin(), node.end()); // or fewer, explored first
+				openNodes.at(openNodes.size() - componentDCCount + branchDC) = roundedUpServerCount - 1;
+			}
+			if (!openNodes.empty() && isProvenOptimal) *isProvenOptimal = false; // cut short by the budget or the node limit
+
+			if (bestClientCountPerTypeDC.empty()) // should not happen since LCP is feasible
 			{
-				totalCost = tempTotalCost;
-				finalOutcome = tempOutcome;
-				tempFinalGDatacenter = GDatacenter->id;
-				finalServerCountPerDC = tempServerCountPerDC; // newly added
+				if (isProvenOptimal) *isProvenOptimal = false;
+				return Alg_LCP(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+			}
+			for (int t = 0; t < componentTypeCount; t++)
+			{
+				for (int d = 0; d < componentDCCount; d++)
+				{
+					clientCountPerTypeDC[componentTypes[t]][componentDCs[d]] = bestClientCountPerTypeDC[t * componentDCCount + d];
+				}
 			}
 		}
 
-		finalGDatacenter = tempFinalGDatacenter;
-
-		for (auto dc : allDatacenters) // newly added
+		// client-to-datacenter assignment
+		for (int t = 0; t < typeCount; t++)
 		{
-			dc->openServerCount = finalServerCountPerDC[dc->id];
+			size_t next = 0;
+			for (int d = 0; d < datacenterCount; d++)
+			{
+				for (int i = 0; i < clientCountPerTypeDC[t][d]; i++)
+				{
+					auto client = clientTypes.at(t).at(next++);
+					client->assignedDatacenterID = d;
+					allDatacenters.at(d)->assignedClients.push_back(client);
+				}
+			}
 		}
 
-		return finalOutcome;
+		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
 	}
 
-	// Lowest-Average-Cost-Assignment (LAC)
-	// Idea: open exactly one server at each iteration, and where to open the server is determined based on the average cost contributed by all clients that are to be assigned to this server
-	// if server capacity < 2, reduce to LCP
+	// Local-Search post-optimizer (LS)
+	// improve the current assignment by client moves, client swaps and server closings, accepting only the ones that reduce the total cost
+	// per-dc client counts are maintained incrementally, so the cost change of each move is evaluated in constant time
+	// stop at a local optimum or when the budget is used up
 	// for basic problem
-	tuple<double, double, double, double, double> Alg_LAC(
+	tuple<double, double, double, double, double> ImproveByLocalSearch(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
 		double serverCapacity,
-		int GDatacenterID)
+		int GDatacenterID,
+		const LocalSearchSettingType &localSearchSetting)
 	{
-		if (serverCapacity < 2)	return Alg_LCP(sessionClients, allDatacenters, serverCapacity, GDatacenterID);
+		Instrumentation::PhaseTimerType timer(Instrumentation::PHASE_LOCAL_SEARCH);
 
-		ResetAssignment(sessionClients, allDatacenters);
+		vector<int> clientCountPerDC(allDatacenters.size(), 0);
+		for (auto client : sessionClients)
+		{
+			clientCountPerDC.at(client->assignedDatacenterID)++;
+		}
 
-		while (true)
+		auto ServerCount = [serverCapacity](int clientCount) { return ceil(clientCount / serverCapacity); };
+
+		// cost change of moving the client to the dc (the bandwidth cost is linear in the traffic volume, so only the client counts are needed)
+		auto MoveDelta = [&](const ClientType *client, int to)
 		{
-			// update for the new iteration
-			vector<DatacenterType*> candidateDatacenters;
-			candidateDatacenters.clear();
-			for (auto dc : allDatacenters)
-			{
-				dc->unassignedCoverableClients.clear();
+			int from = client->assignedDatacenterID;
+			return allDatacenters[from]->priceServer * (ServerCount(clientCountPerDC[from] - 1) - ServerCount(clientCountPerDC[from]))
+				+ allDatacenters[to]->priceServer * (ServerCount(clientCountPerDC[to] + 1) - ServerCount(clientCountPerDC[to]))
+				+ (allDatacenters[to]->priceBandwidth - allDatacenters[from]->priceBandwidth) * client->chargedTrafficVolume;
+		};
 
-				for (auto client : dc->coverableClients)
+		auto Move = [&](ClientType *client, int to)
+		{
+			int from = client->assignedDatacenterID;
+			clientCountPerDC[from]--;
+			clientCountPerDC[to]++;
+			client->assignedDatacenterID = to;
+		};
+
+		// the time budget is checked once every 256 evaluated moves, so that reading the clock does not dominate the constant-time evaluations
+		auto startTime = std::chrono::steady_clock::now();
+		long long iterationCount = 0;
+		bool isBudgetUsedUp = false;
+		auto IsBudgetUsedUp = [&]()
+		{
+			if (localSearchSetting.iterationBudget > 0 && iterationCount >= localSearchSetting.iterationBudget) isBudgetUsedUp = true;
+			if (localSearchSetting.timeBudget > 0 && 0 == iterationCount % 256 && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() >= localSearchSetting.timeBudget) isBudgetUsedUp = true;
+			return isBudgetUsedUp;
+		};
+
+		const double EPSILON = 1e-9; // only strictly improving moves are accepted
+		bool isImproved = true;
+		while (isImproved && !IsBudgetUsedUp())
+		{
+			isImproved = false;
+
+			// client move: reassign one client to another eligible dc
+			for (auto client : sessionClients)
+			{
+				for (auto edc : client->eligibleDatacenters)
 				{
-					if (client->assignedDatacenterID < 0) { dc->unassignedCoverableClients.push_back(client); }
-				}
+					if (IsBudgetUsedUp()) break;
+					if (edc->id == client->assignedDatacenterID) continue;
 
-				if (!dc->unassignedCoverableClients.empty()) { candidateDatacenters.push_back(dc); }
+					iterationCount++;
+					if (MoveDelta(client, edc->id) < -EPSILON)
+					{
+						Move(client, edc->id);
+						isImproved = true;
+					}
+				}
 			}
 
-			// all clients are assigned, so terminate the iteration
-			if (candidateDatacenters.empty())
+			// client swap: exchange the dcs of two clients (only the bandwidth cost changes, so it matters only if their traffic volumes differ)
+			for (size_t i = 0; i < sessionClients.size(); i++)
 			{
-				break;
-			}
-
-			// compute the average cost per client if opening a server in each dc		
-			for (auto dc : candidateDatacenters)
-			{				
-				if (dc->unassignedCoverableClients.empty())
+				for (size_t j = i + 1; j < sessionClients.size(); j++)
 				{
-					dc->averageCostPerClient = INT_MAX;
-				}
-				else if (dc->unassignedCoverableClients.size() <= serverCapacity)
-				{					
-					double avgServerCostPerClient = dc->priceServer / dc->unassignedCoverableClients.size();
-					double totalChargedTrafficVolume = 0;
-					for (auto client : dc->unassignedCoverableClients)
+					if (IsBudgetUsedUp()) break;
+
+					auto first = sessionClients[i], second = sessionClients[j];
+					int firstDC = first->assignedDatacenterID, secondDC = second->assignedDatacenterID;
+					if (firstDC == secondDC || first->chargedTrafficVolume == second->chargedTrafficVolume) continue;
+					if (!first->IsEligible(secondDC) || !second->IsEligible(firstDC)) continue;
+
+					iterationCount++;
+					if ((allDatacenters[secondDC]->priceBandwidth - allDatacenters[firstDC]->priceBandwidth) * (first->chargedTrafficVolume - second->chargedTrafficVolume) < -EPSILON)
 					{
-						totalChargedTrafficVolume += client->chargedTrafficVolume;
+						Move(first, secondDC);
+						Move(second, firstDC);
+						isImproved = true;
 					}
-					double avgBandwidthCostPerClient = (dc->priceBandwidth * totalChargedTrafficVolume) / dc->unassignedCoverableClients.size();
-					
-					dc->averageCostPerClient = avgServerCostPerClient + avgBandwidthCostPerClient;
 				}
-				else
+			}
+
+			// server closing: move all the clients on the last server of a dc elsewhere (one by one to their best dcs), and keep it only if the total cost is reduced
+			for (auto dc : allDatacenters)
+			{
+				if (IsBudgetUsedUp()) break;
+				if (0 == clientCountPerDC[dc->id]) continue;
+
+				int clientCountOnLastServer = clientCountPerDC[dc->id] - (int)floor((ServerCount(clientCountPerDC[dc->id]) - 1) * serverCapacity + EPSILON);
+				vector<pair<ClientType*, int>> tentativeMoves; // (client, the dc it was moved from)
+				double totalDelta = 0;
+				for (int k = 0; k < clientCountOnLastServer; k++)
 				{
-					double avgServerCostPerClient = dc->priceServer / serverCapacity;
-					double totalChargedTrafficVolume = 0;
-					for (auto client : dc->unassignedCoverableClients)
+					ClientType *bestClient = nullptr;
+					int bestDC = -1;
+					double bestDelta = INT_MAX;
+					for (auto client : sessionClients)
 					{
-						totalChargedTrafficVolume += client->chargedTrafficVolume;
+						if (client->assignedDatacenterID != dc->id) continue;
+						for (auto edc : client->eligibleDatacenters)
+						{
+							if (edc->id == dc->id) continue;
+
+							iterationCount++;
+							double delta = MoveDelta(client, edc->id);
+							if (delta < bestDelta)
+							{
+								bestDelta = delta;
+								bestClient = client;
+								bestDC = edc->id;
+							}
+						}
 					}
-					double avgBandwidthCostPerClient = (dc->priceBandwidth * totalChargedTrafficVolume) / dc->unassignedCoverableClients.size();
+					if (nullptr == bestClient) break; // some client cannot leave this dc
 
-					dc->averageCostPerClient = avgServerCostPerClient + avgBandwidthCostPerClient;
+					totalDelta += bestDelta;
+					tentativeMoves.push_back(pair<ClientType*, int>(bestClient, dc->id));
+					Move(bestClient, bestDC);
 				}
-			}
 
-			//assign at most (serverCapacity) unassignedCoverable clients to the dc with the lowest averageCostPerClient
-			//DatacenterType* nextDC = *min_element(candidateDatacenters.begin(), candidateDatacenters.end(), DCComparatorByAverageCostPerClient);
-			auto nextDC = candidateDatacenters.front();
-			for (auto cdc : candidateDatacenters)
-			{
-				if (cdc->averageCostPerClient < nextDC->averageCostPerClient)
+				if ((int)tentativeMoves.size() == clientCountOnLastServer && totalDelta < -EPSILON)
 				{
-					nextDC = cdc;
+					isImproved = true;
+				}
+				else // undo in the reverse order
+				{
+					for (auto it = tentativeMoves.rbegin(); it != tentativeMoves.rend(); it++)
+					{
+						Move(it->first, it->second);
+					}
 				}
 			}
-			int unassignedCoverableClientCountNextDC = (int)nextDC->unassignedCoverableClients.size();
-			int numberOfClientsToBeAssigned = (unassignedCoverableClientCountNextDC <= serverCapacity) ? unassignedCoverableClientCountNextDC : (int)serverCapacity;
-			for (int i = 0; i < numberOfClientsToBeAssigned; i++)
-			{
-				nextDC->unassignedCoverableClients.at(i)->assignedDatacenterID = nextDC->id;
-				//nextDC->assignedClientList.push_back(nextDC->unassignedCoverableClients.at(i)->id);
-				nextDC->assignedClients.push_back(nextDC->unassignedCoverableClients.at(i));
-			}
+		}
+
+		// rebuild the assigned clients of each dc from the final assignment
+		for (auto dc : allDatacenters)
+		{
+			dc->assignedClients.clear();
+		}
+		for (auto client : sessionClients)
+		{
+			allDatacenters.at(client->assignedDatacenterID)->assignedClients.push_back(client);
 		}
 
 		return GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
 	}
 
-	// Lowest-Average-Cost-Assignment (LAC)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LAC(
-		vector<DatacenterType*> eligibleGDatacenters,
-		int &finalGDatacenter,
+	// Portfolio allocator
+	// run the given strategies concurrently on private copies of the session (optionally followed by LS), and keep the best solution found within the wall-clock budget
+	// strategies already running when the budget is used up are not interrupted, except OPT and LS that stop at the deadline
+	// the best assignment is applied to the given clients and datacenters
+	// for basic problem
+	PortfolioOutcomeType AllocateByPortfolio(
 		const vector<ClientType*> &sessionClients,
 		const vector<DatacenterType*> &allDatacenters,
-		double DELAY_BOUND_TO_G,
-		double DELAY_BOUND_TO_R,
 		double serverCapacity,
-		bool includingGServerCost)
+		int GDatacenterID,
+		const PortfolioSettingType &portfolioSetting)
 	{
-		tuple<double, double, double, double, double> finalOutcome;
-		double totalCost = INT_MAX;
-		int tempFinalGDatacenter = eligibleGDatacenters.front()->id;
-
-		map<int, double> finalServerCountPerDC; // newly added
-
-		for (auto GDatacenter : eligibleGDatacenters)
+		auto startTime = std::chrono::steady_clock::now();
+		auto ElapsedTime = [startTime]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count(); };
+
+		PortfolioOutcomeType portfolioOutcome;
+		portfolioOutcome.winningStrategyID = -1;
+		portfolioOutcome.isImprovedByLocalSearch = false;
+		double bestCost = INT_MAX;
+		vector<int> bestAssignment; // the dc id of each client in the best solution
+		std::mutex bestMutex;
+
+		// keep the workspace's current assignment if it is the best so far
+		auto Submit = [&](const WorkspaceType &workspace, int strategyID, bool isImprovedByLocalSearch)
 		{
-			SimulationSetup4GeneralProblem(GDatacenter, sessionClients, allDatacenters, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R);
-			auto tempOutcome = Alg_LAC(sessionClients, allDatacenters, serverCapacity, GDatacenter->id);
-			double tempTotalCost = get<0>(tempOutcome);
+			double cost = get<0>(GetSolutionOutput(workspace.datacenters, serverCapacity, workspace.clients, GDatacenterID)); // LB's assignment is costed with whole servers as well
 
-			map<int, double> tempServerCountPerDC; // newly added
-			for (auto dc : allDatacenters) // newly added
+			std::lock_guard<std::mutex> lock(bestMutex);
+			if (cost < bestCost)
 			{
-				tempServerCountPerDC[dc->id] = dc->openServerCount;
+				bestCost = cost;
+				bestAssignment.clear();
+				for (auto client : workspace.clients) bestAssignment.push_back(client->assignedDatacenterID);
+				portfolioOutcome.winningStrategyID = strategyID;
+				portfolioOutcome.isImprovedByLocalSearch = isImprovedByLocalSearch;
+				portfolioOutcome.trace.push_back(PortfolioTraceEntryType{ ElapsedTime(), cost, strategyID, isImprovedByLocalSearch });
 			}
+		};
 
-			//IncludeGServerCost(GDatacenter, (int)sessionClients.size(), includingGServerCost, tempTotalCost);
-
-			if (tempTotalCost < totalCost) // choose the smaller cost
+		// each worker takes the next strategy to run until all are started or the budget is used up (the first one is always run so that there is a solution)
+		std::atomic<size_t> nextStrategy(0);
+		const SessionRandomnessType *callerRandomness = sessionRandomness;
+		auto Worker = [&]()
+		{
+			SessionRandomnessType workerRandomness(callerRandomness);
+			WorkspaceType workspace(sessionClients, allDatacenters);
+			while (true)
 			{
-				totalCost = tempTotalCost;
-				finalOutcome = tempOutcome;
-				tempFinalGDatacenter = GDatacenter->id;
-				finalServerCountPerDC = tempServerCountPerDC; // newly added
-			}
-		}
+				size_t next = nextStrategy++;
+				if (next >= portfolioSetting.strategyIDs.size() || (next > 0 && ElapsedTime() >= portfolioSetting.timeBudget)) break;
+
+				int strategyID = portfolioSetting.strategyIDs.at(next);
+				if (STRATEGY_OPT == strategyID)
+					Alg_OPT(workspace.clients, workspace.datacenters, serverCapacity, GDatacenterID, std::max(portfolioSetting.timeBudget - ElapsedTime(), 1e-6));
+				else
+					RunStrategy4BasicProblem(strategyID, workspace.clients, workspace.datacenters, serverCapacity, GDatacenterID);
+				Submit(workspace, strategyID, false);
 
-		finalGDatacenter = tempFinalGDatacenter;
+				double remainingTime = portfolioSetting.timeBudget - ElapsedTime();
+				if (portfolioSetting.localSearch && strategyID >= LOCAL_SEARCH_FIRST_STRATEGY && strategyID <= LOCAL_SEARCH_LAST_STRATEGY && remainingTime > 0)
+				{
+					ImproveByLocalSearch(workspace.clients, workspace.datacenters, serverCapacity, GDatacenterID, LocalSearchSettingType(true, 0, remainingTime));
+					Submit(workspace, strategyID, true);
+				}
+			}
+		};
 
-		for (auto dc : allDatacenters) // newly added
+		int threadCount = portfolioSetting.threadCount > 0 ? portfolioSetting.threadCount : (int)std::thread::hardware_concurrency();
+		threadCount = std::max(1, std::min(threadCount, (int)portfolioSetting.strategyIDs.size()));
+		vector<std::thread> workers;
+		for (int i = 1; i < threadCount; i++)
 		{
-			dc->openServerCount = finalServerCountPerDC[dc->id];
+			workers.push_back(std::thread(Worker));
+		}
+		Worker(); // the calling thread is one of the workers
+		for (auto &worker : workers)
+		{
+			worker.join();
 		}
 
-		return finalOutcome;
+		ApplyAssignment(sessionClients, allDatacenters, bestAssignment);
+		portfolioOutcome.outcome = GetSolutionOutput(allDatacenters, serverCapacity, sessionClients, GDatacenterID);
+
+		return portfolioOutcome;
 	}
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Base.h"
+#include "Random.h"
+#include "Instrumentation.h"
 
 namespace ServerAllocationProblem
 {
@@ -13,6 +15,8 @@ namespace ServerAllocationProblem
 		double chargedTrafficVolume;
 		map<int, double> delayToDatacenter; // delay values mapped with dc's id (fixed once initialized)		
 		vector<DatacenterType*> eligibleDatacenters;
+		vector<unsigned long long> eligibleDatacenterMask; // bit (id % 64) of word (id / 64) is set if the dc with this id is eligible
+		vector<int> eligibleDatacenterRank; // by dc id: rank of an eligible dc by delay and then by position in eligibleDatacenters (see RankEligibleDatacenters)
 		int assignedDatacenterID; // the id of the dc to which it is assigned	
 
 		ClientType(int givenID)
@@ -20,6 +24,11 @@ namespace ServerAllocationProblem
 			this->id = givenID;
 			this->assignedDatacenterID = -1;
 		}
+
+		bool IsEligible(int datacenterID) const
+		{
+			return (size_t)(datacenterID / 64) < eligibleDatacenterMask.size() && ((eligibleDatacenterMask[datacenterID / 64] >> (datacenterID % 64)) & 1ULL);
+		}
 	};
 
 	struct DatacenterType
@@ -42,13 +51,385 @@ namespace ServerAllocationProblem
 		}
 	};
 	
+	// price criteria used by the price-driven strategies
+	enum PriceCriterion { PRICE_SERVER, PRICE_BANDWIDTH, PRICE_COMBINED };
+
+	// datacenters sorted by one price criterion in ascending order
+	struct PriceOrderType
+	{
+		vector<DatacenterType*> datacenters;
+		vector<int> tieGroup; // datacenters with the same tieGroup have exactly the same price
+	};
+
+	// number of strategies (1: LB, 2: RANDOM, 3: NEAREST, 4: LSP, 5: LBP, 6: LCP, 7: LCW, 8: LAC, 9: OPT)
+	const int STRATEGY_COUNT = 9;
+	const int STRATEGY_OPT = 9; // the branch-and-bound search (optimal unless cut short, see Alg_OPT), slower than the heuristics
+
+	// strategies that can be followed by the local search post-optimizer (LS), i.e. the heuristics from RANDOM to LAC
+	// when LS is enabled, their improved results are placed after the columns of the base strategies (in the same order, see GetBaseColumnCount)
+	const int LOCAL_SEARCH_FIRST_STRATEGY = 2;
+	const int LOCAL_SEARCH_LAST_STRATEGY = 8;
+	const int LOCAL_SEARCH_STRATEGY_COUNT = LOCAL_SEARCH_LAST_STRATEGY - LOCAL_SEARCH_FIRST_STRATEGY + 1;
+
+	// settings of the local search post-optimizer (LS)
+	struct LocalSearchSettingType
+	{
+		bool enabled;
+		double iterationBudget; // max number of evaluated moves per run (0: no limit)
+		double timeBudget; // max milliseconds (wall-clock) per run (0: no limit)
+
+		LocalSearchSettingType(bool givenEnabled = false, double givenIterationBudget = 100000, double givenTimeBudget = 0)
+		{
+			this->enabled = givenEnabled;
+			this->iterationBudget = givenIterationBudget;
+			this->timeBudget = givenTimeBudget;
+		}
+	};
+
+	// settings of OPT in the simulations, where it is opt-in since its search grows exponentially with the session size
+	struct OptimalSettingType
+	{
+		bool enabled;
+		double timeBudget; // max milliseconds (wall-clock) per run at one G datacenter (0: no limit), after which the best solution found so far is kept
+
+		OptimalSettingType(bool givenEnabled = false, double givenTimeBudget = 1000)
+		{
+			this->enabled = givenEnabled;
+			this->timeBudget = givenTimeBudget;
+		}
+	};
+
+	// number of base strategy columns: all strategies, without OPT (the last one) unless it is enabled
+	inline int GetBaseColumnCount(const OptimalSettingType &optimalSetting)
+	{
+		return optimalSetting.enabled ? STRATEGY_COUNT : STRATEGY_COUNT - 1;
+	}
+
+	// number of columns: the base strategies followed by the LS columns if LS is enabled
+	inline int GetColumnCount(const LocalSearchSettingType &localSearchSetting, const OptimalSettingType &optimalSetting)
+	{
+		return GetBaseColumnCount(optimalSetting) + (localSearchSetting.enabled ? LOCAL_SEARCH_STRATEGY_COUNT : 0);
+	}
+
+	// the operation count column (see Instrumentation::OperationCountScopeType) of each column, which does not depend on the settings: the strategy id, or STRATEGY_COUNT + 1 etc. for the LS columns
+	vector<int> GetOperationCountColumns(const LocalSearchSettingType &, const OptimalSettingType &);
+
+	// the columns (strategy id minus 1) of the LCP, LCW and LAC, whose server counts per dc at capacity 8 are summed into the general problem's serverCountPerDC
+	vector<int> GetServerCountColumns();
+
+	// settings of the portfolio allocator
+	struct PortfolioSettingType
+	{
+		double timeBudget; // wall-clock milliseconds per session
+		vector<int> strategyIDs; // strategies to run, in the order they are started
+		bool localSearch; // improve each strategy's assignment by LS (if applicable) within the remaining time
+		int threadCount; // number of worker threads (0: one per hardware thread)
+
+		PortfolioSettingType(double givenTimeBudget = 2, vector<int> givenStrategyIDs = { 8, 7, 6, 9, 4, 5, 3, 2 }, bool givenLocalSearch = true, int givenThreadCount = 0)
+		{
+			this->timeBudget = givenTimeBudget;
+			this->strategyIDs = givenStrategyIDs;
+			this->localSearch = givenLocalSearch;
+			this->threadCount = givenThreadCount;
+		}
+	};
+
+	// settings of the adaptive (sequential) stopping of a simulation: instead of a fixed SESSION_COUNT, sessions run until the mean LB-normalized total cost of every (strategy, capacity) cell is known precisely enough
+	struct AdaptiveStoppingSettingType
+	{
+		bool enabled; // otherwise exactly SESSION_COUNT sessions run
+		double relativeHalfWidth; // target half-width of each cell's confidence interval, relative to its mean
+		double confidenceLevel; // of the confidence intervals
+		double minSessionCount; // sessions before the first check
+		double batchSize; // sessions between two checks
+		bool stratifiedByGDatacenter; // post-stratify the sessions by their chosen G datacenter (smaller intervals, as the cost depends heavily on the G region): the matchmaking's one (basic problem) or each cell's final one (general problem)
+
+		AdaptiveStoppingSettingType(bool givenEnabled = false, double givenRelativeHalfWidth = 0.005, double givenConfidenceLevel = 0.95, double givenMinSessionCount = 100, double givenBatchSize = 50, bool givenStratifiedByGDatacenter = true)
+		{
+			this->enabled = givenEnabled;
+			this->relativeHalfWidth = givenRelativeHalfWidth;
+			this->confidenceLevel = givenConfidenceLevel;
+			this->minSessionCount = givenMinSessionCount;
+			this->batchSize = givenBatchSize;
+			this->stratifiedByGDatacenter = givenStratifiedByGDatacenter;
+		}
+	};
+
+	// settings of a simulation (see SimulateBasicProblem and SimulateGeneralProblem), set by name on a default one
+	struct SimulationSettingType
+	{
+		double SESSION_COUNT; // number of sessions (the max number if adaptiveStopping is enabled)
+		bool capacityParametric; // evaluate all server capacities of a strategy in one parametric run
+		LocalSearchSettingType localSearchSetting;
+		int threadCount; // number of threads running sessions in parallel (see RunSessions)
+		int cellThreadCount; // number of threads evaluating the (strategy, capacity) cells of each session in parallel (0: serial, ignored if capacityParametric)
+		int componentThreadCount; // general problem only: number of threads solving the components of each instance in parallel (0: whole instances, see RunStrategyDecomposed4GeneralProblem; ignored if capacityParametric or cellThreadCount > 0)
+		bool resultCaching; // keep the per-session results in a ResultCacheType (opt-in; not used with a wall-clock LS or OPT budget, whose results depend on the timing), the computation and matchmaking times of the cached sessions are left out
+		AdaptiveStoppingSettingType adaptiveStopping; // see RunSessionsAdaptively
+		bool rawResults; // also write every session's outcomes to Output\<G>_<R>_<size>_rawResults.bin as the sessions finish (see RawResults.h)
+		OptimalSettingType optimalSetting; // OPT's column is only evaluated if it is enabled (see GetBaseColumnCount)
+
+		SimulationSettingType()
+		{
+			this->SESSION_COUNT = 1000;
+			this->capacityParametric = false;
+			this->threadCount = 0;
+			this->cellThreadCount = 0;
+			this->componentThreadCount = 0;
+			this->resultCaching = false;
+			this->rawResults = false;
+		}
+	};
+
+	// one new best-so-far solution found by the portfolio allocator
+	struct PortfolioTraceEntryType
+	{
+		double elapsedTime; // wall-clock milliseconds since the portfolio started
+		double costTotal;
+		int strategyID;
+		bool isImprovedByLocalSearch;
+	};
+
+	// result of the portfolio allocator
+	struct PortfolioOutcomeType
+	{
+		tuple<double, double, double, double, double> outcome; // of the best solution
+		int winningStrategyID; // the strategy that found the best solution (-1 if none finished in time)
+		bool isImprovedByLocalSearch; // whether the best solution is the winner's assignment improved by LS
+		vector<PortfolioTraceEntryType> trace; // how the best-so-far cost evolved over time
+	};
+
+	// private copy of clients and datacenters (e.g. of one session, or all of them for one worker thread), so that strategies and matchmaking can run concurrently without touching the shared ones
+	// datacenters are copied in the same order (so their ids are still their indices), and client-to-datacenter pointers are remapped to the copies
+	struct WorkspaceType
+	{
+		vector<ClientType*> clients;
+		vector<DatacenterType*> datacenters;
+
+		WorkspaceType(const vector<ClientType*> &, const vector<DatacenterType*> &);
+		~WorkspaceType();
+		WorkspaceType(const WorkspaceType &) = delete;
+		WorkspaceType &operator=(const WorkspaceType &) = delete;
+	};
+
+	// seed of the per-session randomness (combined with the session id and the purpose of each random stream)
+	const unsigned long long SESSION_RANDOM_SEED = 1;
+
+	// make the calling thread use the random streams of the given session while this object exists, so that a session's randomness does not depend on which thread runs it, on the other sessions or on the order of the calls
+	struct SessionRandomnessType
+	{
+		unsigned long long seed;
+		int sessionID;
+		const SessionRandomnessType *previous;
+
+		SessionRandomnessType(int, unsigned long long seed = SESSION_RANDOM_SEED);
+		explicit SessionRandomnessType(const SessionRandomnessType *); // the same session as the given one (e.g., of another thread), nullptr: session 0
+		~SessionRandomnessType();
+		SessionRandomnessType(const SessionRandomnessType &) = delete;
+		SessionRandomnessType &operator=(const SessionRandomnessType &) = delete;
+	};
+
+	// session randomness used in the calling thread (nullptr: session 0)
+	extern thread_local const SessionRandomnessType *sessionRandomness;
+
+	// random stream of the given purpose (and sub-stream) of the calling thread's session
+	CounterRandomType GetSessionRandom(RandomPurpose, unsigned long long subStream = 0);
+
+	// results of one session of the simulation
+	struct SessionResultType
+	{
+		vector<vector<tuple<double, double, double, double, double>>> outcome; // indexed by [capacity][strategy]
+		vector<vector<double>> computation; // wall-clock milliseconds, indexed by [capacity][strategy]
+		vector<vector<int>> finalGDatacenter; // indexed by [capacity][strategy] (for general problem)
+		vector<vector<vector<double>>> serverCountPerDC; // indexed by [capacity][strategy][dc's id] (for general problem)
+		vector<vector<vector<double>>> clientDelay; // delay of each client to its R datacenter and on to the (final) G datacenter, indexed by [capacity][strategy][client]
+		vector<vector<vector<double>>> serverUtilization; // utilization (clients over server slots) of each dc with open servers, indexed by [capacity][strategy][k]
+		vector<int> unprovenOptimal; // per capacity: 1 if OPT is enabled and its result is not proven optimal (see Alg_OPT), else 0
+		int GDatacenterID; // (for basic problem)
+		vector<int> eligibleRDatacenterCount; // per client (for basic problem)
+		int eligibleGDatacenterCount; // (for general problem)
+		double matchmakingTime; // wall-clock milliseconds
+		bool isCached; // read from a ResultCacheType, so computation and matchmakingTime were timed by an earlier run (not serialized)
+
+		SessionResultType()
+		{
+			this->GDatacenterID = -1;
+			this->eligibleGDatacenterCount = 0;
+			this->matchmakingTime = 0;
+			this->isCached = false;
+		}
+	};
+
+	// running statistics of the sessions' outcomes in each (capacity, column) cell, updated as each session finishes, so that the memory does not grow with the number of sessions
+	// the sessions are added in session order (see RunSessions), so the statistics do not depend on the number of threads; Merge combines those of separate runs (e.g. of other shards)
+	struct OutcomeStatisticsType
+	{
+		vector<vector<StatisticsAccumulatorType>> costTotal; // normalized by the LB (the first column), indexed by [capacity][column]
+		vector<vector<StatisticsAccumulatorType>> capacityWastage; // indexed by [capacity][column]
+		vector<vector<StatisticsAccumulatorType>> averageDelay; // indexed by [capacity][column]
+		vector<vector<StatisticsAccumulatorType>> computation; // wall-clock milliseconds, indexed by [capacity][column] (of the sessions computed by this run only)
+		vector<vector<QuantileSketchType>> clientDelay; // every client's delay (not only the session's average), indexed by [capacity][column]
+		vector<vector<QuantileSketchType>> serverUtilization; // every open dc's utilization, indexed by [capacity][column]
+		vector<double> unprovenOptimalCount; // sessions whose OPT result is not proven optimal, per capacity
+		double sessionCount;
+		double cachedSessionCount; // sessions read from a result cache, whose computation is not added
+
+		OutcomeStatisticsType()
+		{
+			this->sessionCount = 0;
+			this->cachedSessionCount = 0;
+		}
+
+		// one session's outcome and computation, indexed by [capacity][column] (the cells are sized by the first session)
+		// isCached: the session was read from a result cache (see SessionResultType), so only its outcome is added
+		void Add(const vector<vector<tuple<double, double, double, double, double>>> &, const vector<vector<double>> &, bool isCached = false);
+		// one session's clientDelay and serverUtilization (see SessionResultType)
+		void AddDistributions(const vector<vector<vector<double>>> &, const vector<vector<vector<double>>> &);
+		// one session's unprovenOptimal (see SessionResultType)
+		void AddUnprovenOptimal(const vector<int> &);
+		void Merge(const OutcomeStatisticsType &);
+	};
+
+	// one session's results as one line of text (doubles with 17 digits, so that they are read back exactly, and an end marker, so that a line cut short is not read), and back
+	string SerializeSessionResult(int, const SessionResultType &);
+	bool DeserializeSessionResult(const string &, int &, SessionResultType &);
+
+	// bump whenever a change of the code alters the results of a session, so that results cached by older code are not used (in addition to GetBuildID, e.g. for the same change built on several machines)
+	const int RESULT_CACHE_VERSION = 6;
+
+	// identifier of the running build: a hash of its executable file (or, if the file cannot be read, the compilation time of this file), computed once
+	// so that results cached by another build are not used even if RESULT_CACHE_VERSION was not bumped
+	string GetBuildID();
+
+	// key of the cached results of a simulation: a hash of the dataset files, the parameters (everything that determines a session's results, but not SESSION_COUNT), RESULT_CACHE_VERSION, GetBuildID and SESSION_RANDOM_SEED
+	string GetResultCacheKey(const string &, const string &);
+
+	// per-session results of one simulation on disk (Output\cache\<key>.txt of its data directory), appended as each session finishes
+	// so that a crashed or interrupted simulation resumes where it stopped, an identical one is read from the cache, and a longer one only computes the new sessions
+	// the file is only appended to: a line cut short by a crash is ended with a line break and skipped when read
+	// the sessions are appended in session order (see RunSessions) and read back in one forward pass, one line at a time, so that the memory does not grow with the number of cached sessions
+	struct ResultCacheType
+	{
+		string fileName;
+		ifstream inputFile; // the cached lines, up to cachedEnd
+		std::streamoff cachedEnd; // the end of the last complete line when the cache was opened (the lines appended since are not read)
+		string nextLine; // read ahead: the first line not passed yet
+		int nextLineSessionID;
+		bool hasNextLine;
+		ofstream file;
+		std::mutex fileMutex;
+
+		ResultCacheType(const string &, const string &);
+		// the cached result of the given session (marked as cached, see SessionResultType), or false if not cached
+		// the sessions must be asked for in increasing order: the lines before the given session are passed, so a session cached out of order is not found (and is run again)
+		bool ReadCachedResult(int, SessionResultType &);
+		void Append(int, const SessionResultType &);
+		ResultCacheType(const ResultCacheType &) = delete;
+		ResultCacheType &operator=(const ResultCacheType &) = delete;
+	};
+
+	// min-cost flow network (successive shortest paths), used by Alg_OPT
+	// the edges and the working arrays are kept across Reset and ClearFlow, so one network is rebuilt and solved many times without allocating
+	struct FlowNetworkType
+	{
+		struct EdgeType
+		{
+			int to;
+			int reverseEdge; // index of the reverse edge in adjacency[to]
+			int capacity; // residual capacity
+			int capacityLimit; // capacity without flow (0 for a reverse edge)
+			double cost;
+		};
+		vector<vector<EdgeType>> adjacency;
+
+		FlowNetworkType(int nodeCount = 0) { Reset(nodeCount); }
+
+		// remove all edges and set the node count
+		void Reset(int);
+
+		// return the index of the edge in adjacency[from]
+		int AddEdge(int, int, int, double);
+
+		// change the capacity limit or the cost of the edge adjacency[from][edgeIndex] (and of its reverse edge); call ClearFlow before the next MinCostFlow
+		void SetCapacityLimit(int from, int edgeIndex, int capacityLimit) { adjacency[from][edgeIndex].capacityLimit = capacityLimit; }
+		void SetCost(int from, int edgeIndex, double cost)
+		{
+			auto &edge = adjacency[from][edgeIndex];
+			edge.cost = cost;
+			adjacency[edge.to][edge.reverseEdge].cost = -cost;
+		}
+
+		// remove all flow
+		void ClearFlow();
+
+		// send up to maxFlow units from source to sink at the minimum cost
+		// return the amount of flow actually sent
+		int MinCostFlow(int, int, int, double &);
+
+		// flow on the edge adjacency[from][edgeIndex]
+		int GetFlow(int from, int edgeIndex) const
+		{
+			auto &edge = adjacency[from][edgeIndex];
+			return adjacency[edge.to][edge.reverseEdge].capacity;
+		}
+
+	private:
+		// working arrays of MinCostFlow
+		vector<double> distance;
+		vector<int> previousNode, previousEdge, nodeQueue;
+		vector<bool> isQueued;
+	};
+
 	bool Initialize(string, vector<ClientType*> &, vector<DatacenterType*> &);
-	void SimulateBasicProblem(double, double, double, double SESSION_COUNT = 1000);
-	void SimulateGeneralProblem(double, double, double, double SESSION_COUNT = 1000);
+	// besides the result files, the wall-clock timings of the phases (see Instrumentation.h) are written to Output\<G>_<R>_<size>_phaseTiming.json
+	void SimulateBasicProblem(double, double, double, const SimulationSettingType &simulationSetting = SimulationSettingType());
+	void SimulateGeneralProblem(double, double, double, const SimulationSettingType &simulationSetting = SimulationSettingType());
+
+	// the parameters of a simulation that determine its sessions' results (for GetResultCacheKey)
+	string GetSimulationParameters(string, double, double, double, const vector<double> &, bool, const LocalSearchSettingType &, const OptimalSettingType &);
+
+	// sessions a worker of RunSessions may start ahead of the next one to consume, per thread
+	const int SESSION_REORDER_WINDOW_PER_THREAD = 4;
+
+	// run the sessions firstSessionID to SESSION_COUNT, and pass each session's result to the consumer in session order (one call at a time, on any of the threads), so that the results need not be kept
+	// a session that finishes before an earlier one waits for it in a buffer, which is bounded: no session starts SESSION_REORDER_WINDOW_PER_THREAD * threadCount sessions or more ahead of the next one to consume
+	// threadCount = 0: one after another with the given clients and datacenters
+	// threadCount > 0: on threadCount worker threads, each with its own copy of the clients and datacenters
+	// each session uses its own random streams (see SessionRandomnessType), so the results are the same for any threadCount
+	// return false if any session fails (the remaining sessions are not started)
+	// resultCache (optional): sessions found in it are not run again, and the others are added to it in session order as they are consumed
+	bool RunSessions(int, double, int, const vector<ClientType*> &, const vector<DatacenterType*> &, const std::function<bool(int, const vector<ClientType*> &, const vector<DatacenterType*> &, SessionResultType &)> &,
+		const std::function<void(int, const SessionResultType &)> &, ResultCacheType *resultCache = nullptr);
+
+	// run the sessions in batches (see RunSessions) until the confidence interval of the mean LB-normalized total cost of every (capacity, column) cell is narrow enough, or SESSION_COUNT sessions have run
+	// the stopping is checked only after each batch, on the sessions 1 to n, so the number of sessions (and the results) do not depend on threadCount
+	// sessionCountOfCell: for each capacity and column, the number of sessions after which the cell first reached the target (the total number if it never did)
+	// relativeHalfWidthOfCell: for each capacity and column, the relative half-width of its interval at the end
+	bool RunSessionsAdaptively(double, const AdaptiveStoppingSettingType &, int, const vector<ClientType*> &, const vector<DatacenterType*> &, const std::function<bool(int, const vector<ClientType*> &, const vector<DatacenterType*> &, SessionResultType &)> &,
+		const std::function<void(int, const SessionResultType &)> &, ResultCacheType *, vector<vector<double>> &, vector<vector<double>> &);
+
+	// half-width of the confidence interval of the mean LB-normalized total cost of one (capacity, column) cell, relative to the mean
+	// costOfStratum: the statistics of the cell's cost over the sessions of each stratum (all in stratum 0 if not stratified)
+	double GetRelativeHalfWidth(const map<int, StatisticsAccumulatorType> &, const AdaptiveStoppingSettingType &);
+
+	// run the given tasks in the given order on threadCount worker threads (the calling thread is one of them)
+	// each worker has its own copy of the given clients and datacenters (its scratch state), which is passed to each task it runs
+	// return false if any task fails (the remaining tasks are not started)
+	bool RunTasksWithWorkspaces(const vector<int> &, int, const vector<ClientType*> &, const vector<DatacenterType*> &, const std::function<bool(int, WorkspaceType &)> &);
+
+	// run the portfolio allocator on each session of basic problem, and record its cost, winning strategies and best-so-far traces
+	void SimulatePortfolio4BasicProblem(double, double, double, double SESSION_COUNT = 1000, PortfolioSettingType portfolioSetting = PortfolioSettingType());
+
+	// time strategies LB to LAC on the sessions of basic problem at each capacity of 2, 4, 6 and 8, with the compile-time and with the run-time capacity (see RunStrategy4BasicProblem), and check that both give the same outcome
+	// the milliseconds of both and the speedup are written to Output\capacitySpecialization.csv
+	void BenchmarkCapacitySpecialization(double, double, double, double SESSION_COUNT = 100, int repetitionCount = 20);
 
 	void ResetEligibiltyCoverability(const vector<ClientType*> &, const vector<DatacenterType*> &);
 	void ResetAssignment(const vector<ClientType*> &, const vector<DatacenterType*> &);
 
+	// assign each client to the dc with the given id (indexed in the same order as the clients)
+	void ApplyAssignment(const vector<ClientType*> &, const vector<DatacenterType*> &, const vector<int> &);
+
 	// matchmaking for basic problem
 	// result: the datacenter for hosting the G-server, and a list of clients to be involved
 	// return true if found
@@ -77,35 +458,138 @@ namespace ServerAllocationProblem
 	// return <cost_total, cost_server, cost_bandwidth, capacity_wastage, average_delay>
 	tuple<double, double, double, double, double> GetSolutionOutput(vector<DatacenterType*>, double, vector<ClientType*>, int);
 
+	// function to get the solution output at each of the given capacities from the current assignment (which must be shared by all these capacities)
+	// fractional server count is used if isLowerBound is true (as in Alg_LB)
+	// return one <cost_total, cost_server, cost_bandwidth, capacity_wastage, average_delay> per capacity
+	vector<tuple<double, double, double, double, double>> GetSolutionOutputAtCapacities(const vector<DatacenterType*> &, const vector<double> &, const vector<ClientType*> &, int, bool isLowerBound = false);
+
+	// each client's delay (to its R datacenter and on to the G datacenter) and the utilization of each dc with open servers (its clients over its server slots) from the current assignment
+	// fractional server count is used if isLowerBound is true (as in Alg_LB), so each such dc is fully utilized
+	void GetDelayAndUtilization(const vector<DatacenterType*> &, double, const vector<ClientType*> &, int, vector<double> &, vector<double> &, bool isLowerBound = false);
+
+	// group the capacities (indices into the capacity list) such that the ranking of all datacenters by combined price is the same within each group
+	// LB and LCP make the same assignment at every capacity of a group, because their choices only change at the price breakpoints
+	vector<vector<size_t>> GroupCapacitiesByPriceBreakpoints(const vector<ClientType*> &, const vector<DatacenterType*> &, const vector<double> &);
+
+	// sort all datacenters by the given price criterion (combined price = priceServer / serverCapacity + priceBandwidth * chargedTrafficVolume)
+	// computed once per capacity (and traffic volume) instead of recomputing the prices in every comparison
+	PriceOrderType SortDatacentersByPrice(const vector<DatacenterType*> &, PriceCriterion, double serverCapacity = 1, double chargedTrafficVolume = 1);
+
+	// rank the client's eligible dcs by delay and then by position in its eligibleDatacenters, once its eligibility is known
+	void RankEligibleDatacenters(ClientType *);
+
+	// return the first dc in the price order that is eligible for the client (early-exit scan using the client's eligibility mask)
+	// ties in price are broken by the client's eligibleDatacenterRank, i.e. by lower delay and then by the position in its eligibleDatacenters (same as the original pairwise comparisons)
+	DatacenterType* GetFirstEligibleDatacenter(const ClientType *, const PriceOrderType &);
+
 	// return true if and only if all clients are assigned and each client is assigned to one dc
 	bool CheckIfAllClientsExactlyAssigned(vector<ClientType*>, vector<DatacenterType*>);
 
-	void WriteCostWastageDelayData(int, vector<double>, double, vector<vector<vector<tuple<double, double, double, double, double>>>>&, string, string);	
+	// run one strategy (see STRATEGY_COUNT for the strategy ids) for basic problem
+	// the common capacities (2, 4, 6 and 8) run on versions of the strategies compiled for that capacity, unless capacitySpecialization is false
+	tuple<double, double, double, double, double> RunStrategy4BasicProblem(int, const vector<ClientType*> &, const vector<DatacenterType*> &, double, int, bool capacitySpecialization = true);
 
-	// Lower-Bound (LB)
+	// run one strategy (same strategy ids as above) for general problem
+	// i.e., its basic version at each eligible G datacenter, keeping the one with the smallest total cost (whose assignment and setup are left in the clients and dcs)
+	tuple<double, double, double, double, double> RunStrategy4GeneralProblem(int, const vector<DatacenterType*> &, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double);
+
+	// clients of each connected component of the client-dc eligibility graph of the current setup (the dcs of a component are the eligible dcs of its clients), in the order of the given clients
+	// components share no client and no dc, so they can be solved independently
+	vector<vector<ClientType*>> GetEligibilityComponents(const vector<ClientType*> &, const vector<DatacenterType*> &);
+
+	// run one strategy on each component of the eligibility graph on threadCount threads, in place on the given clients and dcs (each component sees only its own dcs, the others are replaced by price-only stand-ins)
+	// runs on the whole instance if there is only one component or one thread
+	// the combined assignment and outcome are the same as the whole instance's, except that RANDOM (whose choices are drawn in client order) always runs on the whole instance
 	// for basic problem
-	tuple<double, double, double, double, double> Alg_LB(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int);
+	tuple<double, double, double, double, double> RunStrategyDecomposed4BasicProblem(int, const vector<ClientType*> &, const vector<DatacenterType*> &, double, int, int);
+
+	// the above at each eligible G datacenter (see RunStrategy4GeneralProblem)
+	// for general problem
+	tuple<double, double, double, double, double> RunStrategyDecomposed4GeneralProblem(int, const vector<DatacenterType*> &, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, int);
+
+	// run one strategy and then improve its assignment by local search (LS)
+	// for basic problem
+	tuple<double, double, double, double, double> RunStrategyWithLocalSearch4BasicProblem(int, const vector<ClientType*> &, const vector<DatacenterType*> &, double, int, const LocalSearchSettingType &);
+
+	// run one strategy and then improve its assignment by local search (LS) at each eligible G datacenter, and choose the smaller cost
+	// for general problem
+	tuple<double, double, double, double, double> RunStrategyWithLocalSearch4GeneralProblem(int, const vector<DatacenterType*> &, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, const LocalSearchSettingType &);
+
+	// run OPT within the setting's time budget
+	// isProvenOptimal (optional): see Alg_OPT
+	// for basic problem
+	tuple<double, double, double, double, double> RunOptimal4BasicProblem(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int, const OptimalSettingType &, bool *isProvenOptimal = nullptr);
+
+	// run OPT within the setting's time budget at each eligible G datacenter, and choose the smaller cost
+	// isProvenOptimal (optional): false unless the run at every G datacenter is proven optimal
+	// for general problem
+	tuple<double, double, double, double, double> RunOptimal4GeneralProblem(const vector<DatacenterType*> &, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, const OptimalSettingType &, bool *isProvenOptimal = nullptr);
+
+	// the groups of capacities (indices into the capacity list) that share one assignment of the given strategy
+	vector<vector<size_t>> GetCapacityGroupsOfStrategy(int, const vector<vector<size_t>> &, size_t);
+
+	// run all strategies at each capacity for one session of basic problem
+	// result: outcome, computation time, client delays and server utilizations (see SessionResultType) indexed by [capacity][column] (see GetColumnCount: OPT only if it is enabled, followed by the LS columns if LS is enabled), and whether OPT is unproven per capacity
+	// return false if any assignment is invalid
+	bool EvaluateStrategies4BasicProblem(const vector<ClientType*> &, const vector<DatacenterType*> &, const vector<double> &, int, vector<vector<tuple<double, double, double, double, double>>> &, vector<vector<double>> &,
+		vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<int> &, const LocalSearchSettingType &localSearchSetting = LocalSearchSettingType(), const OptimalSettingType &optimalSetting = OptimalSettingType());
+
+	// capacity-parametric version of the above: the whole capacity list is evaluated in one pass
+	// RANDOM, NEAREST, LSP and LBP assign once, LB and LCP assign once per price breakpoint interval, and only LCW, LAC and OPT are rerun at each capacity
+	bool EvaluateStrategiesParametric4BasicProblem(const vector<ClientType*> &, const vector<DatacenterType*> &, const vector<double> &, int, vector<vector<tuple<double, double, double, double, double>>> &, vector<vector<double>> &,
+		vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<int> &, const LocalSearchSettingType &localSearchSetting = LocalSearchSettingType(), const OptimalSettingType &optimalSetting = OptimalSettingType());
+
+	// run all strategies at each capacity for one session of general problem
+	// result: outcome, computation time, final G datacenter, server count per dc (indexed by dc's id), client delays and server utilizations (at the final G datacenter) indexed by [capacity][column], and whether OPT is unproven per capacity
+	// componentThreadCount > 0: the base strategies are run by RunStrategyDecomposed4GeneralProblem on that many threads (except OPT, which splits the instance into its components itself)
+	// return false if any assignment is invalid
+	bool EvaluateStrategies4GeneralProblem(const vector<DatacenterType*> &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, const vector<double> &,
+		vector<vector<tuple<double, double, double, double, double>>> &, vector<vector<double>> &, vector<vector<int>> &, vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<int> &,
+		const LocalSearchSettingType &localSearchSetting = LocalSearchSettingType(), int componentThreadCount = 0, const OptimalSettingType &optimalSetting = OptimalSettingType());
+
+	// capacity-parametric version of the above (see EvaluateStrategiesParametric4BasicProblem)
+	bool EvaluateStrategiesParametric4GeneralProblem(const vector<DatacenterType*> &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, const vector<double> &,
+		vector<vector<tuple<double, double, double, double, double>>> &, vector<vector<double>> &, vector<vector<int>> &, vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<int> &,
+		const LocalSearchSettingType &localSearchSetting = LocalSearchSettingType(), const OptimalSettingType &optimalSetting = OptimalSettingType());
+
+	// cells of one session (indices of [capacity][column] in row-major order), with the OPT cells (if enabled) first since they take the longest
+	vector<int> GetCellsOfSession(size_t, int, const OptimalSettingType &);
+
+	// intra-session parallel version of EvaluateStrategies4BasicProblem: each (strategy, capacity) cell is evaluated as its own task on threadCount threads, each with private copies of the session's clients and datacenters
+	// each cell uses the caller's session randomness, so the results are the same as the serial evaluation
+	bool EvaluateStrategiesFanOut4BasicProblem(const vector<ClientType*> &, const vector<DatacenterType*> &, const vector<double> &, int, vector<vector<tuple<double, double, double, double, double>>> &, vector<vector<double>> &,
+		vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<int> &, const LocalSearchSettingType &, const OptimalSettingType &, int);
+
+	// intra-session parallel version of EvaluateStrategies4GeneralProblem (see EvaluateStrategiesFanOut4BasicProblem)
+	bool EvaluateStrategiesFanOut4GeneralProblem(const vector<DatacenterType*> &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, const vector<double> &,
+		vector<vector<tuple<double, double, double, double, double>>> &, vector<vector<double>> &, vector<vector<int>> &, vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<vector<vector<double>>> &, vector<int> &,
+		const LocalSearchSettingType &, const OptimalSettingType &, int);
+
+	// mean and std files of costTotal, capacityWastage and averageDelay (one row per capacity and one column per strategy)
+	void WriteCostWastageDelayData(const OutcomeStatisticsType &, string, string);
+	// the same for computation, with the given separator after each column
+	void WriteComputationData(const OutcomeStatisticsType &, string, string, string);
+	// quantile files of clientDelay and serverUtilization: <metric>P50.csv, <metric>P95.csv and <metric>P99.csv (one row per capacity and one column per strategy)
+	// and <metric>CDF.csv: one row per capacity and strategy (capacity-major) with the values at the quantiles 0, 0.01, ..., 1 (the points of the empirical CDF, as cdfplot in my_plot_cdf.m)
+	void WriteDelayAndUtilizationData(const OutcomeStatisticsType &, string, string);
+	void WriteAdaptiveStoppingData(const vector<vector<double>> &, const vector<vector<double>> &, string, string);
+	// optUnprovenCount.csv: the number of sessions whose OPT result is not proven optimal (one row per capacity), with a warning if there is any
+	void WriteUnprovenOptimalData(const OutcomeStatisticsType &, string, string);
+
+	// the strategies for basic problem (see RunStrategy4GeneralProblem for general problem)
 
 	// Lower-Bound (LB)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LB(vector<DatacenterType*>, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, bool includingGServerCost = false);
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_LB(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int);
 
 	// Random-Assignment
 	// for basic problem
 	tuple<double, double, double, double, double> Alg_RANDOM(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int);
 
-	// Random-Assignment
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_RANDOM(vector<DatacenterType*>, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, bool includingGServerCost = false);
-
 	// Nearest-Assignment
 	// for basic problem
 	tuple<double, double, double, double, double> Alg_NEAREST(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int);
 
-	// Nearest-Assignment
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_NEAREST(vector<DatacenterType*>, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, bool includingGServerCost = false);
-
 	// Lowest-Server-Price-Datacenter-Assignment (LSP)
 	// for basic problem
 	tuple<double, double, double, double, double> Alg_LSP(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int);
@@ -118,34 +602,38 @@ namespace ServerAllocationProblem
 	// for basic problem
 	tuple<double, double, double, double, double> Alg_LCP(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int);
 
-	// Lowest-Server-Price-Datacenter-Assignment (LSP)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LSP(vector<DatacenterType*>, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, bool includingGServerCost = false);
-
-	// Lowest-Bandwidth-Price-Datacenter-Assignment (LBP)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LBP(vector<DatacenterType*>, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, bool includingGServerCost = false);
-
-	// Lowest-Combined-Price-Datacenter-Assignment (LCP)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LCP(vector<DatacenterType*>, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, bool includingGServerCost = false);
-
 	// Lowest-Capacity-Wastage-Assignment (LCW)
 	// if server capacity < 2, reduce to LCP
 	// for basic problem
 	tuple<double, double, double, double, double> Alg_LCW(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int);
 
-	// Lowest-Capacity-Wastage-Assignment (LCW)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LCW(vector<DatacenterType*>, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, bool includingGServerCost = false);
-
 	// Lowest-Average-Cost-Assignment (LAC)
 	// Idea: open exactly one server at each iteration, and where to open the server is determined based on the average cost contributed by all clients that are to be assigned to this server
 	// if server capacity < 2, reduce to LCP
 	// for basic problem
 	tuple<double, double, double, double, double> Alg_LAC(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int);
 
-	// Lowest-Average-Cost-Assignment (LAC)
-	// overloaded for general problem
-	tuple<double, double, double, double, double> Alg_LAC(vector<DatacenterType*>, int &, const vector<ClientType*> &, const vector<DatacenterType*> &, double, double, double, bool includingGServerCost = false);
+	// Optimal (OPT)
+	// solution of the integer problem by branch-and-bound on the server count of each dc, optimal unless the search is cut short (see isProvenOptimal)
+	// sessions of ~100 clients under the default delay bounds take about a millisecond, but loose delay bounds (many eligible dcs per client) can take seconds
+	// the bound at each node is the LP relaxation (fractional servers above the branched lower bounds), solved as a min-cost flow from client types to dcs,
+	// strengthened by pricing in the cut "each component has at least ceil(clientCount / serverCapacity) servers" (a Lagrangian relaxation), which removes most of the search
+	// if TIME_BUDGET (wall-clock milliseconds) is positive and used up, the best solution found so far is returned
+	// isProvenOptimal (optional): set to false if the search was cut short (by the budget or the node limit) or fell back to LCP, i.e. the result may not be optimal
+	// for basic problem
+	tuple<double, double, double, double, double> Alg_OPT(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int, double TIME_BUDGET = 0, bool *isProvenOptimal = nullptr);
+
+	// Local-Search post-optimizer (LS)
+	// improve the current assignment by client moves, client swaps and server closings, accepting only the ones that reduce the total cost
+	// per-dc client counts are maintained incrementally, so the cost change of each move is evaluated in constant time
+	// stop at a local optimum or when the budget is used up
+	// for basic problem
+	tuple<double, double, double, double, double> ImproveByLocalSearch(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int, const LocalSearchSettingType &);
+
+	// Portfolio allocator
+	// run the given strategies concurrently on private copies of the session (optionally followed by LS), and keep the best solution found within the wall-clock budget
+	// strategies already running when the budget is used up are not interrupted, except OPT and LS that stop at the deadline
+	// the best assignment is applied to the given clients and datacenters
+	// for basic problem
+	PortfolioOutcomeType AllocateByPortfolio(const vector<ClientType*> &, const vector<DatacenterType*> &, double, int, const PortfolioSettingType &);
 }
\ No newline at end of file
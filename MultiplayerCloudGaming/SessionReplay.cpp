@@ -0,0 +1,430 @@
+#include "SessionReplay.h"
+
+#include <cstring>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace SessionReplay
+{
+	using namespace ServerAllocationProblem;
+
+	MappedFileType::MappedFileType(const string &fileName)
+	{
+		this->data = nullptr;
+		this->size = 0;
+#ifdef _WIN32
+		this->fileHandle = INVALID_HANDLE_VALUE;
+		this->mappingHandle = nullptr;
+
+		fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (INVALID_HANDLE_VALUE == fileHandle) return;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize) || 0 == fileSize.QuadPart) return;
+		mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (nullptr == mappingHandle) return;
+		data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (nullptr != data) size = (size_t)fileSize.QuadPart;
+#else
+		this->fileDescriptor = open(fileName.c_str(), O_RDONLY);
+		if (fileDescriptor < 0) return;
+		struct stat fileStatus;
+		if (0 != fstat(fileDescriptor, &fileStatus) || 0 == fileStatus.st_size) return;
+		void *mapping = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (MAP_FAILED == mapping) return;
+		madvise(mapping, (size_t)fileStatus.st_size, MADV_SEQUENTIAL); // read once from the start, so the kernel reads ahead
+		data = (const char*)mapping;
+		size = (size_t)fileStatus.st_size;
+#endif
+	}
+
+	MappedFileType::~MappedFileType()
+	{
+#ifdef _WIN32
+		if (nullptr != data) UnmapViewOfFile(data);
+		if (nullptr != mappingHandle) CloseHandle(mappingHandle);
+		if (INVALID_HANDLE_VALUE != fileHandle) CloseHandle(fileHandle);
+#else
+		if (nullptr != data) munmap((void*)data, size);
+		if (fileDescriptor >= 0) close(fileDescriptor);
+#endif
+	}
+
+	OwnedTopologyType::~OwnedTopologyType()
+	{
+		for (auto client : clients) delete client;
+		for (auto dc : datacenters) delete dc;
+	}
+
+	// copy one value from the mapping (false if the file ends before it)
+	template <class T>
+	bool ReadValue(const MappedFileType &file, size_t &offset, T &value)
+	{
+		if (file.size - offset < sizeof(T)) return false;
+		memcpy(&value, file.data + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	SessionTraceReaderType::SessionTraceReaderType(const string &fileName) : file(fileName)
+	{
+		this->sessionCount = 0;
+		this->firstSessionOffset = 0;
+		this->offset = 0;
+		this->isValid = false;
+		this->isTruncated = false;
+
+		if (!file.IsOpen())
+		{
+			printf("ERROR: cannot map %s\n", fileName.c_str());
+			return;
+		}
+
+		unsigned int magic = 0, version = 0, identifierCount = 0;
+		if (!ReadValue(file, offset, magic) || magic != SESSION_TRACE_MAGIC || !ReadValue(file, offset, version) || version != SESSION_TRACE_VERSION || !ReadValue(file, offset, identifierCount))
+		{
+			printf("ERROR: %s is not a session trace (of version %u)\n", fileName.c_str(), SESSION_TRACE_VERSION);
+			return;
+		}
+		identifiers.reserve(identifierCount);
+		for (unsigned int i = 0; i < identifierCount; i++)
+		{
+			unsigned short length = 0;
+			if (!ReadValue(file, offset, length) || file.size - offset < length)
+			{
+				printf("ERROR: %s has an incomplete header\n", fileName.c_str());
+				return;
+			}
+			identifiers.push_back(string(file.data + offset, length));
+			offset += length;
+		}
+		if (!ReadValue(file, offset, sessionCount))
+		{
+			printf("ERROR: %s has an incomplete header\n", fileName.c_str());
+			return;
+		}
+
+		firstSessionOffset = offset;
+		isValid = true;
+	}
+
+	bool SessionTraceReaderType::ReadNextSession(TraceSessionType &session)
+	{
+		if (!isValid || offset >= file.size) return false;
+
+		size_t sessionOffset = offset;
+		float delayBoundToG = 0, delayBoundToR = 0;
+		int GDatacenterID = -1;
+		unsigned short clientCount = 0;
+		bool isComplete = ReadValue(file, offset, session.timestamp) && ReadValue(file, offset, delayBoundToG) && ReadValue(file, offset, delayBoundToR)
+			&& ReadValue(file, offset, GDatacenterID) && ReadValue(file, offset, clientCount) && file.size - offset >= clientCount * sizeof(unsigned int);
+		if (!isComplete)
+		{
+			offset = sessionOffset;
+			isTruncated = true;
+			return false;
+		}
+
+		session.delayBoundToG = delayBoundToG;
+		session.delayBoundToR = delayBoundToR;
+		session.GDatacenterID = GDatacenterID;
+		session.clients.resize(clientCount);
+		if (clientCount > 0) memcpy(session.clients.data(), file.data + offset, clientCount * sizeof(unsigned int));
+		offset += clientCount * sizeof(unsigned int);
+		return true;
+	}
+
+	template <class T>
+	void WriteValue(ofstream &file, const T &value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	bool WriteSessionTrace(const string &fileName, const vector<string> &identifiers, const vector<TraceSessionType> &sessions)
+	{
+		ofstream file(fileName, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			printf("ERROR: cannot write the session trace to %s\n", fileName.c_str());
+			return false;
+		}
+
+		WriteValue(file, SESSION_TRACE_MAGIC);
+		WriteValue(file, SESSION_TRACE_VERSION);
+		WriteValue(file, (unsigned int)identifiers.size());
+		for (auto &identifier : identifiers)
+		{
+			WriteValue(file, (unsigned short)identifier.size());
+			file.write(identifier.data(), identifier.size());
+		}
+		WriteValue(file, (unsigned int)sessions.size());
+		for (auto &session : sessions)
+		{
+			WriteValue(file, session.timestamp);
+			WriteValue(file, (float)session.delayBoundToG);
+			WriteValue(file, (float)session.delayBoundToR);
+			WriteValue(file, session.GDatacenterID);
+			WriteValue(file, (unsigned short)session.clients.size());
+			if (!session.clients.empty()) file.write(reinterpret_cast<const char*>(session.clients.data()), session.clients.size() * sizeof(unsigned int));
+		}
+
+		file.close();
+		return !file.fail();
+	}
+
+	// names of the clients of a data directory (the first column of dc_to_pl_rtt.csv), in the order of their ids
+	vector<string> GetClientNames(const string &dataDirectory)
+	{
+		vector<string> clientNames;
+		for (auto &row : ReadDelimitedTextFileIntoVector(dataDirectory + "dc_to_pl_rtt.csv", ',', true))
+		{
+			clientNames.push_back(row.empty() ? string() : row.front());
+		}
+		return clientNames;
+	}
+
+	bool RecordSyntheticTrace(const string &dataDirectory, const string &fileName, double DELAY_BOUND_TO_G, double DELAY_BOUND_TO_R, double SESSION_SIZE, double SESSION_COUNT, double sessionsPerSecond)
+	{
+		OwnedTopologyType topology;
+		auto &allClients = topology.clients;
+		auto &allDatacenters = topology.datacenters;
+		if (!Initialize(dataDirectory, allClients, allDatacenters))
+		{
+			printf("ERROR: initialization failed!\n");
+			return false;
+		}
+
+		vector<TraceSessionType> sessions;
+		for (int sessionID = 1; sessionID <= SESSION_COUNT; sessionID++)
+		{
+			SessionRandomnessType randomness(sessionID); // the sessions of SimulateBasicProblem
+			TraceSessionType session;
+			vector<ClientType*> sessionClients;
+			if (!Matchmaking4BasicProblem(allDatacenters, allClients, session.GDatacenterID, sessionClients, SESSION_SIZE, DELAY_BOUND_TO_G, DELAY_BOUND_TO_R))
+			{
+				printf("ERROR: infeasible session\n");
+				return false;
+			}
+
+			session.timestamp = (sessionID - 1) / sessionsPerSecond;
+			session.delayBoundToG = DELAY_BOUND_TO_G;
+			session.delayBoundToR = DELAY_BOUND_TO_R;
+			for (auto client : sessionClients) session.clients.push_back((unsigned int)client->id);
+			sessions.push_back(session);
+		}
+
+		if (!WriteSessionTrace(fileName, GetClientNames(dataDirectory), sessions)) return false;
+		printf("%d sessions recorded into %s\n", (int)sessions.size(), fileName.c_str());
+		return true;
+	}
+
+	bool ReplayTrace(const string &fileName, const string &dataDirectory, const ReplaySettingType &replaySetting, ReplayStatisticsType &statistics)
+	{
+		auto t0 = std::chrono::steady_clock::now(); // start time
+		Instrumentation::ResetPhaseHistograms(); // the phase timings of this replay only
+		Instrumentation::ResetMemoryProfile(); // and its allocations
+		Instrumentation::ResetOperationCounts(); // and its operation counts
+
+		const int strategyID = replaySetting.strategyID;
+		if (strategyID < 1 || strategyID > STRATEGY_COUNT)
+		{
+			printf("ERROR: invalid strategy %d\n", strategyID);
+			return false;
+		}
+
+		SessionTraceReaderType trace(fileName);
+		if (!trace.IsValid()) return false;
+
+		OwnedTopologyType topology;
+		auto &allClients = topology.clients;
+		auto &allDatacenters = topology.datacenters;
+		if (!Initialize(dataDirectory, allClients, allDatacenters))
+		{
+			printf("ERROR: initialization failed!\n");
+			return false;
+		}
+
+		// the client (row) of each identifier of the trace (-1: not in the topology)
+		map<string, int> clientIDOfName;
+		auto clientNames = GetClientNames(dataDirectory);
+		for (int i = (int)std::min(clientNames.size(), allClients.size()) - 1; i >= 0; i--) clientIDOfName[clientNames.at(i)] = i; // the first row of a repeated name
+		vector<int> clientIDOfIdentifier;
+		int unknownIdentifierCount = 0;
+		for (auto &identifier : trace.identifiers)
+		{
+			auto it = clientIDOfName.find(identifier);
+			clientIDOfIdentifier.push_back((it != clientIDOfName.end()) ? it->second : -1);
+			if (it == clientIDOfName.end()) unknownIdentifierCount++;
+		}
+		printf("%s: %u sessions, %d client identifiers (%d not in the topology)\n", fileName.c_str(), trace.sessionCount, (int)trace.identifiers.size(), unknownIdentifierCount);
+
+		const vector<double> SERVER_CAPACITY_LIST = { 2, 4, 6, 8 };
+		statistics = ReplayStatisticsType();
+		statistics.capacities.resize(SERVER_CAPACITY_LIST.size());
+
+		OwnedTopologyType duplicates; // the second (third, etc.) appearances of a client in a session, reused by the later sessions
+		auto &duplicateClients = duplicates.clients;
+		vector<bool> isInSession(allClients.size(), false);
+		vector<ClientType*> sessionClients;
+		vector<DatacenterType*> eligibleGDatacenters;
+		vector<double> clientDelay, serverUtilization;
+		TraceSessionType session;
+		double firstTimestamp = 0, lastTimestamp = 0;
+		auto replayStartTime = std::chrono::steady_clock::now();
+
+		for (int sessionID = 1; (0 == replaySetting.maxSessionCount || sessionID <= replaySetting.maxSessionCount) && trace.ReadNextSession(session); sessionID++)
+		{
+			if (1 == sessionID) firstTimestamp = session.timestamp;
+			if (replaySetting.speed > 0) // wait for the session's time on the scaled clock
+			{
+				auto scheduledTime = replayStartTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((session.timestamp - firstTimestamp) / replaySetting.speed));
+				std::this_thread::sleep_until(scheduledTime);
+				statistics.lateness.Add(std::max(0.0, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scheduledTime).count()));
+			}
+
+			// the session's clients
+			sessionClients.clear();
+			size_t duplicateCount = 0;
+			bool isKnown = !session.clients.empty();
+			for (auto identifier : session.clients)
+			{
+				int clientID = (identifier < clientIDOfIdentifier.size()) ? clientIDOfIdentifier.at(identifier) : -1;
+				if (clientID < 0)
+				{
+					isKnown = false;
+					break;
+				}
+				if (!isInSession.at(clientID))
+				{
+					isInSession.at(clientID) = true;
+					sessionClients.push_back(allClients.at(clientID));
+					continue;
+				}
+
+				if (duplicateCount == duplicateClients.size()) duplicateClients.push_back(new ClientType((int)(allClients.size() + duplicateCount))); // an id of its own
+				auto duplicateClient = duplicateClients.at(duplicateCount++);
+				duplicateClient->chargedTrafficVolume = allClients.at(clientID)->chargedTrafficVolume;
+				duplicateClient->delayToDatacenter = allClients.at(clientID)->delayToDatacenter;
+				sessionClients.push_back(duplicateClient);
+			}
+			for (auto client : sessionClients)
+			{
+				if (client->id < (int)allClients.size()) isInSession.at(client->id) = false;
+			}
+			if (!isKnown)
+			{
+				statistics.unknownClientSessionCount++;
+				continue;
+			}
+
+			// where the G-server can be
+			SessionRandomnessType randomness(sessionID);
+			bool isBasicProblem = session.GDatacenterID >= 0 && session.GDatacenterID < (int)allDatacenters.size();
+			bool isFeasible = true;
+			if (isBasicProblem)
+			{
+				SimulationSetup4GeneralProblem(allDatacenters.at(session.GDatacenterID), sessionClients, allDatacenters, session.delayBoundToG, session.delayBoundToR);
+				for (auto client : sessionClients)
+				{
+					if (client->eligibleDatacenters.empty()) isFeasible = false;
+				}
+			}
+			else
+			{
+				SearchEligibleGDatacenter(allDatacenters, sessionClients, eligibleGDatacenters, session.delayBoundToG, session.delayBoundToR);
+				isFeasible = !eligibleGDatacenters.empty();
+			}
+			if (!isFeasible)
+			{
+				statistics.infeasibleSessionCount++;
+				continue;
+			}
+
+			for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+			{
+				auto timePoint = std::chrono::steady_clock::now();
+				int GDatacenterID = session.GDatacenterID;
+				auto outcome = (STRATEGY_OPT == strategyID) ? // within OPT's default time budget
+					(isBasicProblem ?
+						RunOptimal4BasicProblem(sessionClients, allDatacenters, SERVER_CAPACITY_LIST.at(j), GDatacenterID, OptimalSettingType(true)) :
+						RunOptimal4GeneralProblem(eligibleGDatacenters, GDatacenterID, sessionClients, allDatacenters, session.delayBoundToG, session.delayBoundToR, SERVER_CAPACITY_LIST.at(j), OptimalSettingType(true))) :
+					(isBasicProblem ?
+						RunStrategy4BasicProblem(strategyID, sessionClients, allDatacenters, SERVER_CAPACITY_LIST.at(j), GDatacenterID) :
+						RunStrategy4GeneralProblem(strategyID, eligibleGDatacenters, GDatacenterID, sessionClients, allDatacenters, session.delayBoundToG, session.delayBoundToR, SERVER_CAPACITY_LIST.at(j)));
+				double computation = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timePoint).count();
+
+				if (!CheckIfAllClientsExactlyAssigned(sessionClients, allDatacenters))
+				{
+					printf("Something wrong with client-to-datacenter assignment!\n");
+					return false;
+				}
+				GetDelayAndUtilization(allDatacenters, SERVER_CAPACITY_LIST.at(j), sessionClients, GDatacenterID, clientDelay, serverUtilization, 1 == strategyID);
+
+				auto &capacityStatistics = statistics.capacities.at(j);
+				capacityStatistics.costTotal.Add(get<0>(outcome));
+				capacityStatistics.costServer.Add(get<1>(outcome));
+				capacityStatistics.costBandwidth.Add(get<2>(outcome));
+				capacityStatistics.capacityWastage.Add(get<3>(outcome));
+				capacityStatistics.averageDelay.Add(get<4>(outcome));
+				for (auto delay : clientDelay) capacityStatistics.clientDelay.Add(delay);
+				capacityStatistics.computation.Add(computation);
+				statistics.busyTime += computation;
+			}
+
+			statistics.replayedSessionCount++;
+			statistics.clientCount += sessionClients.size();
+			statistics.duplicateClientCount += duplicateCount;
+			lastTimestamp = session.timestamp;
+		}
+		statistics.wallTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - replayStartTime).count();
+		statistics.traceSpan = lastTimestamp - firstTimestamp;
+
+		if (trace.isTruncated) printf("WARNING: %s ends within a session, which is skipped\n", fileName.c_str());
+
+		/*******************************************************************************************************/
+
+		Instrumentation::PhaseTimerType outputTimer(Instrumentation::PHASE_OUTPUT);
+
+		double sessionCount = statistics.replayedSessionCount;
+		printf("------------------------------------------------------------------------\n");
+		printf("replayed %d sessions (%d clients, %d appearing again in their session) with %s, %d skipped for unknown clients, %d infeasible\n", (int)sessionCount, (int)statistics.clientCount, (int)statistics.duplicateClientCount,
+			Instrumentation::GetPhaseName(Instrumentation::GetStrategyPhase(strategyID)), (int)statistics.unknownClientSessionCount, (int)statistics.infeasibleSessionCount);
+		printf("throughput: %.1f sessions per second (%.1f while running the strategy), trace span %.1f s in %.1f s of wall-clock time\n",
+			statistics.wallTime > 0 ? sessionCount * 1000 / statistics.wallTime : 0, statistics.busyTime > 0 ? sessionCount * 1000 / statistics.busyTime : 0, statistics.traceSpan, statistics.wallTime / 1000);
+		if (replaySetting.speed > 0) printf("lateness: mean %.3f ms, max %.3f ms (at %gx speed)\n", statistics.lateness.GetMean(), statistics.lateness.maxValue, replaySetting.speed);
+		printf("%8s %12s %12s %14s %10s %10s %10s %10s %12s %12s\n", "capacity", "costTotal", "costServer", "costBandwidth", "wastage", "delay", "delayP95", "delayP99", "computation", "computP99");
+
+		ofstream replayFile(dataDirectory + "Output\\" + "replay" + std::to_string(strategyID) + ".csv");
+		replayFile << "capacity,sessions,costTotalMean,costTotalStd,costServerMean,costBandwidthMean,capacityWastageMean,averageDelayMean,clientDelayP50,clientDelayP95,clientDelayP99,computationMean,computationP99,sessionsPerSecond,busySessionsPerSecond,latenessMean,latenessMax\n";
+		for (size_t j = 0; j < SERVER_CAPACITY_LIST.size(); j++)
+		{
+			auto &capacityStatistics = statistics.capacities.at(j);
+			printf("%8g %12.4f %12.4f %14.4f %10.4f %10.2f %10.2f %10.2f %12.4f %12.4f\n", SERVER_CAPACITY_LIST.at(j), capacityStatistics.costTotal.GetMean(), capacityStatistics.costServer.GetMean(), capacityStatistics.costBandwidth.GetMean(),
+				capacityStatistics.capacityWastage.GetMean(), capacityStatistics.averageDelay.GetMean(), capacityStatistics.clientDelay.GetQuantile(0.95), capacityStatistics.clientDelay.GetQuantile(0.99),
+				capacityStatistics.computation.GetMean(), capacityStatistics.computation.GetQuantile(0.99));
+
+			replayFile << SERVER_CAPACITY_LIST.at(j) << "," << sessionCount << "," << capacityStatistics.costTotal.GetMean() << "," << capacityStatistics.costTotal.GetStd() << ","
+				<< capacityStatistics.costServer.GetMean() << "," << capacityStatistics.costBandwidth.GetMean() << "," << capacityStatistics.capacityWastage.GetMean() << "," << capacityStatistics.averageDelay.GetMean() << ","
+				<< capacityStatistics.clientDelay.GetQuantile(0.5) << "," << capacityStatistics.clientDelay.GetQuantile(0.95) << "," << capacityStatistics.clientDelay.GetQuantile(0.99) << ","
+				<< capacityStatistics.computation.GetMean() << "," << capacityStatistics.computation.GetQuantile(0.99) << ","
+				<< (statistics.wallTime > 0 ? sessionCount * 1000 / statistics.wallTime : 0) << "," << (statistics.busyTime > 0 ? sessionCount * 1000 / statistics.busyTime : 0) << ","
+				<< statistics.lateness.GetMean() << "," << statistics.lateness.maxValue << "\n";
+		}
+		replayFile.close();
+
+		outputTimer.Stop();
+
+		/*******************************************************************************************************/
+
+		printf("------------------------------------------------------------------------\n");
+		Instrumentation::WritePhaseTimings(dataDirectory + "Output\\" + "replay" + std::to_string(strategyID) + "_phaseTiming.json");
+		Instrumentation::WriteMemoryProfile(dataDirectory + "Output\\" + "replay" + std::to_string(strategyID) + "_memoryProfile.json");
+		printf("total elapsed time: %d seconds\n", (int)std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count()); // elapsed time of the process
+		return true;
+	}
+}
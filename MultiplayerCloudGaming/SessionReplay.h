@@ -0,0 +1,151 @@
+#pragma once
+
+#include "ServerAllocationProblem.h"
+
+// replay of recorded sessions (e.g. production matchmaking logs) instead of the ones formed by Matchmaking4BasicProblem: each session of a trace is fed through one strategy at each capacity, at full speed or at a scaled wall-clock rate
+// a trace is a compact binary file, read through a memory mapping (a long trace is neither copied nor parsed up front), in the machine's byte order:
+//   header: uint32 SESSION_TRACE_MAGIC, uint32 SESSION_TRACE_VERSION, uint32 identifier count, each identifier as uint16 length and bytes (a client's name or prefix, as in the first column of dc_to_pl_rtt.csv), uint32 session count
+//   session: float64 timestamp (seconds, non-decreasing), float32 DELAY_BOUND_TO_G, float32 DELAY_BOUND_TO_R, int32 G datacenter id (-1: not recorded), uint16 client count n, uint32 client[n] (indices into the identifiers)
+namespace SessionReplay
+{
+	const unsigned int SESSION_TRACE_MAGIC = 0x5254434D; // "MCTR"
+	const unsigned int SESSION_TRACE_VERSION = 1;
+
+	// one session of a trace
+	struct TraceSessionType
+	{
+		double timestamp; // seconds
+		double delayBoundToG;
+		double delayBoundToR;
+		int GDatacenterID; // the one chosen by the matchmaking (basic problem), or -1 to choose among the eligible ones (general problem)
+		vector<unsigned int> clients; // indices into the trace's identifiers (a client may appear more than once, e.g. several players behind one prefix)
+
+		TraceSessionType()
+		{
+			this->timestamp = 0;
+			this->delayBoundToG = 0;
+			this->delayBoundToR = 0;
+			this->GDatacenterID = -1;
+		}
+	};
+
+	// read-only memory mapping of a whole file
+	struct MappedFileType
+	{
+		const char *data; // nullptr if the file cannot be mapped
+		size_t size;
+#ifdef _WIN32
+		void *fileHandle;
+		void *mappingHandle;
+#else
+		int fileDescriptor;
+#endif
+
+		MappedFileType(const string &);
+		~MappedFileType();
+		MappedFileType(const MappedFileType &) = delete;
+		MappedFileType &operator=(const MappedFileType &) = delete;
+
+		bool IsOpen() const { return nullptr != data; }
+	};
+
+	// the sessions of a trace, decoded one at a time from the mapping
+	struct SessionTraceReaderType
+	{
+		MappedFileType file;
+		vector<string> identifiers;
+		unsigned int sessionCount; // as written in the header
+		size_t firstSessionOffset;
+		size_t offset; // of the next session
+		bool isValid; // the header has been read
+		bool isTruncated; // the trace ends within a session (e.g. a crash of its writer)
+
+		// map the file and read its header; check IsValid
+		SessionTraceReaderType(const string &);
+
+		bool IsValid() const { return isValid; }
+
+		// the next session, reusing the given one's vector (false at the end of the trace)
+		bool ReadNextSession(TraceSessionType &);
+
+		// back to the first session
+		void Rewind() { offset = firstSessionOffset; }
+	};
+
+	// the clients and dcs read from a data directory (see Initialize), deleted with this object on every exit path
+	struct OwnedTopologyType
+	{
+		vector<ServerAllocationProblem::ClientType*> clients;
+		vector<ServerAllocationProblem::DatacenterType*> datacenters;
+
+		OwnedTopologyType() {}
+		~OwnedTopologyType();
+		OwnedTopologyType(const OwnedTopologyType &) = delete;
+		OwnedTopologyType &operator=(const OwnedTopologyType &) = delete;
+	};
+
+	// write a trace (e.g. converted from a log); return false if the file cannot be written
+	bool WriteSessionTrace(const string &, const vector<string> &, const vector<TraceSessionType> &);
+
+	// record the sessions 1 to SESSION_COUNT that SimulateBasicProblem would form on the given data directory as a trace, sessionsPerSecond apart, to try the replay or compare it with a simulation
+	bool RecordSyntheticTrace(const string &, const string &, double, double, double, double SESSION_COUNT = 1000, double sessionsPerSecond = 10);
+
+	// settings of a replay
+	struct ReplaySettingType
+	{
+		int strategyID; // see STRATEGY_COUNT (OPT within the default time budget of OptimalSettingType)
+		double speed; // trace seconds per wall-clock second (0: full speed, each session as soon as the previous one is done)
+		double maxSessionCount; // 0: the whole trace
+
+		ReplaySettingType(int givenStrategyID = 8, double givenSpeed = 0, double givenMaxSessionCount = 0)
+		{
+			this->strategyID = givenStrategyID;
+			this->speed = givenSpeed;
+			this->maxSessionCount = givenMaxSessionCount;
+		}
+	};
+
+	// statistics of a replay at one capacity
+	struct ReplayCapacityStatisticsType
+	{
+		StatisticsAccumulatorType costTotal;
+		StatisticsAccumulatorType costServer;
+		StatisticsAccumulatorType costBandwidth;
+		StatisticsAccumulatorType capacityWastage;
+		StatisticsAccumulatorType averageDelay;
+		QuantileSketchType clientDelay; // every client's delay
+		QuantileSketchType computation; // wall-clock milliseconds per session
+	};
+
+	// statistics of a whole replay
+	struct ReplayStatisticsType
+	{
+		vector<ReplayCapacityStatisticsType> capacities; // in the order of SERVER_CAPACITY_LIST
+		double replayedSessionCount;
+		double unknownClientSessionCount; // skipped: a client is not in the topology
+		double infeasibleSessionCount; // skipped: the bounds leave a client without eligible dcs (at the recorded G datacenter, or at every one)
+		double clientCount; // of the replayed sessions
+		double duplicateClientCount; // clients appearing more than once in their session (replayed as separate players)
+		double traceSpan; // seconds between the first and the last replayed session
+		double wallTime; // milliseconds of the whole replay
+		double busyTime; // milliseconds spent running the strategy
+		StatisticsAccumulatorType lateness; // milliseconds each session started after its scheduled time (scaled rate only)
+
+		ReplayStatisticsType()
+		{
+			this->replayedSessionCount = 0;
+			this->unknownClientSessionCount = 0;
+			this->infeasibleSessionCount = 0;
+			this->clientCount = 0;
+			this->duplicateClientCount = 0;
+			this->traceSpan = 0;
+			this->wallTime = 0;
+			this->busyTime = 0;
+		}
+	};
+
+	// replay a trace on the topology of the given data directory: its identifiers are mapped to the clients (rows) of dc_to_pl_rtt.csv by name, and each session runs the strategy at each capacity of SERVER_CAPACITY_LIST,
+	// at its recorded G datacenter (basic problem) or over its eligible G datacenters (general problem); sessions are replayed in trace order on the calling thread, each with its own randomness (see SessionRandomnessType)
+	// the throughput, cost and delay are printed and written to Output\replay<strategyID>.csv (with the phase timings and memory profile next to it); return false if the trace or the data cannot be read or an assignment is invalid
+	bool ReplayTrace(const string &, const string &, const ReplaySettingType &, ReplayStatisticsType &);
+}
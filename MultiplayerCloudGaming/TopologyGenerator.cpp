@@ -0,0 +1,241 @@
+#include "TopologyGenerator.h"
+
+namespace TopologyGenerator
+{
+	const double PI = 3.14159265358979323846;
+	const double EARTH_RADIUS = 6371.0; // km
+	const double KM_PER_DEGREE = EARTH_RADIUS * PI / 180;
+
+	// sub-streams of the topology streams, so that client i and dc i do not share numbers
+	const unsigned long long CLIENT_STREAM = 0;
+	const unsigned long long DATACENTER_STREAM = 1;
+
+	vector<RegionType> GetDefaultRegions()
+	{
+		return {
+			RegionType("us-east", 39.0, -77.5, 0.20, 0.16),
+			RegionType("us-central", 41.9, -93.1, 0.08, 0.08),
+			RegionType("us-west", 37.4, -122.0, 0.14, 0.16),
+			RegionType("europe-west", 50.1, 8.7, 0.20, 0.20),
+			RegionType("asia-east", 35.7, 139.7, 0.14, 0.14),
+			RegionType("asia-southeast", 1.35, 103.8, 0.08, 0.10),
+			RegionType("south-america", -23.5, -46.6, 0.08, 0.06),
+			RegionType("india", 19.1, 72.9, 0.05, 0.05),
+			RegionType("oceania", -33.9, 151.2, 0.03, 0.05) };
+	}
+
+	double GetGreatCircleDistance(const LocationType &a, const LocationType &b)
+	{
+		double latitudeA = a.latitude * PI / 180, latitudeB = b.latitude * PI / 180;
+		double sinHalfLatitude = sin((latitudeB - latitudeA) / 2), sinHalfLongitude = sin((b.longitude - a.longitude) * PI / 180 / 2);
+		double h = sinHalfLatitude * sinHalfLatitude + cos(latitudeA) * cos(latitudeB) * sinHalfLongitude * sinHalfLongitude;
+		return 2 * EARTH_RADIUS * asin(std::min(1.0, sqrt(h)));
+	}
+
+	// standard normal from the numbers 2 * index and 2 * index + 1 of the stream (Box-Muller)
+	double GetStandardNormal(const CounterRandomType &random, unsigned long long index)
+	{
+		double u1 = (random.At(2 * index) >> 11) * (1.0 / 9007199254740992.0);
+		double u2 = (random.At(2 * index + 1) >> 11) * (1.0 / 9007199254740992.0);
+		return sqrt(-2 * log(1 - u1)) * cos(2 * PI * u2);
+	}
+
+	// a point of a region (by weight) scattered with the given spread, or a uniform point on the globe with probability backgroundRatio
+	LocationType GetLocation(const TopologySettingType &setting, CounterRandomType random, bool isClient)
+	{
+		LocationType location;
+		if (isClient && random.UniformReal() < setting.backgroundClientRatio)
+		{
+			location.latitude = asin(2 * random.UniformReal() - 1) * 180 / PI;
+			location.longitude = 360 * random.UniformReal() - 180;
+			return location;
+		}
+
+		double totalWeight = 0;
+		for (auto &region : setting.regions)
+		{
+			totalWeight += isClient ? region.clientWeight : region.datacenterWeight;
+		}
+		double pick = random.UniformReal() * totalWeight;
+		const RegionType *chosenRegion = &setting.regions.back();
+		for (auto &region : setting.regions)
+		{
+			pick -= isClient ? region.clientWeight : region.datacenterWeight;
+			if (pick < 0)
+			{
+				chosenRegion = &region;
+				break;
+			}
+		}
+
+		double spread = isClient ? setting.clientSpread : setting.datacenterSpread;
+		double north = GetStandardNormal(random, random.counter) * spread, east = GetStandardNormal(random, random.counter + 1) * spread;
+		location.latitude = std::max(-89.9, std::min(89.9, chosenRegion->latitude + north / KM_PER_DEGREE));
+		location.longitude = chosenRegion->longitude + east / (KM_PER_DEGREE * cos(location.latitude * PI / 180));
+		location.longitude = fmod(fmod(location.longitude + 180, 360) + 360, 360) - 180;
+		return location;
+	}
+
+	LocationType GetClientLocation(const TopologySettingType &setting, int clientIndex)
+	{
+		return GetLocation(setting, CounterRandomType(setting.seed, clientIndex, RANDOM_PURPOSE_TOPOLOGY_LOCATION, CLIENT_STREAM), true);
+	}
+
+	LocationType GetDatacenterLocation(const TopologySettingType &setting, int datacenterIndex)
+	{
+		return GetLocation(setting, CounterRandomType(setting.seed, datacenterIndex, RANDOM_PURPOSE_TOPOLOGY_LOCATION, DATACENTER_STREAM), false);
+	}
+
+	// RTT over the given distance, with the noiseIndex-th normal number of the given stream as noise
+	double GetRTT(const TopologySettingType &setting, double distance, double baseRTT, double noiseSigma, const CounterRandomType &noiseRandom, unsigned long long noiseIndex)
+	{
+		return (baseRTT + setting.inflation * 2 * distance / setting.propagationSpeed) * exp(noiseSigma * GetStandardNormal(noiseRandom, noiseIndex));
+	}
+
+	vector<vector<double>> GetDatacenterRTTMatrix(const TopologySettingType &setting, const vector<LocationType> &datacenterLocations)
+	{
+		const int datacenterCount = (int)datacenterLocations.size();
+
+		vector<vector<double>> RTT(datacenterCount, vector<double>(datacenterCount, 0.001));
+		for (int i = 0; i < datacenterCount; i++)
+		{
+			CounterRandomType noiseRandom(setting.seed, i, RANDOM_PURPOSE_TOPOLOGY_RTT_NOISE, DATACENTER_STREAM);
+			for (int j = i + 1; j < datacenterCount; j++)
+			{
+				RTT.at(i).at(j) = RTT.at(j).at(i) = GetRTT(setting, GetGreatCircleDistance(datacenterLocations.at(i), datacenterLocations.at(j)), setting.peeringRTT, setting.datacenterNoiseSigma, noiseRandom, j);
+			}
+		}
+
+		// violations are made from the RTTs above, so each chosen pair is slower than its detour through a random third dc (unless the detour's own pairs are made slower later)
+		if (setting.triangleInequalityViolationRatio > 0 && datacenterCount >= 3)
+		{
+			auto baseRTT = RTT;
+			for (int i = 0; i < datacenterCount; i++)
+			{
+				for (int j = i + 1; j < datacenterCount; j++)
+				{
+					CounterRandomType violationRandom(setting.seed, i, RANDOM_PURPOSE_TOPOLOGY_VIOLATION, j);
+					if (violationRandom.UniformReal() >= setting.triangleInequalityViolationRatio) continue;
+
+					int k = (int)violationRandom.UniformInt(datacenterCount - 2); // a third dc
+					if (k >= i) k++;
+					if (k >= j) k++;
+					double detourRTT = baseRTT.at(i).at(k) + baseRTT.at(k).at(j);
+					RTT.at(i).at(j) = RTT.at(j).at(i) = std::max(baseRTT.at(i).at(j), detourRTT * (1.1 + 0.4 * violationRandom.UniformReal()));
+				}
+			}
+		}
+
+		return RTT;
+	}
+
+	// share of the dc pairs (i, j) with a dc k such that RTT(i, k) + RTT(k, j) < RTT(i, j)
+	double GetTriangleInequalityViolationRatio(const vector<vector<double>> &RTT)
+	{
+		const size_t datacenterCount = RTT.size();
+		double pairCount = 0, violationCount = 0;
+		for (size_t i = 0; i < datacenterCount; i++)
+		{
+			for (size_t j = i + 1; j < datacenterCount; j++)
+			{
+				pairCount++;
+				for (size_t k = 0; k < datacenterCount; k++)
+				{
+					if (k != i && k != j && RTT.at(i).at(k) + RTT.at(k).at(j) < RTT.at(i).at(j))
+					{
+						violationCount++;
+						break;
+					}
+				}
+			}
+		}
+		return pairCount > 0 ? violationCount / pairCount : 0;
+	}
+
+	bool GenerateTopology(const TopologySettingType &setting, const string &outputDirectory)
+	{
+		auto pricing = ReadDelimitedTextFileIntoVector(setting.pricingFile, ',', false);
+		if (pricing.size() < 2)
+		{
+			printf("ERROR: no prices in %s\n", setting.pricingFile.c_str());
+			return false;
+		}
+		_mkdir(outputDirectory.c_str());
+
+		vector<LocationType> datacenterLocations;
+		vector<string> datacenterNames;
+		for (int j = 0; j < setting.datacenterCount; j++)
+		{
+			datacenterLocations.push_back(GetDatacenterLocation(setting, j));
+			datacenterNames.push_back("dc-" + std::to_string(j));
+		}
+
+		/* bandwidth and server prices: one row of the pricing file per dc */
+		ofstream pricingFile(outputDirectory + "dc_pricing_bandwidth_server.csv");
+		for (size_t col = 0; col < pricing.front().size(); col++)
+		{
+			pricingFile << (col > 0 ? "," : "") << pricing.front().at(col);
+		}
+		pricingFile << "\n";
+		for (int j = 0; j < setting.datacenterCount; j++)
+		{
+			CounterRandomType priceRandom(setting.seed, j, RANDOM_PURPOSE_TOPOLOGY_PRICE, DATACENTER_STREAM);
+			auto &row = pricing.at(1 + priceRandom.UniformInt((unsigned)pricing.size() - 1));
+			pricingFile << datacenterNames.at(j);
+			for (size_t col = 1; col < row.size(); col++)
+			{
+				pricingFile << "," << row.at(col);
+			}
+			pricingFile << "\n";
+		}
+
+		/* dc-to-dc RTTs */
+		auto datacenterRTT = GetDatacenterRTTMatrix(setting, datacenterLocations);
+		ofstream datacenterFile(outputDirectory + "dc_to_dc_rtt.csv");
+		for (auto &name : datacenterNames)
+		{
+			datacenterFile << "," << name;
+		}
+		datacenterFile << "\n";
+		for (int i = 0; i < setting.datacenterCount; i++)
+		{
+			datacenterFile << datacenterNames.at(i);
+			for (int j = 0; j < setting.datacenterCount; j++)
+			{
+				datacenterFile << "," << datacenterRTT.at(i).at(j);
+			}
+			datacenterFile << "\n";
+		}
+
+		/* client-to-dc RTTs, one client at a time */
+		ofstream clientFile(outputDirectory + "dc_to_pl_rtt.csv");
+		for (auto &name : datacenterNames)
+		{
+			clientFile << "," << name;
+		}
+		clientFile << "\n";
+		for (int i = 0; i < setting.clientCount; i++)
+		{
+			auto clientLocation = GetClientLocation(setting, i);
+			CounterRandomType noiseRandom(setting.seed, i, RANDOM_PURPOSE_TOPOLOGY_RTT_NOISE, CLIENT_STREAM);
+			clientFile << "client-" << i;
+			for (int j = 0; j < setting.datacenterCount; j++)
+			{
+				clientFile << "," << GetRTT(setting, GetGreatCircleDistance(clientLocation, datacenterLocations.at(j)), setting.lastMileRTT, setting.noiseSigma, noiseRandom, j);
+			}
+			clientFile << "\n";
+		}
+
+		pricingFile.close();
+		datacenterFile.close();
+		clientFile.close();
+		if (!pricingFile || !datacenterFile || !clientFile)
+		{
+			printf("ERROR: cannot write the files into %s\n", outputDirectory.c_str());
+			return false;
+		}
+
+		printf("%d clients and %d datacenters written to %s (%.1f%% of the dc pairs violate the triangle inequality)\n", setting.clientCount, setting.datacenterCount, outputDirectory.c_str(), 100 * GetTriangleInequalityViolationRatio(datacenterRTT));
+		return true;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Base.h"
+#include "Random.h"
+
+// synthetic datasets for scale testing: clients and datacenters placed on the globe, with RTTs derived from their great-circle distances and prices sampled from a real pricing file
+// the output is the three files read by ServerAllocationProblem::Initialize and MatchmakingProblemBase::Initialize (dc_to_pl_rtt.csv, dc_to_dc_rtt.csv and dc_pricing_bandwidth_server.csv)
+// everything is drawn from counter-based streams keyed by the seed and the client's or dc's index, so the same settings always give the same files, and each client's row does not depend on the number of clients
+namespace TopologyGenerator
+{
+	// a populated area: points are scattered around its center with a Gaussian spread
+	struct RegionType
+	{
+		string name;
+		double latitude; // degrees
+		double longitude; // degrees
+		double clientWeight; // relative share of the clients
+		double datacenterWeight; // relative share of the datacenters
+
+		RegionType(string givenName, double givenLatitude, double givenLongitude, double givenClientWeight, double givenDatacenterWeight)
+		{
+			this->name = givenName;
+			this->latitude = givenLatitude;
+			this->longitude = givenLongitude;
+			this->clientWeight = givenClientWeight;
+			this->datacenterWeight = givenDatacenterWeight;
+		}
+	};
+
+	// the regions of the bundled datasets (North America, Europe, East and Southeast Asia and South America), plus India and Oceania
+	vector<RegionType> GetDefaultRegions();
+
+	struct TopologySettingType
+	{
+		int clientCount;
+		int datacenterCount;
+		unsigned long long seed;
+		vector<RegionType> regions;
+		double clientSpread; // standard deviation (km) of a client's distance from its region's center
+		double datacenterSpread; // same for datacenters
+		double backgroundClientRatio; // share of the clients placed uniformly on the globe instead of in a region
+
+		// RTT = (lastMileRTT + inflation * 2 * distance / propagationSpeed) * noise, where noise is log-normal with median 1 and log standard deviation noiseSigma (a dc pair has peeringRTT and datacenterNoiseSigma instead)
+		double propagationSpeed; // km per ms (about 2/3 of the speed of light in fiber)
+		double inflation; // path length over great-circle distance
+		double lastMileRTT; // ms
+		double peeringRTT; // ms
+		double noiseSigma;
+		double datacenterNoiseSigma; // smaller than noiseSigma, as the noise of each pair is independent and with many dcs a noisy direct path would almost always have a shorter detour
+
+		// share of the dc pairs whose RTT is made longer than a detour through a third dc (by 10% to 50%), as often seen in measured Internet latencies
+		// (the noise alone already gives some pairs a slightly shorter detour, more so with many dcs, GenerateTopology prints the resulting share)
+		double triangleInequalityViolationRatio;
+
+		string pricingFile; // prices are sampled from its rows (each dc takes one whole row, so bandwidth and server prices stay consistent)
+
+		TopologySettingType()
+		{
+			this->clientCount = 10000;
+			this->datacenterCount = 100;
+			this->seed = 1;
+			this->regions = GetDefaultRegions();
+			this->clientSpread = 800;
+			this->datacenterSpread = 400;
+			this->backgroundClientRatio = 0.05;
+			this->propagationSpeed = 200;
+			this->inflation = 1.5;
+			this->lastMileRTT = 10;
+			this->peeringRTT = 5;
+			this->noiseSigma = 0.1;
+			this->datacenterNoiseSigma = 0.02;
+			this->triangleInequalityViolationRatio = 0;
+			this->pricingFile = ".\\Data\\dc_pricing_bandwidth_server.csv";
+		}
+	};
+
+	// a point on the globe
+	struct LocationType
+	{
+		double latitude;
+		double longitude;
+	};
+
+	// great-circle distance (km) between two points (haversine formula, mean earth radius)
+	double GetGreatCircleDistance(const LocationType &, const LocationType &);
+
+	// location of the client or dc with the given index
+	LocationType GetClientLocation(const TopologySettingType &, int);
+	LocationType GetDatacenterLocation(const TopologySettingType &, int);
+
+	// RTT matrix between all dcs (symmetric, 0.001 ms to itself as in the bundled datasets), with the triangle inequality violations
+	vector<vector<double>> GetDatacenterRTTMatrix(const TopologySettingType &, const vector<LocationType> &);
+
+	// write the three files into the given directory (created if missing), streaming the client rows so that millions of clients fit in memory
+	// return false if the pricing file cannot be read or an output file cannot be written
+	bool GenerateTopology(const TopologySettingType &, const string &);
+}
@@ -241,4 +241,38 @@ for j = 1:2
         savefig(strcat(file_name, '_LAC'));
         print(strcat(file_name, '_LAC'), '-dmeta');
     end
+end
+
+%% client delay cdf (points written by the simulation: each row holds the delays at the quantiles 0, 0.01, ..., 1 of one capacity and strategy)
+L_G = [75 150];
+L_R = [50 100];
+size = [10 50];
+strategy_name = {'LCP', 'LCW', 'LAC'};
+strategy_column = [6 7 8];
+line_style = {'-', ':', '--'};
+capacity_index = 4; % k = 8
+for j = 1:2
+    for i = 1:2
+        figure;
+        file_name = sprintf('%d_%d_%d_clientDelayCDF.csv', L_G(i), L_R(i), size(j));
+        data = csvread(file_name);
+        mean_data = csvread(sprintf('%d_%d_%d_costTotalMean.csv', L_G(i), L_R(i), size(j)));
+        capacity_count = numel(mean_data(:, 1)); % one row per capacity
+        column_count = numel(data(:, 1)) / capacity_count; % with the OPT and LS columns if they were enabled
+        for s = 1:3
+            plot(data((capacity_index - 1) * column_count + strategy_column(s), 1:101), 0:0.01:1, 'LineStyle', line_style{s}, 'LineWidth', 3, 'Color', 'k');
+            hold on;
+        end
+        pbaspect([1.5 1 1]);
+        set(gca, 'fontsize', 18);
+        set(gca, 'YTick', [0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1]);
+        lh = legend(strategy_name, 'Orientation', 'vertical', 'Location', 'southeast');
+        set(lh, 'FontSize', 18);
+        xlabel('Delay from client to G-server (ms)', 'FontSize', 20);
+        ylabel('CDF', 'FontSize', 20);
+        title(sprintf('(L_G = %d, L_R = %d); \t (|C| = %d); \t (k = 8)', L_G(i)*2, L_R(i)*2, size(j)));
+        grid on;
+        savefig(strcat('cdf_clientDelay_', file_name(1:end-4)));
+        print(strcat('cdf_clientDelay_', file_name(1:end-4)), '-dmeta');
+    end
 end
\ No newline at end of file